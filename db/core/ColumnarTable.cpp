@@ -0,0 +1,470 @@
+#include "ColumnarTable.hpp"
+
+#include <EssaUtil/Config.hpp>
+#include <cassert>
+#include <fmt/format.h>
+
+namespace Db::Core {
+
+Value ColumnChunk::value(size_t row) const {
+    assert(row < m_size);
+    if (is_null(row)) {
+        return Value::null();
+    }
+    switch (m_type) {
+    case Value::Type::Null:
+        return Value::null();
+    case Value::Type::Int:
+        return Value::create_int(m_ints[row]);
+    case Value::Type::Float:
+        return Value::create_float(m_floats[row]);
+    case Value::Type::Varchar:
+        return Value::create_varchar(std::string { varchar_value(row) });
+    case Value::Type::Bool:
+        return Value::create_bool(m_bools[row]);
+    case Value::Type::Time:
+        return Value::create_time(m_times[row]);
+    }
+    ESSA_UNREACHABLE;
+}
+
+void ColumnChunk::set_valid(size_t row, bool valid) {
+    if (row / 64 >= m_validity.size()) {
+        m_validity.resize(row / 64 + 1);
+    }
+    auto bit = uint64_t { 1 } << (row % 64);
+    if (valid) {
+        m_validity[row / 64] |= bit;
+    }
+    else {
+        m_validity[row / 64] &= ~bit;
+    }
+}
+
+void ColumnChunk::append_null() {
+    switch (m_type) {
+    case Value::Type::Null:
+        break;
+    case Value::Type::Int:
+        m_ints.push_back(0);
+        break;
+    case Value::Type::Float:
+        m_floats.push_back(0);
+        break;
+    case Value::Type::Varchar:
+        m_varchars.push_back({ .offset = 0, .size = 0 });
+        break;
+    case Value::Type::Bool:
+        m_bools.push_back(0);
+        break;
+    case Value::Type::Time:
+        m_times.push_back({});
+        break;
+    }
+    set_valid(m_size++, false);
+}
+
+DbErrorOr<void> ColumnChunk::append(Value const& value) {
+    if (value.is_null()) {
+        append_null();
+        return {};
+    }
+
+    // Integrity checks make sure that inserted values have the right type,
+    // but UPDATE doesn't check them, so values that can't be converted
+    // are reported here.
+    switch (m_type) {
+    case Value::Type::Null:
+        append_null();
+        return {};
+    case Value::Type::Int:
+        m_ints.push_back(TRY(value.to_int()));
+        break;
+    case Value::Type::Float:
+        m_floats.push_back(TRY(value.to_float()));
+        break;
+    case Value::Type::Varchar:
+        append_varchar(TRY(value.to_string()));
+        break;
+    case Value::Type::Bool:
+        m_bools.push_back(TRY(value.to_bool()));
+        break;
+    case Value::Type::Time:
+        m_times.push_back(TRY(value.to_time()));
+        break;
+    }
+    set_valid(m_size++, true);
+    return {};
+}
+
+void ColumnChunk::remove_last() {
+    assert(m_size > 0);
+    auto row = --m_size;
+    switch (m_type) {
+    case Value::Type::Null:
+        break;
+    case Value::Type::Int:
+        m_ints.pop_back();
+        break;
+    case Value::Type::Float:
+        m_floats.pop_back();
+        break;
+    case Value::Type::Varchar:
+        // The last appended varchar is at the end of the buffer.
+        if (!is_null(row)) {
+            m_varchar_data.resize(m_varchars.back().offset);
+        }
+        m_varchars.pop_back();
+        break;
+    case Value::Type::Bool:
+        m_bools.pop_back();
+        break;
+    case Value::Type::Time:
+        m_times.pop_back();
+        break;
+    }
+    set_valid(row, false);
+}
+
+void ColumnChunk::append_varchar(std::string_view string) {
+    m_varchars.push_back({ .offset = static_cast<uint32_t>(m_varchar_data.size()), .size = static_cast<uint32_t>(string.size()) });
+    m_varchar_data += string;
+}
+
+void ColumnChunk::set_from(size_t row, ColumnChunk const& other, size_t other_row) {
+    assert(row < m_size);
+    assert(other.m_type == m_type);
+    auto is_valid = !other.is_null(other_row);
+    set_valid(row, is_valid);
+    switch (m_type) {
+    case Value::Type::Null:
+        break;
+    case Value::Type::Int:
+        m_ints[row] = other.m_ints[other_row];
+        break;
+    case Value::Type::Float:
+        m_floats[row] = other.m_floats[other_row];
+        break;
+    case Value::Type::Varchar:
+        m_unused_varchar_bytes += m_varchars[row].size;
+        if (is_valid) {
+            auto string = other.varchar_value(other_row);
+            m_varchars[row] = { .offset = static_cast<uint32_t>(m_varchar_data.size()), .size = static_cast<uint32_t>(string.size()) };
+            m_varchar_data += string;
+        }
+        else {
+            m_varchars[row] = { .offset = 0, .size = 0 };
+        }
+        break;
+    case Value::Type::Bool:
+        m_bools[row] = other.m_bools[other_row];
+        break;
+    case Value::Type::Time:
+        m_times[row] = other.m_times[other_row];
+        break;
+    }
+
+    if (m_unused_varchar_bytes > m_varchar_data.size() / 2) {
+        ColumnChunk packed { m_type };
+        for (size_t s = 0; s < m_size; s++) {
+            packed.append_from(*this, s);
+        }
+        *this = std::move(packed);
+    }
+}
+
+void ColumnChunk::append_from(ColumnChunk const& other, size_t row) {
+    assert(other.m_type == m_type);
+    if (other.is_null(row)) {
+        append_null();
+        return;
+    }
+    switch (m_type) {
+    case Value::Type::Null:
+        break;
+    case Value::Type::Int:
+        m_ints.push_back(other.m_ints[row]);
+        break;
+    case Value::Type::Float:
+        m_floats.push_back(other.m_floats[row]);
+        break;
+    case Value::Type::Varchar:
+        append_varchar(other.varchar_value(row));
+        break;
+    case Value::Type::Bool:
+        m_bools.push_back(other.m_bools[row]);
+        break;
+    case Value::Type::Time:
+        m_times.push_back(other.m_times[row]);
+        break;
+    }
+    set_valid(m_size++, true);
+}
+
+size_t ColumnChunk::memory_usage() const {
+    return m_validity.capacity() * sizeof(uint64_t)
+        + m_ints.capacity() * sizeof(int)
+        + m_floats.capacity() * sizeof(float)
+        + m_bools.capacity() * sizeof(uint8_t)
+        + m_times.capacity() * sizeof(Date)
+        + m_varchars.capacity() * sizeof(VarcharSpan)
+        + m_varchar_data.capacity();
+}
+
+class ColumnarRelationIteratorImpl : public RelationIteratorImpl {
+public:
+    explicit ColumnarRelationIteratorImpl(ColumnarTable& table)
+        : m_table(table) {
+        m_table.iterator_created();
+    }
+
+    ~ColumnarRelationIteratorImpl() {
+        m_table.iterator_destroyed();
+    }
+
+    class RowReferenceImpl : public RowReference {
+    public:
+        RowReferenceImpl(ColumnarTable& table, size_t group, size_t row)
+            : m_table(table)
+            , m_group(group)
+            , m_row(row) { }
+
+        virtual Tuple read() const override {
+            return m_table.read_row(m_group, m_row);
+        }
+        virtual DbErrorOr<void> write(Tuple const& tuple) override {
+            return m_table.write_row(m_group, m_row, tuple);
+        }
+        virtual void remove() override {
+            m_table.remove_row(m_group, m_row);
+        }
+        virtual std::unique_ptr<RowReference> clone() const override {
+            return std::make_unique<RowReferenceImpl>(*this);
+        }
+
+    private:
+        ColumnarTable& m_table;
+        size_t m_group;
+        size_t m_row;
+    };
+
+    virtual std::unique_ptr<RowReference> next() override {
+        auto position = next_position();
+        if (!position) {
+            return {};
+        }
+        return std::make_unique<RowReferenceImpl>(m_table, position->group, position->row);
+    }
+
+    virtual RowBatch const& next_batch(size_t max_rows) override {
+        m_batch.reset(max_rows);
+        m_batch_positions.clear();
+        while (m_batch.size() < max_rows) {
+            auto position = next_position();
+            if (!position) {
+                break;
+            }
+            m_batch.add_owned_row(m_table.read_row(position->group, position->row));
+            m_batch_positions.push_back(*position);
+        }
+        return m_batch;
+    }
+
+    virtual DbErrorOr<void> write_batch_row(size_t index, Tuple const& tuple) override {
+        auto position = m_batch_positions[index];
+        return m_table.write_row(position.group, position.row, tuple);
+    }
+
+    virtual DbErrorOr<void> remove_batch_row(size_t index) override {
+        auto position = m_batch_positions[index];
+        m_table.remove_row(position.group, position.row);
+        return {};
+    }
+
+private:
+    struct Position {
+        size_t group;
+        size_t row;
+    };
+
+    std::optional<Position> next_position() {
+        // INSERT ... SELECT from the same table fills the last row group and
+        // adds new ones while it's read, so neither count is cached.
+        while (m_group < m_table.m_row_groups.size()) {
+            auto const& group = m_table.m_row_groups[m_group];
+            if (m_row >= group.row_count) {
+                m_group++;
+                m_row = 0;
+                continue;
+            }
+            auto row = m_row++;
+            if (!group.is_removed(row)) {
+                return Position { .group = m_group, .row = row };
+            }
+        }
+        return {};
+    }
+
+    ColumnarTable& m_table;
+    size_t m_group = 0;
+    size_t m_row = 0;
+    std::vector<Position> m_batch_positions;
+};
+
+RelationIterator ColumnarTable::rows() const {
+    // Read-only iterators need a mutable table too: the last one to be
+    // destroyed may compact it.
+    return RelationIterator { std::make_unique<ColumnarRelationIteratorImpl>(const_cast<ColumnarTable&>(*this)) };
+}
+
+MutableRelationIterator ColumnarTable::writable_rows() {
+    return MutableRelationIterator { std::make_unique<ColumnarRelationIteratorImpl>(*this) };
+}
+
+DbErrorOr<void> ColumnarTable::rename(std::string const& new_name) {
+    m_name = new_name;
+    return {};
+}
+
+ColumnarTable::RowGroup& ColumnarTable::append_row_group() {
+    RowGroup group;
+    group.columns.reserve(m_columns.size());
+    for (auto const& column : m_columns) {
+        group.columns.emplace_back(column.type());
+    }
+    group.removed.resize((RowGroupSize + 63) / 64);
+    return m_row_groups.emplace_back(std::move(group));
+}
+
+DbErrorOr<void> ColumnarTable::insert_unchecked(Tuple const& tuple) {
+    assert(tuple.value_count() == m_columns.size());
+    if (m_row_groups.empty() || m_row_groups.back().row_count == RowGroupSize) {
+        append_row_group();
+    }
+    auto& group = m_row_groups.back();
+    for (size_t s = 0; s < m_columns.size(); s++) {
+        auto result = group.columns[s].append(tuple.value(s));
+        if (result.is_error()) {
+            for (size_t appended = 0; appended < s; appended++) {
+                group.columns[appended].remove_last();
+            }
+            return result.release_error();
+        }
+    }
+    group.row_count++;
+    m_row_count++;
+    return {};
+}
+
+Tuple ColumnarTable::read_row(size_t group_index, size_t row) const {
+    auto const& group = m_row_groups[group_index];
+    std::vector<Value> values;
+    values.reserve(group.columns.size());
+    for (auto const& column : group.columns) {
+        values.push_back(column.value(row));
+    }
+    return Tuple { std::move(values) };
+}
+
+DbErrorOr<void> ColumnarTable::write_row(size_t group_index, size_t row, Tuple const& tuple) {
+    auto& group = m_row_groups[group_index];
+    assert(!group.is_removed(row));
+
+    // All values are converted first, so that a value that can't be
+    // converted doesn't leave the row half-written.
+    std::vector<ColumnChunk> values;
+    values.reserve(group.columns.size());
+    for (size_t s = 0; s < group.columns.size(); s++) {
+        TRY(values.emplace_back(m_columns[s].type()).append(tuple.value(s)));
+    }
+    for (size_t s = 0; s < group.columns.size(); s++) {
+        group.columns[s].set_from(row, values[s], 0);
+    }
+    return {};
+}
+
+void ColumnarTable::remove_row(size_t group_index, size_t row) {
+    auto& group = m_row_groups[group_index];
+    assert(!group.is_removed(row));
+    group.removed[row / 64] |= uint64_t { 1 } << (row % 64);
+    m_removed_row_count++;
+}
+
+void ColumnarTable::iterator_destroyed() {
+    assert(m_iterator_count > 0);
+    // Compacting copies every row group, so it's done only once a big
+    // part of the rows is removed, like in RowStore.
+    if (--m_iterator_count == 0 && m_removed_row_count > 0 && m_removed_row_count * 4 >= m_row_count) {
+        compact();
+    }
+}
+
+void ColumnarTable::compact() {
+    auto old_groups = std::move(m_row_groups);
+    m_row_groups.clear();
+    m_row_count = 0;
+    m_removed_row_count = 0;
+    for (auto const& old_group : old_groups) {
+        for (size_t row = 0; row < old_group.row_count; row++) {
+            if (old_group.is_removed(row)) {
+                continue;
+            }
+            if (m_row_groups.empty() || m_row_groups.back().row_count == RowGroupSize) {
+                append_row_group();
+            }
+            auto& group = m_row_groups.back();
+            for (size_t s = 0; s < m_columns.size(); s++) {
+                group.columns[s].append_from(old_group.columns[s], row);
+            }
+            group.row_count++;
+            m_row_count++;
+        }
+    }
+}
+
+DbErrorOr<bool> ColumnarTable::contains_value(size_t column, Value const& value) const {
+    // Other cases follow conversion rules of Value::operator==.
+    if (value.is_null() || value.type() != m_columns[column].type() || value.type() == Value::Type::Time) {
+        return Table::contains_value(column, value);
+    }
+
+    auto find = [&](auto const& get, auto const& needle) {
+        for (auto const& group : m_row_groups) {
+            auto const& chunk = group.columns[column];
+            for (size_t row = 0; row < group.row_count; row++) {
+                if (!group.is_removed(row) && !chunk.is_null(row) && (chunk.*get)(row) == needle) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    switch (value.type()) {
+    case Value::Type::Int:
+        return find(&ColumnChunk::int_value, TRY(value.to_int()));
+    case Value::Type::Float:
+        return find(&ColumnChunk::float_value, TRY(value.to_float()));
+    case Value::Type::Varchar:
+        return find(&ColumnChunk::varchar_value, TRY(value.to_string()));
+    case Value::Type::Bool:
+        return find(&ColumnChunk::bool_value, TRY(value.to_bool()));
+    case Value::Type::Null:
+    case Value::Type::Time:
+        break;
+    }
+    ESSA_UNREACHABLE;
+}
+
+void ColumnarTable::dump_storage_debug() {
+    size_t memory_usage = 0;
+    for (auto const& group : m_row_groups) {
+        for (auto const& column : group.columns) {
+            memory_usage += column.memory_usage();
+        }
+    }
+    fmt::print("Columnar table '{}': {} rows ({} removed) in {} row groups, {} bytes\n",
+        m_name, m_row_count, m_removed_row_count, m_row_groups.size(), memory_usage);
+}
+
+}
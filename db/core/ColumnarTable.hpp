@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <db/core/Table.hpp>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Db::Core {
+
+// Values of a single column in a single row group, stored in a typed
+// array instead of as separate `Value`s. NULLs are marked in a validity
+// bitmap and take a (zeroed) slot in the array, so that row indexes are
+// the same for all columns.
+class ColumnChunk {
+public:
+    explicit ColumnChunk(Value::Type type)
+        : m_type(type) { }
+
+    size_t size() const { return m_size; }
+    bool is_null(size_t row) const { return !(m_validity[row / 64] & (uint64_t { 1 } << (row % 64))); }
+
+    Value value(size_t row) const;
+
+    // Values of other types are converted to the type of the column.
+    // Nothing is appended if that fails.
+    DbErrorOr<void> append(Value const&);
+
+    // Undo the last append().
+    void remove_last();
+
+    // Append or overwrite with the row-th value of `other`, which must be
+    // of the same type.
+    void append_from(ColumnChunk const& other, size_t row);
+    void set_from(size_t row, ColumnChunk const& other, size_t other_row);
+
+    // Typed access for scans. Must match the type of the column.
+    int int_value(size_t row) const { return m_ints[row]; }
+    float float_value(size_t row) const { return m_floats[row]; }
+    bool bool_value(size_t row) const { return m_bools[row]; }
+    std::string_view varchar_value(size_t row) const {
+        return std::string_view { m_varchar_data }.substr(m_varchars[row].offset, m_varchars[row].size);
+    }
+
+    size_t memory_usage() const;
+
+private:
+    void append_null();
+    void append_varchar(std::string_view);
+    void set_valid(size_t row, bool valid);
+
+    Value::Type m_type;
+    size_t m_size = 0;
+    std::vector<uint64_t> m_validity;
+
+    // Only the array for `m_type` is used.
+    std::vector<int> m_ints;
+    std::vector<float> m_floats;
+    std::vector<uint8_t> m_bools;
+    std::vector<Date> m_times;
+
+    // Varchars are packed into a single buffer. Overwritten ones are left
+    // there until they make up half of it.
+    struct VarcharSpan {
+        uint32_t offset;
+        uint32_t size;
+    };
+    std::vector<VarcharSpan> m_varchars;
+    std::string m_varchar_data;
+    size_t m_unused_varchar_bytes = 0;
+};
+
+// In-memory table that stores rows column by column, in row groups of
+// fixed size. Compared to MemoryBackedTable, it doesn't allocate anything
+// per row or per value, so it uses a fraction of memory and scans read
+// contiguous arrays.
+//
+// Removed rows are only marked as such until all iterators over the table
+// are destroyed, so that references to other rows stay valid. Then the
+// table is compacted.
+class ColumnarTable : public Table {
+public:
+    static constexpr size_t RowGroupSize = 1024;
+
+    explicit ColumnarTable(TableSetup const& setup)
+        : m_columns(setup.columns)
+        , m_name(setup.name) {
+        set_primary_key(setup.primary_key);
+    }
+
+    // ^Relation
+    virtual std::vector<Column> const& columns() const override { return m_columns; }
+    virtual RelationIterator rows() const override;
+    virtual MutableRelationIterator writable_rows() override;
+    virtual size_t size() const override { return m_row_count - m_removed_row_count; }
+
+    // ^Table
+    virtual DatabaseEngine engine() const override { return DatabaseEngine::Columnar; }
+    virtual std::string name() const override { return m_name; }
+    virtual int next_auto_increment_value(std::string const& column) override { return m_auto_increment_values[column] + 1; }
+    virtual int increment(std::string const& column) override { return ++m_auto_increment_values[column]; }
+    virtual DbErrorOr<void> rename(std::string const& new_name) override;
+    virtual DbErrorOr<void> insert_unchecked(Tuple const&) override;
+    virtual DbErrorOr<bool> contains_value(size_t column, Value const&) const override;
+    virtual void dump_storage_debug() override;
+
+private:
+    friend class ColumnarRelationIteratorImpl;
+
+    struct RowGroup {
+        std::vector<ColumnChunk> columns;
+        std::vector<uint64_t> removed;
+        size_t row_count = 0;
+
+        bool is_removed(size_t row) const { return removed[row / 64] & (uint64_t { 1 } << (row % 64)); }
+    };
+
+    RowGroup& append_row_group();
+    Tuple read_row(size_t group, size_t row) const;
+    DbErrorOr<void> write_row(size_t group, size_t row, Tuple const&);
+    void remove_row(size_t group, size_t row);
+
+    void iterator_created() const { m_iterator_count++; }
+    void iterator_destroyed();
+    void compact();
+
+    std::vector<Column> m_columns;
+    std::string m_name;
+    std::map<std::string, int> m_auto_increment_values;
+
+    std::vector<RowGroup> m_row_groups;
+    size_t m_row_count = 0;
+    size_t m_removed_row_count = 0;
+    mutable size_t m_iterator_count = 0;
+};
+
+}
@@ -2,17 +2,41 @@
 #include "db/core/TupleFromValues.hpp"
 
 #include <EssaUtil/Config.hpp>
+#include <algorithm>
+#include <db/core/ColumnarTable.hpp>
 #include <db/core/Table.hpp>
 #include <db/storage/CSVFile.hpp>
 #include <db/storage/FileBackedTable.hpp>
+#include <db/storage/edb/BufferPool.hpp>
+#include <db/storage/edb/WriteAheadLog.hpp>
 #include <filesystem>
 
 namespace Db::Core {
 
-Util::OsErrorOr<Database> Database::create_or_open_file_backed(std::string const& path) {
+Database::Database(Database&&) = default;
+Database& Database::operator=(Database&&) = default;
+
+Database::~Database() {
+    if (!m_wal) {
+        return;
+    }
+    // Not needed for correctness, but saves replaying the log on next open.
+    auto result = commit();
+    if (!result.is_error()) {
+        result = checkpoint();
+    }
+    if (result.is_error()) {
+        result.dump("Internal error: Failed to checkpoint database on close");
+    }
+}
+
+Util::OsErrorOr<Database> Database::create_or_open_file_backed(std::string const& path, Storage::EDB::PageAccess page_access) {
     Database db;
     db.m_path = path;
     db.set_default_engine(DatabaseEngine::EDB);
+    if (page_access.mode == Storage::EDB::PageAccess::Mode::BufferPool) {
+        db.m_buffer_pool = std::make_unique<Storage::EDB::BufferPool>(page_access.buffer_pool_size, page_access.direct_io);
+    }
 
     if (!std::filesystem::is_directory(path)) {
         std::error_code err;
@@ -22,16 +46,86 @@ Util::OsErrorOr<Database> Database::create_or_open_file_backed(std::string const
         }
     }
 
+    // Finish interrupted checkpoint before files are read.
+    db.m_wal = TRY(Storage::EDB::WriteAheadLog::open(path));
+
     // Open all existing tables as edb files
     for (auto const& entry : std::filesystem::directory_iterator { path }) {
         if (entry.path().extension() == ".edb") {
-            auto table = TRY(Storage::FileBackedTable::open(path, entry.path().stem()));
+            auto table = TRY(Storage::FileBackedTable::open(path, entry.path().stem(), db.m_wal.get(), db.m_buffer_pool.get()));
             db.m_tables.insert({ table->name(), std::move(table) });
         }
     }
+
+    // Redo what was committed after the last checkpoint, and checkpoint
+    // it so that the log can be dropped.
+    TRY(db.m_wal->replay([&](Storage::EDB::WriteAheadLog::Record const& record) -> Util::OsErrorOr<void> {
+        auto it = db.m_tables.find(record.table);
+        if (it == db.m_tables.end()) {
+            // The table was dropped after the record was written.
+            return {};
+        }
+        return static_cast<Storage::FileBackedTable&>(*it->second).replay(record);
+    }));
+    TRY(db.checkpoint());
     return db;
 }
 
+Util::OsErrorOr<void> Database::commit() {
+    if (!m_wal) {
+        return {};
+    }
+    TRY(m_wal->commit());
+    if (!m_asynchronous_commit) {
+        TRY(m_wal->wait_until_durable());
+    }
+    if (m_wal->should_checkpoint()) {
+        TRY(checkpoint(false));
+    }
+    return {};
+}
+
+Util::OsErrorOr<void> Database::checkpoint(bool wait) {
+    if (!m_wal) {
+        return {};
+    }
+    TRY(m_wal->commit());
+
+    // Blocks written by the previous checkpoint may be read back from
+    // files from now on (see PageStore::take_dirty_blocks()).
+    auto finish_checkpoint = [&]() -> Util::OsErrorOr<void> {
+        TRY(m_wal->wait_for_checkpoint());
+        for (auto const& [name, table] : m_tables) {
+            if (auto file_backed_table = dynamic_cast<Storage::FileBackedTable*>(table.get())) {
+                file_backed_table->finish_checkpoint();
+            }
+        }
+        return {};
+    };
+    TRY(finish_checkpoint());
+
+    std::vector<Storage::EDB::WriteAheadLog::FileImage> images;
+    for (auto const& [name, table] : m_tables) {
+        auto file_backed_table = dynamic_cast<Storage::FileBackedTable*>(table.get());
+        if (file_backed_table) {
+            images.push_back(file_backed_table->take_checkpoint_image());
+        }
+    }
+    TRY(m_wal->checkpoint(std::move(images), wait));
+    if (wait) {
+        TRY(finish_checkpoint());
+    }
+    return {};
+}
+
+DbErrorOr<void> Database::checkpoint_for_ddl() {
+    auto result = checkpoint();
+    if (result.is_error()) {
+        return DbError { fmt::format("Checkpoint failed: {}", result.release_error()) };
+    }
+    return {};
+}
+
 Database Database::create_memory_backed() {
     return Database {};
 }
@@ -46,6 +140,13 @@ Core::DbErrorOr<Table*> Database::create_table(TableSetup table_setup, std::shar
         auto& table = *m_tables.insert({ table_setup.name, std::make_unique<MemoryBackedTable>(std::move(check), table_setup) }).first->second;
         return &table;
     }
+    case DatabaseEngine::Columnar: {
+        if (check && (check->main_rule() || !check->constraints().empty())) {
+            return Core::DbError { "Checks are not supported by the COLUMNAR engine" };
+        }
+        auto& table = *m_tables.insert({ table_setup.name, std::make_unique<ColumnarTable>(table_setup) }).first->second;
+        return &table;
+    }
     case DatabaseEngine::EDB: {
         if (!m_path) {
             return Core::DbError { fmt::format("Cannot create file-backed tables in memory-backed database") };
@@ -53,11 +154,16 @@ Core::DbErrorOr<Table*> Database::create_table(TableSetup table_setup, std::shar
         if (!std::filesystem::is_directory(*m_path)) {
             std::filesystem::create_directory(*m_path);
         }
-        auto result = Storage::FileBackedTable::initialize(*m_path, table_setup);
+        auto result = Storage::FileBackedTable::initialize(*m_path, table_setup, m_wal.get(), m_buffer_pool.get());
         if (result.is_error()) {
             return Core::DbError { fmt::format("Creating table failed: {}", result.release_error()) };
         }
-        return &*m_tables.insert({ table_setup.name, result.release_value() }).first->second;
+        auto table = &*m_tables.insert({ table_setup.name, result.release_value() }).first->second;
+
+        // Creation is not logged, so it must be written before anything
+        // that refers to the table is.
+        TRY(checkpoint_for_ddl());
+        return table;
     } break;
     }
     ESSA_UNREACHABLE;
@@ -69,6 +175,8 @@ void Database::add_table(std::unique_ptr<Table> table) {
 
 DbErrorOr<void> Database::drop_table(std::string name) {
     TRY(table(name));
+    // FIXME: The file is not removed, so at least keep it consistent.
+    TRY(checkpoint_for_ddl());
     m_tables.erase(name);
     return {};
 }
@@ -83,6 +191,9 @@ DbErrorOr<void> Database::restructure_table(std::string const& old_name, TableSe
     //        exist, this may not be the case!
     auto backup_name = old_name + "__BACKUP" + std::to_string(time(nullptr));
 
+    // Files are renamed below, so all pending writes to them must finish.
+    TRY(checkpoint_for_ddl());
+
     auto it = m_tables.find(old_name);
     auto backup_table = m_tables.insert({ backup_name, std::move(it->second) }).first->second.get();
     m_tables.erase(it);
@@ -113,8 +224,20 @@ DbErrorOr<void> Database::restructure_table(std::string const& old_name, TableSe
         return {};
     }));
 
+    // Keep indexes whose columns still exist.
+    auto old_memory_backed_table = dynamic_cast<MemoryBackedTable*>(backup_table);
+    auto new_memory_backed_table = dynamic_cast<MemoryBackedTable*>(new_table);
+    if (old_memory_backed_table && new_memory_backed_table) {
+        for (auto const& index : old_memory_backed_table->index_setups()) {
+            if (std::ranges::all_of(index.columns, [&](auto const& column) { return new_table->get_column(column).has_value(); })) {
+                TRY(new_memory_backed_table->create_index(index.name, index.columns));
+            }
+        }
+    }
+
     // 4. Drop "backup" table.
     // FIXME: Actually drop data that this table contains (for EDB)
+    TRY(checkpoint_for_ddl());
     m_tables.erase(backup_name);
 
     return {};
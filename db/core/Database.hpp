@@ -5,16 +5,41 @@
 #include <db/core/ImportMode.hpp>
 #include <db/core/Table.hpp>
 #include <db/core/TableSetup.hpp>
+#include <db/storage/edb/PageStore.hpp>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
+namespace Db::Storage::EDB {
+class BufferPool;
+class WriteAheadLog;
+}
+
 namespace Db::Core {
 
 class Database : public Util::NonCopyable {
 public:
-    static Util::OsErrorOr<Database> create_or_open_file_backed(std::string const& path);
+    Database(Database&&);
+    Database& operator=(Database&&);
+    ~Database();
+
+    static Util::OsErrorOr<Database> create_or_open_file_backed(std::string const& path, Storage::EDB::PageAccess = {});
     static Database create_memory_backed();
 
+    // Called after every statement. Changes of file-backed tables made so
+    // far are durable when this returns, unless commits are asynchronous.
+    Util::OsErrorOr<void> commit();
+
+    // Asynchronous commits return once changes are written to the log, and
+    // they become durable in background shortly after (see WriteAheadLog).
+    // This saves an fsync per statement, but a crash may lose the last
+    // committed statements.
+    void set_asynchronous_commit(bool value) { m_asynchronous_commit = value; }
+
+    // Write all changes of file-backed tables into their files. Unless
+    // `wait` is set, it finishes in background.
+    Util::OsErrorOr<void> checkpoint(bool wait = true);
+
     void set_default_engine(DatabaseEngine e) { m_default_engine = e; }
     DatabaseEngine default_engine() const { return m_default_engine; }
 
@@ -55,9 +80,17 @@ public:
 private:
     Database() = default;
 
+    // Table files are created, renamed and dropped directly, not through
+    // the log.
+    DbErrorOr<void> checkpoint_for_ddl();
+
     std::optional<std::string> m_path;
+    // Declared before tables, so that they outlive them.
+    std::unique_ptr<Storage::EDB::BufferPool> m_buffer_pool;
+    std::unique_ptr<Storage::EDB::WriteAheadLog> m_wal;
     std::unordered_map<std::string, std::unique_ptr<Table>> m_tables;
     DatabaseEngine m_default_engine = DatabaseEngine::Memory;
+    bool m_asynchronous_commit = false;
 };
 
 }
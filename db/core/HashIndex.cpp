@@ -0,0 +1,94 @@
+#include "HashIndex.hpp"
+
+#include <EssaUtil/Config.hpp>
+#include <cassert>
+#include <cmath>
+
+namespace Db::Core {
+
+size_t HashIndex::Hash::operator()(Value const& value) const {
+    switch (value.type()) {
+    case Value::Type::Int:
+        return std::hash<int> {}(value.int_value());
+    case Value::Type::Float:
+        // -0 is equal to 0.
+        return std::hash<float> {}(value.float_value() == 0 ? 0.f : value.float_value());
+    case Value::Type::Varchar:
+        return std::hash<std::string_view> {}(value.varchar_value());
+    case Value::Type::Bool:
+        return value.bool_value();
+    case Value::Type::Null:
+    case Value::Type::Time:
+        break;
+    }
+    ESSA_UNREACHABLE;
+}
+
+bool HashIndex::Equal::operator()(Value const& lhs, Value const& rhs) const {
+    switch (lhs.type()) {
+    case Value::Type::Int:
+        return lhs.int_value() == rhs.int_value();
+    case Value::Type::Float:
+        return lhs.float_value() == rhs.float_value();
+    case Value::Type::Varchar:
+        return lhs.varchar_value() == rhs.varchar_value();
+    case Value::Type::Bool:
+        return lhs.bool_value() == rhs.bool_value();
+    case Value::Type::Null:
+    case Value::Type::Time:
+        break;
+    }
+    ESSA_UNREACHABLE;
+}
+
+// NULL and NaN are never equal to anything, so they don't need to be in
+// the index.
+static bool is_never_equal(Value const& value) {
+    return value.is_null() || (value.type() == Value::Type::Float && std::isnan(value.float_value()));
+}
+
+void HashIndex::insert(Value const& value, RowId row) {
+    if (is_never_equal(value)) {
+        return;
+    }
+    if (value.type() != m_type) {
+        m_unindexed_count++;
+        return;
+    }
+    m_rows.emplace(value, row);
+}
+
+void HashIndex::remove(Value const& value, RowId row) {
+    if (is_never_equal(value)) {
+        return;
+    }
+    if (value.type() != m_type) {
+        assert(m_unindexed_count > 0);
+        m_unindexed_count--;
+        return;
+    }
+    auto [begin, end] = m_rows.equal_range(value);
+    for (auto it = begin; it != end; it++) {
+        if (it->second == row) {
+            m_rows.erase(it);
+            return;
+        }
+    }
+    assert(false);
+}
+
+void HashIndex::clear() {
+    m_rows.clear();
+    m_unindexed_count = 0;
+}
+
+std::optional<HashIndex::RowId> HashIndex::find(Value const& value) const {
+    assert(can_find(value));
+    auto it = m_rows.find(value);
+    if (it == m_rows.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Value.hpp"
+
+#include <optional>
+#include <unordered_map>
+
+namespace Db::Core {
+
+// In-memory hash index of one column, mapping values to ids of rows that
+// contain them.
+//
+// Lookups agree with Value::operator== only when both values have the
+// type of the column. Rows with values of other types (UPDATE doesn't
+// check types yet) are only counted, and the index can't be used while
+// there are any.
+class HashIndex {
+public:
+    using RowId = size_t;
+
+    HashIndex(size_t column, Value::Type type)
+        : m_column(column)
+        , m_type(type) { }
+
+    // Time is compared by converting to int, which may fail, so such
+    // columns are not indexed.
+    static bool is_supported(Value::Type type) { return type != Value::Type::Time && type != Value::Type::Null; }
+
+    size_t column() const { return m_column; }
+
+    void insert(Value const&, RowId);
+    void remove(Value const&, RowId);
+    void clear();
+
+    bool can_find(Value const& value) const { return m_unindexed_count == 0 && value.type() == m_type; }
+
+    // Any row that contains `value`. can_find() must be true.
+    std::optional<RowId> find(Value const&) const;
+
+private:
+    struct Hash {
+        size_t operator()(Value const&) const;
+    };
+    struct Equal {
+        bool operator()(Value const&, Value const&) const;
+    };
+
+    size_t m_column;
+    Value::Type m_type;
+    std::unordered_multimap<Value, RowId, Hash, Equal> m_rows;
+    size_t m_unindexed_count = 0;
+};
+
+}
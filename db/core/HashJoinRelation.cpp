@@ -0,0 +1,183 @@
+#include "HashJoinRelation.hpp"
+
+#include <cmath>
+
+namespace Db::Core {
+
+static bool can_match(Value const& key) {
+    return !key.is_null() && !(key.type() == Value::Type::Float && std::isnan(key.float_value()));
+}
+
+static Tuple concatenate(Tuple const& lhs, Tuple const& rhs) {
+    std::vector<Value> values;
+    values.reserve(lhs.value_count() + rhs.value_count());
+    values.insert(values.end(), lhs.begin(), lhs.end());
+    values.insert(values.end(), rhs.begin(), rhs.end());
+    return Tuple { std::move(values) };
+}
+
+static Tuple null_row(Relation const& relation) {
+    return Tuple { std::vector<Value>(relation.columns().size(), Value::null()) };
+}
+
+HashJoinRelation::HashJoinRelation(Side lhs, Side rhs)
+    : m_lhs(std::move(lhs))
+    , m_rhs(std::move(rhs)) {
+    for (auto const* side : { &m_lhs, &m_rhs }) {
+        for (auto const& column : side->relation->columns()) {
+            m_columns.push_back(Column(column.name(), column.type(), false, false, false));
+        }
+    }
+
+    // Only rows of the build side are kept in memory.
+    m_build_is_lhs = m_lhs.relation->size() < m_rhs.relation->size();
+    auto const& build = build_side();
+    build.relation->rows().for_each_batch([&](RowBatch const& batch) {
+        for (auto const& row : batch) {
+            auto const& key = row.value(build.key_column);
+            if (can_match(key)) {
+                m_build_index[key].push_back(m_build_rows.size());
+            }
+            m_build_rows.push_back(row);
+        }
+    });
+}
+
+class HashJoinRelation::IteratorImpl : public RelationIteratorImpl {
+public:
+    explicit IteratorImpl(HashJoinRelation const& join)
+        : m_join(join)
+        , m_probe_rows(join.probe_side().relation->rows())
+        , m_build_null_row(null_row(*join.build_side().relation))
+        , m_probe_null_row(null_row(*join.probe_side().relation))
+        , m_build_row_matched(join.m_build_rows.size(), false) { }
+
+    class RowReferenceImpl : public RowReference {
+    public:
+        explicit RowReferenceImpl(Tuple row)
+            : m_row(std::move(row)) { }
+
+        virtual Tuple read() const override { return m_row; }
+        virtual DbErrorOr<void> write(Tuple const&) override { ESSA_UNREACHABLE; }
+        virtual void remove() override { ESSA_UNREACHABLE; }
+        virtual std::unique_ptr<RowReference> clone() const override {
+            return std::make_unique<RowReferenceImpl>(*this);
+        }
+
+    private:
+        Tuple m_row;
+    };
+
+    virtual std::unique_ptr<RowReference> next() override {
+        auto row = next_row();
+        if (!row) {
+            return {};
+        }
+        return std::make_unique<RowReferenceImpl>(std::move(*row));
+    }
+
+    virtual Tuple const* next_tuple() override {
+        m_current_row = next_row();
+        return m_current_row ? &*m_current_row : nullptr;
+    }
+
+    virtual RowBatch const& next_batch(size_t max_rows) override {
+        m_batch.reset(max_rows);
+        while (m_batch.size() < max_rows) {
+            auto row = next_row();
+            if (!row) {
+                break;
+            }
+            m_batch.add_owned_row(std::move(*row));
+        }
+        return m_batch;
+    }
+
+private:
+    // Columns of the lhs relation always come first.
+    Tuple joined_row(Tuple const& probe_row, Tuple const& build_row) const {
+        return m_join.m_build_is_lhs ? concatenate(build_row, probe_row) : concatenate(probe_row, build_row);
+    }
+
+    Tuple const* next_probe_row() {
+        if (!m_probe_batch || m_probe_index == m_probe_batch->size()) {
+            m_probe_batch = &m_probe_rows.next_batch();
+            m_probe_index = 0;
+            if (m_probe_batch->empty()) {
+                return nullptr;
+            }
+        }
+        return &(*m_probe_batch)[m_probe_index++];
+    }
+
+    std::optional<Tuple> next_row() {
+        while (!m_probe_done) {
+            if (m_matches && m_match_index < m_matches->size()) {
+                auto build_row = (*m_matches)[m_match_index++];
+                m_build_row_matched[build_row] = true;
+                return joined_row(*m_probe_row, m_join.m_build_rows[build_row]);
+            }
+
+            m_probe_row = next_probe_row();
+            if (!m_probe_row) {
+                m_probe_done = true;
+                break;
+            }
+
+            m_matches = nullptr;
+            m_match_index = 0;
+            auto const& key = m_probe_row->value(m_join.probe_side().key_column);
+            if (can_match(key)) {
+                auto it = m_join.m_build_index.find(key);
+                if (it != m_join.m_build_index.end()) {
+                    m_matches = &it->second;
+                }
+            }
+            if (!m_matches && m_join.probe_side().keep_unmatched) {
+                return joined_row(*m_probe_row, m_build_null_row);
+            }
+        }
+
+        // Build rows that didn't match anything come last.
+        if (m_join.build_side().keep_unmatched) {
+            while (m_unmatched_index < m_join.m_build_rows.size()) {
+                auto build_row = m_unmatched_index++;
+                if (!m_build_row_matched[build_row]) {
+                    return joined_row(m_probe_null_row, m_join.m_build_rows[build_row]);
+                }
+            }
+        }
+        return {};
+    }
+
+    HashJoinRelation const& m_join;
+    RelationIterator m_probe_rows;
+    Tuple m_build_null_row;
+    Tuple m_probe_null_row;
+
+    RowBatch const* m_probe_batch = nullptr;
+    size_t m_probe_index = 0;
+    Tuple const* m_probe_row = nullptr;
+    bool m_probe_done = false;
+    std::vector<size_t> const* m_matches = nullptr;
+    size_t m_match_index = 0;
+
+    std::vector<bool> m_build_row_matched;
+    size_t m_unmatched_index = 0;
+    std::optional<Tuple> m_current_row;
+};
+
+RelationIterator HashJoinRelation::rows() const {
+    return RelationIterator { std::make_unique<IteratorImpl>(*this) };
+}
+
+size_t HashJoinRelation::size() const {
+    if (!m_size) {
+        size_t size = 0;
+        rows().for_each_batch([&](RowBatch const& batch) { size += batch.size(); });
+        m_size = size;
+    }
+    return *m_size;
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Relation.hpp"
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace Db::Core {
+
+// Rows of two relations joined on equality of one column of each. Rows of
+// the smaller relation are hashed by their key, and rows of the other one
+// are looked up while iterating, so joined rows are produced as they are
+// read instead of being stored.
+//
+// A row without any matching row is joined with NULLs if `keep_unmatched`
+// is set for its side (outer joins). NULL and NaN keys never match.
+class HashJoinRelation : public Relation {
+public:
+    struct Side {
+        std::unique_ptr<Relation> relation;
+        size_t key_column;
+        bool keep_unmatched;
+    };
+
+    HashJoinRelation(Side lhs, Side rhs);
+
+    virtual std::vector<Column> const& columns() const override { return m_columns; }
+    virtual RelationIterator rows() const override;
+    virtual MutableRelationIterator writable_rows() override { ESSA_UNREACHABLE; }
+
+    // Rows are counted by joining them once.
+    virtual size_t size() const override;
+
+private:
+    class IteratorImpl;
+
+    Side const& build_side() const { return m_build_is_lhs ? m_lhs : m_rhs; }
+    Side const& probe_side() const { return m_build_is_lhs ? m_rhs : m_lhs; }
+
+    Side m_lhs;
+    Side m_rhs;
+    bool m_build_is_lhs = false;
+    std::vector<Column> m_columns;
+    std::vector<Tuple> m_build_rows;
+    // Indexes into m_build_rows, in order of the build relation. Keys of
+    // numeric types are compared as numbers, so that e.g. INT and FLOAT
+    // columns can be joined.
+    std::unordered_map<Value, std::vector<size_t>, ValueHash, ValueEqual> m_build_index;
+    mutable std::optional<size_t> m_size;
+};
+
+}
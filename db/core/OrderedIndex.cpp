@@ -0,0 +1,139 @@
+#include "OrderedIndex.hpp"
+
+#include <EssaUtil/Config.hpp>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace Db::Core {
+
+static bool is_ordered(Value const& value, Value::Type type) {
+    if (value.type() != type) {
+        return false;
+    }
+    switch (value.type()) {
+    case Value::Type::Null:
+        return false;
+    case Value::Type::Float:
+        return !std::isnan(value.float_value());
+    case Value::Type::Time: {
+        // Times are compared by converting to int, which fails outside of
+        // its range.
+        auto epoch = value.time_value().to_utc_epoch();
+        return epoch >= std::numeric_limits<int>::min() && epoch <= std::numeric_limits<int>::max();
+    }
+    case Value::Type::Int:
+    case Value::Type::Varchar:
+    case Value::Type::Bool:
+        return true;
+    }
+    ESSA_UNREACHABLE;
+}
+
+int OrderedIndex::compare(Value const& lhs, Value const& rhs) {
+    auto compare = [](auto const& lhs, auto const& rhs) {
+        return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+    };
+    switch (lhs.type()) {
+    case Value::Type::Int:
+        return compare(lhs.int_value(), rhs.int_value());
+    case Value::Type::Float:
+        return compare(lhs.float_value(), rhs.float_value());
+    case Value::Type::Varchar:
+        return compare(lhs.varchar_value(), rhs.varchar_value());
+    case Value::Type::Bool:
+        return compare(lhs.bool_value(), rhs.bool_value());
+    case Value::Type::Time:
+        return compare(lhs.time_value().to_utc_epoch(), rhs.time_value().to_utc_epoch());
+    case Value::Type::Null:
+        break;
+    }
+    ESSA_UNREACHABLE;
+}
+
+bool OrderedIndex::Compare::operator()(Entry const& lhs, Entry const& rhs) const {
+    for (size_t s = 0; s < lhs.key.size(); s++) {
+        auto result = OrderedIndex::compare(lhs.key[s], rhs.key[s]);
+        if (result != 0) {
+            return result < 0;
+        }
+    }
+    return lhs.row < rhs.row;
+}
+
+bool OrderedIndex::Compare::operator()(Entry const& lhs, Probe const& rhs) const {
+    auto result = OrderedIndex::compare(lhs.key[0], rhs.value);
+    return result < 0 || (result == 0 && rhs.after_equal);
+}
+
+bool OrderedIndex::Compare::operator()(Probe const& lhs, Entry const& rhs) const {
+    auto result = OrderedIndex::compare(lhs.value, rhs.key[0]);
+    return result < 0 || (result == 0 && !lhs.after_equal);
+}
+
+std::optional<std::vector<Value>> OrderedIndex::key_of(Tuple const& row) const {
+    std::vector<Value> key;
+    key.reserve(m_columns.size());
+    for (size_t s = 0; s < m_columns.size(); s++) {
+        auto const& value = row.value(m_columns[s]);
+        if (!is_ordered(value, m_types[s])) {
+            return {};
+        }
+        key.push_back(value);
+    }
+    return key;
+}
+
+void OrderedIndex::insert(Tuple const& row, RowId id) {
+    auto key = key_of(row);
+    if (!key) {
+        m_unordered_rows.insert(id);
+        return;
+    }
+    m_entries.insert(Entry { .key = std::move(*key), .row = id });
+}
+
+void OrderedIndex::remove(Tuple const& row, RowId id) {
+    auto key = key_of(row);
+    if (!key) {
+        auto erased = m_unordered_rows.erase(id);
+        assert(erased == 1);
+        (void)erased;
+        return;
+    }
+    auto erased = m_entries.erase(Entry { .key = std::move(*key), .row = id });
+    assert(erased == 1);
+    (void)erased;
+}
+
+void OrderedIndex::clear() {
+    m_entries.clear();
+    m_unordered_rows.clear();
+}
+
+bool OrderedIndex::can_compare_first_column(Value const& value) const {
+    return is_ordered(value, m_types[0]);
+}
+
+void OrderedIndex::find_range(std::optional<Bound> const& lower, std::optional<Bound> const& upper, std::vector<RowId>& rows) const {
+    assert(!lower || can_compare_first_column(lower->value));
+    assert(!upper || can_compare_first_column(upper->value));
+
+    // Iterating from a position after the end would never stop.
+    bool is_empty = false;
+    if (lower && upper) {
+        auto result = compare(lower->value, upper->value);
+        is_empty = result > 0 || (result == 0 && !(lower->inclusive && upper->inclusive));
+    }
+
+    if (!is_empty) {
+        auto begin = lower ? m_entries.lower_bound(Probe { .value = lower->value, .after_equal = !lower->inclusive }) : m_entries.begin();
+        auto end = upper ? m_entries.lower_bound(Probe { .value = upper->value, .after_equal = upper->inclusive }) : m_entries.end();
+        for (auto it = begin; it != end; it++) {
+            rows.push_back(it->row);
+        }
+    }
+    rows.insert(rows.end(), m_unordered_rows.begin(), m_unordered_rows.end());
+}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Tuple.hpp"
+#include "Value.hpp"
+
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Db::Core {
+
+// In-memory ordered index of one or more columns, created with CREATE
+// INDEX. Rows are ordered by values of the columns (as by Value::operator<)
+// and then by row id, so that rows with equal keys stay in table order.
+//
+// Only keys whose values all have the types of their columns (and are not
+// NULL or NaN) compare consistently. Other rows are kept aside, and every
+// lookup returns them as candidates too.
+class OrderedIndex {
+public:
+    using RowId = size_t;
+
+    OrderedIndex(std::string name, std::vector<size_t> columns, std::vector<Value::Type> types)
+        : m_name(std::move(name))
+        , m_columns(std::move(columns))
+        , m_types(std::move(types)) { }
+
+    std::string const& name() const { return m_name; }
+    std::vector<size_t> const& columns() const { return m_columns; }
+
+    void insert(Tuple const& row, RowId);
+    void remove(Tuple const& row, RowId);
+    void clear();
+
+    // Whether `value` can be used as a bound of the first column.
+    bool can_compare_first_column(Value const& value) const;
+
+    struct Bound {
+        Value value;
+        bool inclusive;
+    };
+
+    // Rows which may have a value of the first column between the bounds
+    // (no bound means unbounded), in index order, followed by rows that
+    // are kept aside.
+    void find_range(std::optional<Bound> const& lower, std::optional<Bound> const& upper, std::vector<RowId>& rows) const;
+
+    // If there are none, find_range() returns rows only in index order.
+    bool has_unordered_rows() const { return !m_unordered_rows.empty(); }
+
+private:
+    struct Entry {
+        std::vector<Value> key;
+        RowId row;
+    };
+
+    // A position just before or just after all keys starting with `value`.
+    struct Probe {
+        Value const& value;
+        bool after_equal;
+    };
+
+    struct Compare {
+        using is_transparent = void;
+
+        bool operator()(Entry const&, Entry const&) const;
+        bool operator()(Entry const&, Probe const&) const;
+        bool operator()(Probe const&, Entry const&) const;
+    };
+
+    static int compare(Value const&, Value const&);
+    std::optional<std::vector<Value>> key_of(Tuple const&) const;
+
+    std::string m_name;
+    std::vector<size_t> m_columns;
+    std::vector<Value::Type> m_types;
+    std::set<Entry, Compare> m_entries;
+    std::set<RowId> m_unordered_rows;
+};
+
+}
@@ -3,20 +3,13 @@
 namespace Db::Core {
 
 std::optional<Tuple const*> Relation::find_first_matching_tuple(size_t column, Value value) {
-    std::optional<Tuple const*> tuple;
-    rows().for_each_row([&](auto const& row) {
-        // FIXME: Stop iterating if value is found.
-        if (tuple) {
-            return;
+    auto iterator = rows();
+    for (auto row = iterator.next_tuple(); row; row = iterator.next_tuple()) {
+        if (row->value(column).type() == value.type() && MUST(row->value(column) == value)) {
+            return row;
         }
-        if (row.value(column).type() != value.type()) {
-            return;
-        }
-        if (MUST(row.value(column) == value)) {
-            tuple = &row;
-        }
-    });
-    return tuple;
+    }
+    return {};
 }
 
 std::optional<Relation::ResolvedColumn> Relation::get_column(std::string const& name) const {
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "Column.hpp"
+#include "DbError.hpp"
 #include "Tuple.hpp"
 
 #include <EssaUtil/Config.hpp>
 #include <EssaUtil/Error.hpp>
-#include <list>
+#include <cassert>
+#include <optional>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -17,17 +19,120 @@ public:
     RowReference() = default;
     virtual ~RowReference() = default;
     virtual Tuple read() const = 0;
-    virtual void write(Tuple const&) = 0;
+    virtual DbErrorOr<void> write(Tuple const&) = 0;
 
     // Remove a row. This must NOT invalidate other references.
     virtual void remove() = 0;
     virtual std::unique_ptr<RowReference> clone() const = 0;
 };
 
+// Rows returned by RelationIteratorImpl::next_batch(). The batch is owned
+// by the iterator and reused, so it is valid only until the next call, and
+// its buffers are allocated only once per iterator.
+class RowBatch {
+public:
+    class Iterator {
+    public:
+        explicit Iterator(Tuple const* const* row)
+            : m_row(row) { }
+
+        Tuple const& operator*() const { return **m_row; }
+        Iterator& operator++() {
+            m_row++;
+            return *this;
+        }
+        bool operator==(Iterator const&) const = default;
+
+    private:
+        Tuple const* const* m_row;
+    };
+
+    size_t size() const { return m_rows.size(); }
+    bool empty() const { return m_rows.empty(); }
+    Tuple const& operator[](size_t index) const { return *m_rows[index]; }
+    Iterator begin() const { return Iterator { m_rows.data() }; }
+    Iterator end() const { return Iterator { m_rows.data() + m_rows.size() }; }
+
+    // Start a new batch of at most `max_rows` rows.
+    void reset(size_t max_rows) {
+        m_rows.clear();
+        m_owned_rows.clear();
+        m_rows.reserve(max_rows);
+    }
+
+    // Add a row that is stored by the relation itself, so that it doesn't
+    // need to be copied.
+    void add_row(Tuple const& row) { m_rows.push_back(&row); }
+
+    // Add a row that was decoded just for this batch.
+    void add_owned_row(Tuple row) {
+        // Reserving for the whole batch keeps pointers to owned rows valid.
+        if (m_owned_rows.empty()) {
+            m_owned_rows.reserve(m_rows.capacity());
+        }
+        assert(m_owned_rows.size() < m_owned_rows.capacity());
+        m_rows.push_back(&m_owned_rows.emplace_back(std::move(row)));
+    }
+
+private:
+    std::vector<Tuple const*> m_rows;
+    std::vector<Tuple> m_owned_rows;
+};
+
 class RelationIteratorImpl {
 public:
+    static constexpr size_t DefaultBatchSize = 1024;
+
     virtual ~RelationIteratorImpl() = default;
     virtual std::unique_ptr<RowReference> next() = 0;
+
+    // Read the next row. The tuple is owned by the iterator and valid only
+    // until the next call. Returns nullptr after the last row. Iterators
+    // may override this so that they don't allocate anything per row.
+    virtual Tuple const* next_tuple() {
+        auto reference = next();
+        if (!reference) {
+            return nullptr;
+        }
+        m_current_tuple = reference->read();
+        return &*m_current_tuple;
+    }
+
+    // Read at most `max_rows` next rows. An empty batch is returned after
+    // the last row. This is how bulk operations should read rows, as it
+    // amortizes the virtual call and (in iterators that implement it
+    // natively) doesn't allocate per row.
+    virtual RowBatch const& next_batch(size_t max_rows) {
+        m_batch.reset(max_rows);
+        m_batch_references.clear();
+        while (m_batch.size() < max_rows) {
+            auto reference = next();
+            if (!reference) {
+                break;
+            }
+            m_batch.add_owned_row(reference->read());
+            m_batch_references.push_back(std::move(reference));
+        }
+        return m_batch;
+    }
+
+    // Modify the `index`-th row of the last batch. The batch itself is not
+    // updated, and a removed row must not be read from it anymore. Rows must
+    // be removed in the order they appear in the batch.
+    virtual DbErrorOr<void> write_batch_row(size_t index, Tuple const& tuple) {
+        return m_batch_references[index]->write(tuple);
+    }
+    virtual DbErrorOr<void> remove_batch_row(size_t index) {
+        m_batch_references[index]->remove();
+        return {};
+    }
+
+protected:
+    RowBatch m_batch;
+
+private:
+    std::optional<Tuple> m_current_tuple;
+    std::vector<std::unique_ptr<RowReference>> m_batch_references;
 };
 
 // Boldly copied from SerenityOS
@@ -40,18 +145,35 @@ public:
         : m_impl(std::move(impl)) { }
 
     auto next() { return m_impl->next(); }
+    auto next_tuple() { return m_impl->next_tuple(); }
+    RowBatch const& next_batch(size_t max_rows = RelationIteratorImpl::DefaultBatchSize) { return m_impl->next_batch(max_rows); }
 
     template<class Callback>
     void for_each_row(Callback&& callback) {
-        for (auto row = next(); row; row = next()) {
-            callback(row->read());
+        for (auto row = next_tuple(); row; row = next_tuple()) {
+            callback(*row);
         }
     }
 
     template<class Callback>
-    auto try_for_each_row(Callback&& callback) -> decltype(callback(std::declval<Tuple>())) {
-        for (auto row = next(); row; row = next()) {
-            TRY(callback(row->read()));
+    auto try_for_each_row(Callback&& callback) -> decltype(callback(std::declval<Tuple const&>())) {
+        for (auto row = next_tuple(); row; row = next_tuple()) {
+            TRY(callback(*row));
+        }
+        return {};
+    }
+
+    template<class Callback>
+    void for_each_batch(Callback&& callback) {
+        for (auto batch = &next_batch(); !batch->empty(); batch = &next_batch()) {
+            callback(*batch);
+        }
+    }
+
+    template<class Callback>
+    auto try_for_each_batch(Callback&& callback) -> decltype(callback(std::declval<RowBatch const&>())) {
+        for (auto batch = &next_batch(); !batch->empty(); batch = &next_batch()) {
+            TRY(callback(*batch));
         }
         return {};
     }
@@ -66,21 +188,9 @@ public:
         : m_impl(std::move(impl)) { }
 
     auto next() { return m_impl->next(); }
-
-    template<class Callback>
-    void for_each_row_reference(Callback&& callback) {
-        for (auto row = next(); row; row = next()) {
-            callback(*row);
-        }
-    }
-
-    template<class Callback>
-    auto try_for_each_row_reference(Callback&& callback) -> decltype(callback(std::declval<RowReference&>())) {
-        for (auto row = next(); row; row = next()) {
-            TRY(callback(*row));
-        }
-        return {};
-    }
+    RowBatch const& next_batch(size_t max_rows = RelationIteratorImpl::DefaultBatchSize) { return m_impl->next_batch(max_rows); }
+    DbErrorOr<void> write_batch_row(size_t index, Tuple const& tuple) { return m_impl->write_batch_row(index, tuple); }
+    DbErrorOr<void> remove_batch_row(size_t index) { return m_impl->remove_batch_row(index); }
 
 private:
     std::unique_ptr<RelationIteratorImpl> m_impl {};
@@ -116,97 +226,4 @@ public:
     void dump_structure() const;
 };
 
-// An abstract table iterator that iterates over a container
-// of rows stored in memory.
-
-class MemoryBackedRelationIteratorImpl : public RelationIteratorImpl {
-public:
-    using List = std::list<Tuple>;
-    using Iterator = List::const_iterator;
-
-    explicit MemoryBackedRelationIteratorImpl(List const& list)
-        : m_list(list)
-        , m_current(list.begin()) { }
-
-    class RowReferenceImpl : public RowReference {
-    public:
-        explicit RowReferenceImpl(Iterator it)
-            : m_it(it) {
-        }
-
-        virtual Tuple read() const override {
-            return *m_it;
-        }
-        virtual void write(Tuple const&) override {
-            ESSA_UNREACHABLE;
-        }
-        virtual void remove() override {
-            ESSA_UNREACHABLE;
-        }
-        virtual std::unique_ptr<RowReference> clone() const override {
-            return std::make_unique<RowReferenceImpl>(*this);
-        }
-
-    private:
-        Iterator m_it;
-    };
-
-    virtual std::unique_ptr<RowReference> next() override {
-        if (m_current == m_list.end())
-            return {};
-        return std::make_unique<RowReferenceImpl>(m_current++);
-    }
-
-private:
-    List const& m_list;
-    Iterator m_current;
-};
-
-// An abstract table iterator that iterates over a container
-// of rows stored in memory.
-class MutableMemoryBackedRelationIteratorImpl : public RelationIteratorImpl {
-public:
-    using List = std::list<Tuple>;
-    using Iterator = List::iterator;
-
-    explicit MutableMemoryBackedRelationIteratorImpl(List& list)
-        : m_list(list)
-        , m_current(list.begin()) { }
-
-    class RowReferenceImpl : public RowReference {
-    public:
-        explicit RowReferenceImpl(List& list, Iterator it)
-            : m_list(list)
-            , m_it(it) {
-        }
-
-        virtual Tuple read() const override {
-            return *m_it;
-        }
-        virtual void write(Tuple const& tuple) override {
-            *m_it = tuple;
-        }
-        virtual void remove() override {
-            m_list.erase(m_it);
-        }
-        virtual std::unique_ptr<RowReference> clone() const override {
-            return std::make_unique<RowReferenceImpl>(*this);
-        }
-
-    private:
-        List& m_list;
-        Iterator m_it;
-    };
-
-    virtual std::unique_ptr<RowReference> next() override {
-        if (m_current == m_list.end())
-            return {};
-        return std::make_unique<RowReferenceImpl>(m_list, m_current++);
-    }
-
-private:
-    List& m_list;
-    Iterator m_current;
-};
-
 }
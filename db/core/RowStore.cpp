@@ -0,0 +1,138 @@
+#include "RowStore.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Db::Core {
+
+RowStore::Segment& RowStore::segment_for_append() {
+    if (m_slot_count % SegmentSize == 0) {
+        auto& segment = m_segments.emplace_back();
+        segment.rows.reserve(SegmentSize);
+        return segment;
+    }
+    return m_segments.back();
+}
+
+void RowStore::append(Tuple tuple) {
+    for (auto& index : m_indexes) {
+        index.insert(tuple.value(index.column()), m_slot_count);
+    }
+    for (auto& index : m_ordered_indexes) {
+        index.insert(tuple, m_slot_count);
+    }
+    segment_for_append().rows.push_back(std::move(tuple));
+    m_slot_count++;
+    m_size++;
+}
+
+void RowStore::append(std::span<Tuple const> tuples) {
+    while (!tuples.empty()) {
+        auto& segment = segment_for_append();
+        auto count = std::min(tuples.size(), SegmentSize - segment.rows.size());
+        for (auto& index : m_indexes) {
+            for (size_t s = 0; s < count; s++) {
+                index.insert(tuples[s].value(index.column()), m_slot_count + s);
+            }
+        }
+        for (auto& index : m_ordered_indexes) {
+            for (size_t s = 0; s < count; s++) {
+                index.insert(tuples[s], m_slot_count + s);
+            }
+        }
+        segment.rows.insert(segment.rows.end(), tuples.begin(), tuples.begin() + count);
+        tuples = tuples.subspan(count);
+        m_slot_count += count;
+        m_size += count;
+    }
+}
+
+void RowStore::write(SlotId slot, Tuple tuple) {
+    auto& row = segment(slot).rows[slot % SegmentSize];
+    for (auto& index : m_indexes) {
+        index.remove(row.value(index.column()), slot);
+        index.insert(tuple.value(index.column()), slot);
+    }
+    for (auto& index : m_ordered_indexes) {
+        index.remove(row, slot);
+        index.insert(tuple, slot);
+    }
+    row = std::move(tuple);
+}
+
+void RowStore::remove(SlotId slot) {
+    auto& segment = this->segment(slot);
+    assert(!segment.removed[slot % SegmentSize]);
+    for (auto& index : m_indexes) {
+        index.remove(segment.rows[slot % SegmentSize].value(index.column()), slot);
+    }
+    for (auto& index : m_ordered_indexes) {
+        index.remove(segment.rows[slot % SegmentSize], slot);
+    }
+    segment.removed[slot % SegmentSize] = true;
+    // Free the values now, the slot itself stays until compaction.
+    segment.rows[slot % SegmentSize].clear_row();
+    m_size--;
+}
+
+void RowStore::iterator_destroyed() {
+    assert(m_iterator_count > 0);
+    auto removed_count = m_slot_count - m_size;
+    if (--m_iterator_count == 0 && removed_count > 0 && removed_count * 4 >= m_slot_count) {
+        compact();
+    }
+}
+
+void RowStore::add_index(size_t column, Value::Type type) {
+    auto& index = m_indexes.emplace_back(column, type);
+    for (SlotId slot = 0; slot < m_slot_count; slot++) {
+        if (!is_removed(slot)) {
+            index.insert(row(slot).value(column), slot);
+        }
+    }
+}
+
+void RowStore::add_ordered_index(OrderedIndex index) {
+    for (SlotId slot = 0; slot < m_slot_count; slot++) {
+        if (!is_removed(slot)) {
+            index.insert(row(slot), slot);
+        }
+    }
+    m_ordered_indexes.push_back(std::move(index));
+}
+
+bool RowStore::drop_ordered_index(std::string const& name) {
+    return std::erase_if(m_ordered_indexes, [&](auto const& index) { return index.name() == name; }) > 0;
+}
+
+HashIndex const* RowStore::index(size_t column) const {
+    for (auto const& index : m_indexes) {
+        if (index.column() == column) {
+            return &index;
+        }
+    }
+    return nullptr;
+}
+
+void RowStore::compact() {
+    auto old_segments = std::move(m_segments);
+    m_segments.clear();
+    m_slot_count = 0;
+    m_size = 0;
+    // Slots change, so indexes are rebuilt while appending.
+    for (auto& index : m_indexes) {
+        index.clear();
+    }
+    for (auto& index : m_ordered_indexes) {
+        index.clear();
+    }
+    for (auto& segment : old_segments) {
+        for (size_t s = 0; s < segment.rows.size(); s++) {
+            if (!segment.removed[s]) {
+                append(std::move(segment.rows[s]));
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "HashIndex.hpp"
+#include "OrderedIndex.hpp"
+#include "Relation.hpp"
+#include "Tuple.hpp"
+
+#include <bitset>
+#include <span>
+#include <vector>
+
+namespace Db::Core {
+
+// Rows of a MemoryBackedTable. They are stored in segments of fixed
+// capacity, so appending never moves existing rows, and addressed by slot
+// ids (segment * SegmentSize + index in segment).
+//
+// Removing a row only marks its slot as removed, so that slot ids and
+// pointers to other rows stay valid. Removed slots are compacted away
+// once they make up a quarter of the store, but only when no iterator
+// over the store exists.
+//
+// The store also maintains hash and ordered indexes of chosen columns, so
+// all writes must go through it.
+class RowStore {
+public:
+    static constexpr size_t SegmentSize = 256;
+    using SlotId = size_t;
+
+    // Number of rows, not including removed ones.
+    size_t size() const { return m_size; }
+    size_t slot_count() const { return m_slot_count; }
+
+    void append(Tuple);
+    void append(std::span<Tuple const>);
+
+    bool is_removed(SlotId slot) const { return segment(slot).removed[slot % SegmentSize]; }
+    Tuple const& row(SlotId slot) const { return segment(slot).rows[slot % SegmentSize]; }
+    void write(SlotId, Tuple);
+    void remove(SlotId);
+
+    // Index `column`, including rows that are already stored.
+    void add_index(size_t column, Value::Type);
+    HashIndex const* index(size_t column) const;
+
+    // Ordered indexes are addressed by name.
+    void add_ordered_index(OrderedIndex);
+    bool drop_ordered_index(std::string const& name);
+    std::vector<OrderedIndex> const& ordered_indexes() const { return m_ordered_indexes; }
+
+    void iterator_created() const { m_iterator_count++; }
+    void iterator_destroyed();
+
+private:
+    struct Segment {
+        // Reserved to SegmentSize up front, so it never reallocates.
+        std::vector<Tuple> rows;
+        std::bitset<SegmentSize> removed;
+    };
+
+    Segment const& segment(SlotId slot) const { return m_segments[slot / SegmentSize]; }
+    Segment& segment(SlotId slot) { return m_segments[slot / SegmentSize]; }
+    Segment& segment_for_append();
+    void compact();
+
+    std::vector<Segment> m_segments;
+    std::vector<HashIndex> m_indexes;
+    std::vector<OrderedIndex> m_ordered_indexes;
+    size_t m_slot_count = 0;
+    size_t m_size = 0;
+    mutable size_t m_iterator_count = 0;
+};
+
+// Iterates over rows of a RowStore, or only over the given slots, e.g.
+// found with an index. Rows are read and referenced in place, so neither
+// next_tuple() nor next_batch() allocates.
+class RowStoreIteratorImpl : public RelationIteratorImpl {
+public:
+    explicit RowStoreIteratorImpl(RowStore& store)
+        : m_store(store) {
+        m_store.iterator_created();
+    }
+
+    RowStoreIteratorImpl(RowStore& store, std::vector<RowStore::SlotId> slots)
+        : m_store(store)
+        , m_slots(std::move(slots)) {
+        m_store.iterator_created();
+    }
+
+    ~RowStoreIteratorImpl() {
+        m_store.iterator_destroyed();
+    }
+
+    class RowReferenceImpl : public RowReference {
+    public:
+        RowReferenceImpl(RowStore& store, RowStore::SlotId slot)
+            : m_store(store)
+            , m_slot(slot) { }
+
+        virtual Tuple read() const override { return m_store.row(m_slot); }
+        virtual DbErrorOr<void> write(Tuple const& tuple) override {
+            m_store.write(m_slot, tuple);
+            return {};
+        }
+        virtual void remove() override { m_store.remove(m_slot); }
+        virtual std::unique_ptr<RowReference> clone() const override {
+            return std::make_unique<RowReferenceImpl>(*this);
+        }
+
+    private:
+        RowStore& m_store;
+        RowStore::SlotId m_slot;
+    };
+
+    virtual std::unique_ptr<RowReference> next() override {
+        auto slot = next_slot();
+        if (!slot) {
+            return {};
+        }
+        return std::make_unique<RowReferenceImpl>(m_store, *slot);
+    }
+
+    virtual Tuple const* next_tuple() override {
+        auto slot = next_slot();
+        if (!slot) {
+            return nullptr;
+        }
+        return &m_store.row(*slot);
+    }
+
+    virtual RowBatch const& next_batch(size_t max_rows) override {
+        m_batch.reset(max_rows);
+        m_batch_slots.clear();
+        while (m_batch.size() < max_rows) {
+            auto slot = next_slot();
+            if (!slot) {
+                break;
+            }
+            m_batch.add_row(m_store.row(*slot));
+            m_batch_slots.push_back(*slot);
+        }
+        return m_batch;
+    }
+
+    virtual DbErrorOr<void> write_batch_row(size_t index, Tuple const& tuple) override {
+        m_store.write(m_batch_slots[index], tuple);
+        return {};
+    }
+
+    virtual DbErrorOr<void> remove_batch_row(size_t index) override {
+        m_store.remove(m_batch_slots[index]);
+        return {};
+    }
+
+private:
+    std::optional<RowStore::SlotId> next_slot() {
+        if (m_slots) {
+            while (m_next_slot < m_slots->size()) {
+                auto slot = (*m_slots)[m_next_slot++];
+                if (!m_store.is_removed(slot)) {
+                    return slot;
+                }
+            }
+            return {};
+        }
+
+        // Rows may be appended while iterating, so the slot count is
+        // checked every time.
+        while (m_next_slot < m_store.slot_count()) {
+            auto slot = m_next_slot++;
+            if (!m_store.is_removed(slot)) {
+                return slot;
+            }
+        }
+        return {};
+    }
+
+    RowStore& m_store;
+    // Index into m_slots, if given.
+    RowStore::SlotId m_next_slot = 0;
+    std::optional<std::vector<RowStore::SlotId>> m_slots;
+    std::vector<RowStore::SlotId> m_batch_slots;
+};
+
+}
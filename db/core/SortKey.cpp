@@ -0,0 +1,79 @@
+#include "SortKey.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace Db::Core {
+
+enum SortKeyTag : uint8_t {
+    Null = 0,
+    Number = 1,
+    String = 2,
+};
+
+static void append_number(std::string& key, double number) {
+    if (number == 0) {
+        number = 0; // -0
+    }
+    if (std::isnan(number)) {
+        number = std::numeric_limits<double>::quiet_NaN();
+    }
+    // Flipping the sign bit of positive numbers and all bits of negative
+    // ones makes the bits compare like the numbers. NaN comes last.
+    auto bits = std::bit_cast<uint64_t>(number);
+    bits = (bits >> 63) ? ~bits : bits | (uint64_t { 1 } << 63);
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        key.push_back(static_cast<char>(bits >> shift));
+    }
+}
+
+static void append_string(std::string& key, std::string_view string) {
+    // Zero bytes are escaped, so that the terminator is less than any
+    // character and shorter strings come first.
+    for (auto c : string) {
+        key.push_back(c);
+        if (c == '\0') {
+            key.push_back('\xff');
+        }
+    }
+    key.push_back('\0');
+    key.push_back('\0');
+}
+
+void append_sort_key(std::string& key, Value const& value, bool descending) {
+    auto start = key.size();
+    switch (value.type()) {
+    case Value::Type::Null:
+        key.push_back(SortKeyTag::Null);
+        break;
+    case Value::Type::Int:
+        key.push_back(SortKeyTag::Number);
+        append_number(key, value.int_value());
+        break;
+    case Value::Type::Float:
+        key.push_back(SortKeyTag::Number);
+        append_number(key, value.float_value());
+        break;
+    case Value::Type::Bool:
+        key.push_back(SortKeyTag::Number);
+        append_number(key, value.bool_value() ? 1 : 0);
+        break;
+    case Value::Type::Time:
+        key.push_back(SortKeyTag::Number);
+        append_number(key, static_cast<double>(value.time_value().to_utc_epoch()));
+        break;
+    case Value::Type::Varchar:
+        key.push_back(SortKeyTag::String);
+        append_string(key, value.varchar_value());
+        break;
+    }
+    if (descending) {
+        for (size_t s = start; s < key.size(); s++) {
+            key[s] = static_cast<char>(~key[s]);
+        }
+    }
+}
+
+}
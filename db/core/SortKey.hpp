@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Value.hpp"
+
+#include <string>
+
+namespace Db::Core {
+
+// Appends `value` to `key`, encoded so that comparing whole keys as bytes
+// (e.g. with std::string's operator<) orders them like the values. Keys
+// of multiple values are ordered by the first value, then by the next
+// one and so on.
+//
+// NULL comes first (last if `descending`). Numbers of all types are
+// compared with each other, and come before strings.
+void append_sort_key(std::string& key, Value const& value, bool descending = false);
+
+}
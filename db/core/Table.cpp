@@ -1,5 +1,6 @@
 #include "Table.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <db/core/Column.hpp>
 #include <db/core/Database.hpp>
@@ -37,17 +38,23 @@ DbErrorOr<void> Table::check_value_validity(Tuple const& row, size_t column_inde
         return DbError { fmt::format("NULL given for NOT NULL column '{}'", column.name()) };
     }
 
-    if (column.unique()) {
-        TRY(rows().try_for_each_row([&](Tuple const& other_row) -> DbErrorOr<void> {
-            if (TRY(other_row.value(column_index) == row.value(column_index)))
-                return DbError { fmt::format("Column '{}' must contain unique values", column.name()) };
-            return {};
-        }));
+    if (column.unique() && TRY(contains_value(column_index, row.value(column_index)))) {
+        return DbError { fmt::format("Column '{}' must contain unique values", column.name()) };
     }
 
     return {};
 }
 
+DbErrorOr<bool> Table::contains_value(size_t column, Value const& value) const {
+    auto iterator = rows();
+    for (auto row = iterator.next_tuple(); row; row = iterator.next_tuple()) {
+        if (TRY(row->value(column) == value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 DbErrorOr<void> Table::perform_table_integrity_checks(Tuple const& row) const {
     auto const& columns = this->columns();
 
@@ -68,11 +75,9 @@ DbErrorOr<void> Table::perform_table_integrity_checks(Tuple const& row) const {
         if (value.is_null()) {
             return DbError { "Primary key may not be null" };
         }
-        TRY(rows().try_for_each_row([&](Tuple const& other_row) -> DbErrorOr<void> {
-            if (TRY(other_row.value(column->index) == value))
-                return DbError { "Primary key must be unique" };
-            return {};
-        }));
+        if (TRY(contains_value(column->index, value))) {
+            return DbError { "Primary key must be unique" };
+        }
     }
 
     // Column types, NON NULL, UNIQUE
@@ -90,7 +95,8 @@ DbErrorOr<void> Table::perform_database_integrity_checks(Database* db, Tuple con
 
     // Foreign keys (row existence in the foreign table)
     // For now, this is checked even if no constraint is explicitly defined.
-    for (auto const& fk : foreign_keys()) {
+    for (size_t fk_index = 0; fk_index < foreign_keys().size(); fk_index++) {
+        auto const& fk = foreign_keys()[fk_index];
         auto local_column = get_column(fk.local_column);
         if (!local_column) {
             return DbError { fmt::format("Internal error: Nonexistent column '{}' used as foreign key", fk.local_column) };
@@ -106,7 +112,7 @@ DbErrorOr<void> Table::perform_database_integrity_checks(Database* db, Tuple con
             continue;
         }
 
-        if (!referenced_table->find_first_matching_tuple(referenced_column->index, local_value)) {
+        if (!TRY(has_referenced_value(*referenced_table, fk_index, referenced_column->index, local_value))) {
             return DbError {
                 fmt::format("Foreign key '{}' requires matching value in referenced column '{}.{}'",
                     fk.local_column, fk.referenced_table, fk.referenced_column),
@@ -117,6 +123,37 @@ DbErrorOr<void> Table::perform_database_integrity_checks(Database* db, Tuple con
     return {};
 }
 
+DbErrorOr<bool> Table::has_referenced_value(Table& referenced_table, size_t foreign_key, size_t column, Value const& value) const {
+    // Only values of the same type match a foreign key.
+    auto type = referenced_table.columns()[column].type();
+    if (value.type() != type) {
+        return referenced_table.find_first_matching_tuple(column, value).has_value();
+    }
+
+    if (m_inserting_batch && !referenced_table.has_index(column)) {
+        auto values = m_referenced_values.find(foreign_key);
+        if (values == m_referenced_values.end()) {
+            std::optional<HashIndex> index;
+            if (HashIndex::is_supported(type)) {
+                index.emplace(column, type);
+                HashIndex::RowId row_id = 0;
+                referenced_table.rows().for_each_batch([&](RowBatch const& batch) {
+                    for (auto const& row : batch) {
+                        index->insert(row.value(column), row_id++);
+                    }
+                });
+            }
+            values = m_referenced_values.emplace(foreign_key, std::move(index)).first;
+        }
+        if (values->second && values->second->can_find(value) && values->second->find(value)) {
+            return true;
+        }
+        // Rows inserted during the batch (if the table references itself)
+        // are not collected, so the table has the final say.
+    }
+    return referenced_table.contains_referenced_value(column, value);
+}
+
 DbErrorOr<void> Table::insert(Database* db, Tuple const& row) {
     auto const& columns = this->columns();
 
@@ -152,6 +189,91 @@ DbErrorOr<void> Table::insert(Database* db, Tuple const& row) {
     return insert_unchecked(filled_row);
 }
 
+DbErrorOr<void> Table::insert_batch(Database* db, std::span<Tuple const> rows) {
+    begin_batch();
+    m_inserting_batch = true;
+    auto finish_batch = [&]() {
+        m_inserting_batch = false;
+        m_referenced_values.clear();
+        return end_batch();
+    };
+    for (auto const& row : rows) {
+        auto result = insert(db, row);
+        if (result.is_error()) {
+            // The rows inserted so far stay in the table, so their
+            // bookkeeping must be finished anyway.
+            (void)finish_batch();
+            return result;
+        }
+    }
+    return finish_batch();
+}
+
+void MemoryBackedTable::create_indexes() {
+    for (size_t s = 0; s < m_columns.size(); s++) {
+        auto const& column = m_columns[s];
+        bool is_primary_key = primary_key() && primary_key()->local_column == column.name();
+        if ((is_primary_key || column.unique()) && HashIndex::is_supported(column.type())) {
+            m_rows.add_index(s, column.type());
+        }
+    }
+}
+
+DbErrorOr<bool> MemoryBackedTable::contains_value(size_t column, Value const& value) const {
+    auto index = m_rows.index(column);
+    if (!index || !index->can_find(value)) {
+        return Table::contains_value(column, value);
+    }
+    return index->find(value).has_value();
+}
+
+DbErrorOr<bool> MemoryBackedTable::contains_referenced_value(size_t column, Value const& value) {
+    if (!m_rows.index(column) && HashIndex::is_supported(m_columns[column].type())) {
+        m_rows.add_index(column, m_columns[column].type());
+    }
+    return contains_value(column, value);
+}
+
+DbErrorOr<void> MemoryBackedTable::create_index(std::string const& name, std::vector<std::string> const& columns) {
+    for (auto const& index : m_rows.ordered_indexes()) {
+        if (index.name() == name) {
+            return DbError { fmt::format("Index '{}' already exists", name) };
+        }
+    }
+
+    std::vector<size_t> column_indexes;
+    std::vector<Value::Type> types;
+    for (auto const& column_name : columns) {
+        auto column = get_column(column_name);
+        if (!column) {
+            return DbError { fmt::format("Column '{}' does not exist in table '{}'", column_name, m_name) };
+        }
+        column_indexes.push_back(column->index);
+        types.push_back(column->column.type());
+    }
+    m_rows.add_ordered_index(OrderedIndex { name, std::move(column_indexes), std::move(types) });
+    return {};
+}
+
+DbErrorOr<void> MemoryBackedTable::drop_index(std::string const& name) {
+    if (!m_rows.drop_ordered_index(name)) {
+        return DbError { fmt::format("Index '{}' does not exist", name) };
+    }
+    return {};
+}
+
+std::vector<MemoryBackedTable::IndexSetup> MemoryBackedTable::index_setups() const {
+    std::vector<IndexSetup> setups;
+    for (auto const& index : ordered_indexes()) {
+        IndexSetup setup { .name = index.name(), .columns = {} };
+        for (auto column : index.columns()) {
+            setup.columns.push_back(m_columns[column].name());
+        }
+        setups.push_back(std::move(setup));
+    }
+    return setups;
+}
+
 DbErrorOr<std::unique_ptr<MemoryBackedTable>> MemoryBackedTable::create_from_select_result(ResultSet const& select) {
 
     auto const& rows = select.rows();
@@ -165,7 +287,7 @@ DbErrorOr<std::unique_ptr<MemoryBackedTable>> MemoryBackedTable::create_from_sel
     }
 
     std::unique_ptr<MemoryBackedTable> table = std::make_unique<MemoryBackedTable>(nullptr, TableSetup { "SelectResult", columns });
-    std::copy(rows.begin(), rows.end(), std::back_inserter(table->m_rows));
+    table->m_rows.append(rows);
     return table;
 }
 
@@ -217,7 +339,7 @@ DbErrorOr<void> MemoryBackedTable::rename(std::string const& new_name) {
 }
 
 DbErrorOr<void> MemoryBackedTable::insert_unchecked(Tuple const& row) {
-    m_rows.push_back(row);
+    m_rows.append(row);
     return {};
 }
 
@@ -238,25 +360,24 @@ void Table::export_to_csv(const std::string& path) const {
         i++;
     }
 
-    rows().for_each_row([&](auto const& row) {
-        i = 0;
-        for (auto it = row.begin(); it != row.end(); it++) {
-            f_out << it->to_string().release_value();
+    rows().for_each_batch([&](RowBatch const& batch) {
+        for (auto const& row : batch) {
+            i = 0;
+            for (auto it = row.begin(); it != row.end(); it++) {
+                f_out << it->to_string().release_value();
 
-            if (i < columns.size() - 1)
-                f_out << ',';
-            else
-                f_out << '\n';
-            i++;
+                if (i < columns.size() - 1)
+                    f_out << ',';
+                else
+                    f_out << '\n';
+                i++;
+            }
         }
     });
 }
 
 DbErrorOr<void> Table::import_from_csv(Database* db, Storage::CSVFile const& file) {
-    for (auto const& row : file.rows()) {
-        TRY(insert(db, row));
-    }
-    return {};
+    return insert_batch(db, file.rows());
 }
 
 }
@@ -6,12 +6,14 @@
 #include <db/core/DbError.hpp>
 #include <db/core/IndexedRelation.hpp>
 #include <db/core/ResultSet.hpp>
+#include <db/core/RowStore.hpp>
 #include <db/core/TableSetup.hpp>
 #include <db/storage/CSVFile.hpp>
 #include <map>
 #include <memory>
 #include <optional>
 #include <set>
+#include <span>
 
 // FIXME: Get rid of Core -> SQL dependency
 #include <db/sql/ast/Expression.hpp>
@@ -29,6 +31,11 @@ public:
 
     DbErrorOr<void> insert(Database* db, Tuple const&);
 
+    // Inserts rows one by one (so that they are checked against each
+    // other), but lets the storage engine defer its bookkeeping until
+    // all rows are inserted.
+    DbErrorOr<void> insert_batch(Database* db, std::span<Tuple const>);
+
     // NOTE: This doesn't check types and integrity in any way!
     virtual DbErrorOr<void> insert_unchecked(Tuple const&) = 0;
 
@@ -37,7 +44,27 @@ public:
 
     virtual void dump_storage_debug() { }
 
+    // Check if any row has `value` in `column`, using the same comparison
+    // as `Value::operator==`. By default, this iterates over the table.
+    virtual DbErrorOr<bool> contains_value(size_t column, Value const& value) const;
+
+    // Like contains_value(), but used for checking foreign keys that
+    // reference `column`. This is done for every inserted row, so storage
+    // engines may index the column on first use.
+    virtual DbErrorOr<bool> contains_referenced_value(size_t column, Value const& value) { return contains_value(column, value); }
+
+    // Whether contains_referenced_value() doesn't scan the table.
+    virtual bool has_index(size_t) const { return false; }
+
+    // Rows that may have `value` in `column`, if the engine can find them
+    // with an index. Callers still need to compare the values.
+    virtual std::optional<RelationIterator> rows_with_value(size_t, Value const&) const { return {}; }
+
 protected:
+    // Called around a series of insert_unchecked() calls.
+    virtual void begin_batch() { }
+    virtual DbErrorOr<void> end_batch() { return {}; }
+
     // Check integrity with database, i.e foreign keys, checks, constraints, ...
     virtual DbErrorOr<void> perform_database_integrity_checks(Database* db, Tuple const& row) const;
 
@@ -46,17 +73,25 @@ private:
 
     // Check integrity with table, i.e if types match, if columns are NON NULL/UNIQUE, primary keys, ...
     DbErrorOr<void> perform_table_integrity_checks(Tuple const& row) const;
+
+    DbErrorOr<bool> has_referenced_value(Table& referenced_table, size_t foreign_key, size_t column, Value const& value) const;
+
+    // Values of columns referenced by foreign keys (by index of the key),
+    // collected once per insert_batch() from tables that don't index them,
+    // so that they aren't scanned for every inserted row.
+    mutable std::map<size_t, std::optional<HashIndex>> m_referenced_values;
+    bool m_inserting_batch = false;
 };
 
 class MemoryBackedTable : public Table {
 public:
-    auto begin() { return m_rows.begin(); }
-    auto end() { return m_rows.end(); }
-
     MemoryBackedTable(std::shared_ptr<Sql::AST::Check> check, TableSetup const& setup)
         : m_columns(setup.columns)
         , m_check(std::move(check))
-        , m_name(setup.name) { }
+        , m_name(setup.name) {
+        set_primary_key(setup.primary_key);
+        create_indexes();
+    }
 
     static DbErrorOr<std::unique_ptr<MemoryBackedTable>> create_from_select_result(ResultSet const& select);
 
@@ -64,30 +99,55 @@ public:
     virtual std::vector<Column> const& columns() const override { return m_columns; }
 
     virtual RelationIterator rows() const override {
-        return RelationIterator { std::make_unique<MemoryBackedRelationIteratorImpl>(m_rows) };
+        // The iterator is shared with writable_rows(), but references
+        // returned from here are never written to.
+        return RelationIterator { std::make_unique<RowStoreIteratorImpl>(const_cast<RowStore&>(m_rows)) };
     }
     virtual MutableRelationIterator writable_rows() override {
-        return MutableRelationIterator { std::make_unique<MutableMemoryBackedRelationIteratorImpl>(m_rows) };
+        return MutableRelationIterator { std::make_unique<RowStoreIteratorImpl>(m_rows) };
     }
 
     virtual size_t size() const override { return m_rows.size(); }
 
-    std::list<Tuple> const& raw_rows() const { return m_rows; }
-    std::list<Tuple>& raw_rows() { return m_rows; }
     virtual std::string name() const override { return m_name; }
 
     std::shared_ptr<Sql::AST::Check>& check() { return m_check; }
     std::shared_ptr<Sql::AST::Check> const& check() const { return m_check; }
 
     virtual DbErrorOr<void> insert_unchecked(Tuple const&) override;
+    virtual DbErrorOr<bool> contains_value(size_t column, Value const&) const override;
+    virtual DbErrorOr<bool> contains_referenced_value(size_t column, Value const&) override;
+    virtual bool has_index(size_t column) const override { return HashIndex::is_supported(m_columns[column].type()); }
+
+    // Ordered indexes created with CREATE INDEX.
+    DbErrorOr<void> create_index(std::string const& name, std::vector<std::string> const& columns);
+    DbErrorOr<void> drop_index(std::string const& name);
+    std::vector<OrderedIndex> const& ordered_indexes() const { return m_rows.ordered_indexes(); }
+
+    // Definitions of the ordered indexes, to recreate them together with
+    // the table.
+    struct IndexSetup {
+        std::string name;
+        std::vector<std::string> columns;
+    };
+    std::vector<IndexSetup> index_setups() const;
+
+    // Iterate over the given rows (found with an index), in that order.
+    RelationIterator rows_in_slots(std::vector<RowStore::SlotId> slots) const {
+        return RelationIterator { std::make_unique<RowStoreIteratorImpl>(const_cast<RowStore&>(m_rows), std::move(slots)) };
+    }
 
 private:
+    // Index PRIMARY KEY and UNIQUE columns, so that checking them doesn't
+    // scan the table.
+    void create_indexes();
+
     virtual int next_auto_increment_value(std::string const& column) override { return m_auto_increment_values[column] + 1; }
     virtual int increment(std::string const& column) override { return ++m_auto_increment_values[column]; }
     virtual DbErrorOr<void> rename(std::string const& new_name) override;
     virtual DbErrorOr<void> perform_database_integrity_checks(Database* db, Tuple const& row) const override;
 
-    std::list<Tuple> m_rows;
+    RowStore m_rows;
     std::vector<Column> m_columns;
     std::shared_ptr<Sql::AST::Check> m_check;
     std::map<std::string, int> m_auto_increment_values;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <db/core/Column.hpp>
+#include <db/core/IndexedRelation.hpp>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -9,6 +11,7 @@ namespace Db::Core {
 struct TableSetup {
     std::string name;
     std::vector<Core::Column> columns;
+    std::optional<PrimaryKey> primary_key {};
 };
 
 }
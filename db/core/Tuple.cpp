@@ -34,6 +34,19 @@ bool operator<(Tuple const& lhs, Tuple const& rhs) {
     return false;
 }
 
+size_t TupleHash::operator()(Tuple const& tuple) const {
+    size_t hash = tuple.value_count();
+    for (auto const& value : tuple) {
+        // Combined like boost::hash_combine.
+        hash ^= ValueHash {}(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+bool TupleEqual::operator()(Tuple const& lhs, Tuple const& rhs) const {
+    return lhs.value_count() == rhs.value_count() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), ValueEqual {});
+}
+
 std::ostream& operator<<(std::ostream& out, Tuple const& tuple) {
     out << "(";
     size_t index = 0;
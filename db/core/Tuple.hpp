@@ -26,7 +26,7 @@ public:
     }
 
     size_t value_count() const { return m_values.size(); }
-    Value value(size_t index) const {
+    Value const& value(size_t index) const {
         assert(index < m_values.size());
         return m_values[index];
     }
@@ -69,6 +69,18 @@ inline DbErrorOr<bool> operator==(Tuple const& lhs, Tuple const& rhs) {
 
 bool operator<(Tuple const& lhs, Tuple const& rhs);
 
+// Hash and equality of tuples, comparing values like ValueHash and
+// ValueEqual.
+class TupleHash {
+public:
+    size_t operator()(Tuple const&) const;
+};
+
+class TupleEqual {
+public:
+    bool operator()(Tuple const&, Tuple const&) const;
+};
+
 struct TupleWithSource {
     Tuple tuple;
     std::optional<Tuple> source;
@@ -9,9 +9,11 @@
 #include <db/sql/Printing.hpp>
 
 #include <cctype>
+#include <cmath>
 #include <ctime>
 #include <iostream>
 #include <limits>
+#include <new>
 #include <ostream>
 #include <regex>
 #include <sstream>
@@ -138,28 +140,85 @@ DbErrorOr<Value> Value::from_string(Type type, std::string const& string) {
     __builtin_unreachable();
 }
 
+// Date fields packed from the most significant, so that packed dates
+// compare the same way as dates. Unlike an epoch, this keeps the fields
+// exactly as given.
+static int64_t pack_date(Date const& date) {
+    return (static_cast<int64_t>(date.year) << 26)
+        | ((date.month & 0xf) << 22)
+        | ((date.day & 0x1f) << 17)
+        | ((date.hour & 0x1f) << 12)
+        | ((date.min & 0x3f) << 6)
+        | (date.sec & 0x3f);
+}
+
+static Date unpack_date(int64_t packed) {
+    return {
+        .year = static_cast<int>(packed >> 26),
+        .month = static_cast<int>((packed >> 22) & 0xf),
+        .day = static_cast<int>((packed >> 17) & 0x1f),
+        .hour = static_cast<int>((packed >> 12) & 0x1f),
+        .min = static_cast<int>((packed >> 6) & 0x3f),
+        .sec = static_cast<int>(packed & 0x3f),
+    };
+}
+
+void Value::free_long_string(LongString* string) {
+    string->~LongString();
+    ::operator delete(string);
+}
+
+std::string_view Value::varchar_value() const {
+    if (auto string = long_string()) {
+        return { string->data(), string->size };
+    }
+    return { m_data, m_string_size };
+}
+
+Date Value::time_value() const {
+    return unpack_date(load<int64_t>());
+}
+
 Value Value::null() {
-    return Value { std::monostate {}, Type::Null };
+    return Value { Type::Null };
 }
 
 Value Value::create_int(int i) {
-    return Value { i, Type::Int };
+    Value value { Type::Int };
+    value.store(i);
+    return value;
 }
 
 Value Value::create_float(float f) {
-    return Value { f, Type::Float };
+    Value value { Type::Float };
+    value.store(f);
+    return value;
 }
 
 Value Value::create_varchar(std::string s) {
-    return Value { std::move(s), Type::Varchar };
+    Value value { Type::Varchar };
+    if (s.size() <= InlineStringCapacity) {
+        std::memcpy(value.m_data, s.data(), s.size());
+        value.m_string_size = s.size();
+        return value;
+    }
+    auto string = new (::operator new(sizeof(LongString) + s.size())) LongString { .ref_count = 1, .size = static_cast<uint32_t>(s.size()) };
+    std::memcpy(string->data(), s.data(), s.size());
+    value.store(string);
+    value.m_string_size = LongStringSize;
+    return value;
 }
 
 Value Value::create_bool(bool b) {
-    return Value { b, Type::Bool };
+    Value value { Type::Bool };
+    value.store(b);
+    return value;
 }
 
 Value Value::create_time(Date t) {
-    return Value { t, Type::Time };
+    Value value { Type::Time };
+    value.store(pack_date(t));
+    return value;
 }
 
 DbErrorOr<int> Value::to_int() const {
@@ -168,11 +227,11 @@ DbErrorOr<int> Value::to_int() const {
     case Type::Null:
         return 0;
     case Type::Int:
-        return std::get<int>(*this);
+        return int_value();
     case Type::Float:
-        return static_cast<int>(std::get<float>(*this));
+        return static_cast<int>(float_value());
     case Type::Varchar: {
-        auto str = std::get<std::string>(*this);
+        auto str = std::string { varchar_value() };
         try {
             return std::stoi(str);
         } catch (...) {
@@ -180,9 +239,9 @@ DbErrorOr<int> Value::to_int() const {
         }
     }
     case Type::Bool:
-        return std::get<bool>(*this) ? 1 : 0;
+        return bool_value() ? 1 : 0;
     case Type::Time: {
-        auto range = std::get<Date>(*this).to_utc_epoch();
+        auto range = time_value().to_utc_epoch();
         if (range > std::numeric_limits<int>::max()) {
             // Fix your database until it hits y2k38...
             return DbError { "Timestamp out of range for int type" };
@@ -199,11 +258,11 @@ DbErrorOr<float> Value::to_float() const {
     case Type::Null:
         return 0.f;
     case Type::Int:
-        return static_cast<float>(std::get<int>(*this));
+        return static_cast<float>(int_value());
     case Type::Float:
-        return std::get<float>(*this);
+        return float_value();
     case Type::Varchar: {
-        auto str = std::get<std::string>(*this);
+        auto str = std::string { varchar_value() };
         try {
             return std::stof(str);
         } catch (...) {
@@ -211,7 +270,7 @@ DbErrorOr<float> Value::to_float() const {
         }
     }
     case Type::Bool:
-        return std::get<bool>(*this) ? 1.f : 0.f;
+        return bool_value() ? 1.f : 0.f;
     case Type::Time:
         return DbError { "Time is not convertible to float" };
     }
@@ -223,15 +282,15 @@ DbErrorOr<std::string> Value::to_string() const {
     case Type::Null:
         return "null";
     case Type::Int:
-        return std::to_string(std::get<int>(*this));
+        return std::to_string(int_value());
     case Type::Float:
-        return std::to_string(std::get<float>(*this));
+        return std::to_string(float_value());
     case Type::Varchar:
-        return std::get<std::string>(*this);
+        return std::string { varchar_value() };
     case Type::Bool:
-        return std::get<bool>(*this) ? "true" : "false";
+        return bool_value() ? "true" : "false";
     case Type::Time: {
-        auto time_point = std::get<Date>(*this);
+        auto time_point = time_value();
         return fmt::format("{:04}-{:02}-{:02} {:02}:{:02}:{:02}", time_point.year, time_point.month, time_point.day, time_point.hour, time_point.min, time_point.sec);
     }
     }
@@ -246,7 +305,7 @@ DbErrorOr<Date> Value::to_time() const {
     if (type() != Type::Time) {
         return DbError { "Cannot convert value to time" };
     }
-    return std::get<Date>(*this);
+    return time_value();
 }
 
 std::string Value::to_debug_string() const {
@@ -278,7 +337,7 @@ std::string Value::to_sql_serialized_string() const {
     case Type::Time:
         return MUST(to_string());
     case Type::Varchar:
-        return Sql::Printing::escape_string_literal(std::get<std::string>(*this));
+        return Sql::Printing::escape_string_literal(std::string { varchar_value() });
     }
     ESSA_UNREACHABLE;
 }
@@ -309,7 +368,7 @@ DbErrorOr<Value> operator+(Value const& lhs, Value const& rhs) {
     case Value::Type::Varchar:
         return Value::create_varchar(TRY(lhs.to_string()) + TRY(rhs.to_string()));
     case Value::Type::Time: {
-        time_t time = std::get<Date>(lhs).to_utc_epoch();
+        time_t time = lhs.time_value().to_utc_epoch();
         time += TRY(rhs.to_int());
         return Value::create_time(Date::from_utc_epoch(time));
     }
@@ -332,7 +391,7 @@ DbErrorOr<Value> operator-(Value const& lhs, Value const& rhs) {
     case Value::Type::Varchar:
         return DbError { "No matching operator '-' for 'VARCHAR' type." };
     case Value::Type::Time: {
-        time_t time = std::get<Date>(lhs).to_utc_epoch();
+        time_t time = lhs.time_value().to_utc_epoch();
         time -= TRY(rhs.to_int());
         return Value::create_time(Date::from_utc_epoch(time));
     }
@@ -395,6 +454,10 @@ DbErrorOr<bool> operator<(Value const& lhs, Value const& rhs) {
     if (rhs.is_null())
         return false;
 
+    // Same as below, but without copying the strings.
+    if (lhs.type() == Value::Type::Varchar && rhs.type() == Value::Type::Varchar)
+        return lhs.varchar_value() < rhs.varchar_value();
+
     switch (lhs.type()) {
     case Value::Type::Bool:
         return TRY(lhs.to_bool()) < TRY(rhs.to_bool());
@@ -418,6 +481,9 @@ DbErrorOr<bool> operator<=(Value const& lhs, Value const& rhs) {
 }
 
 DbErrorOr<bool> operator==(Value const& lhs, Value const& rhs) {
+    if (lhs.type() == Value::Type::Varchar && rhs.type() == Value::Type::Varchar)
+        return lhs.varchar_value() == rhs.varchar_value();
+
     switch (lhs.type()) {
     case Value::Type::Bool:
         return TRY(lhs.to_bool()) == TRY(rhs.to_bool());
@@ -447,4 +513,53 @@ DbErrorOr<bool> operator!=(Value const& lhs, Value const& rhs) {
     return !TRY(lhs == rhs);
 }
 
+// Numbers (and times) are hashed and compared as doubles, which holds
+// every int exactly.
+static double hashed_number(Value const& value) {
+    switch (value.type()) {
+    case Value::Type::Int:
+        return value.int_value();
+    case Value::Type::Float:
+        return value.float_value();
+    case Value::Type::Bool:
+        return value.bool_value();
+    case Value::Type::Time:
+        return value.time_value().to_utc_epoch();
+    case Value::Type::Null:
+    case Value::Type::Varchar:
+        break;
+    }
+    ESSA_UNREACHABLE;
+}
+
+size_t ValueHash::operator()(Value const& value) const {
+    switch (value.type()) {
+    case Value::Type::Null:
+        return 0;
+    case Value::Type::Varchar:
+        return std::hash<std::string_view> {}(value.varchar_value());
+    default: {
+        auto number = hashed_number(value);
+        // -0 is equal to 0, and all NaNs are equal.
+        if (number == 0)
+            return std::hash<double> {}(0.0);
+        if (std::isnan(number))
+            return 1;
+        return std::hash<double> {}(number);
+    }
+    }
+}
+
+bool ValueEqual::operator()(Value const& lhs, Value const& rhs) const {
+    if (lhs.is_null() || rhs.is_null())
+        return lhs.is_null() && rhs.is_null();
+    bool lhs_is_varchar = lhs.type() == Value::Type::Varchar;
+    bool rhs_is_varchar = rhs.type() == Value::Type::Varchar;
+    if (lhs_is_varchar || rhs_is_varchar)
+        return lhs_is_varchar && rhs_is_varchar && lhs.varchar_value() == rhs.varchar_value();
+    auto lhs_number = hashed_number(lhs);
+    auto rhs_number = hashed_number(rhs);
+    return lhs_number == rhs_number || (std::isnan(lhs_number) && std::isnan(rhs_number));
+}
+
 }
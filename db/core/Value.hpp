@@ -1,10 +1,13 @@
 #pragma once
 
 #include "DbError.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <optional>
 #include <string>
-#include <variant>
+#include <string_view>
 
 namespace Db::Core {
 
@@ -25,11 +28,12 @@ struct Date {
     static DbErrorOr<Date> from_iso8601_string(std::string const& string);
 };
 
-using ValueBase = std::variant<std::monostate, int, float, std::string, bool, Date>;
-
-class Value : public ValueBase {
+// A tagged value, 16 bytes large. Strings up to 14 bytes are stored
+// inline; longer ones are immutable and shared (reference counted)
+// between copies, so copying a Value never allocates.
+class Value {
 public:
-    enum class Type {
+    enum class Type : uint8_t {
         Null,
         Int,
         Float,
@@ -71,6 +75,37 @@ public:
     }
 
     Value() = default;
+
+    Value(Value const& other) {
+        copy_from(other, true);
+    }
+
+    Value(Value&& other) noexcept {
+        copy_from(other, false);
+        other.m_type = Type::Null;
+    }
+
+    Value& operator=(Value const& other) {
+        if (this != &other) {
+            release();
+            copy_from(other, true);
+        }
+        return *this;
+    }
+
+    Value& operator=(Value&& other) noexcept {
+        if (this != &other) {
+            release();
+            copy_from(other, false);
+            other.m_type = Type::Null;
+        }
+        return *this;
+    }
+
+    ~Value() {
+        release();
+    }
+
     static DbErrorOr<Value> from_string(Type, std::string const&);
     static Value null();
     static Value create_int(int i);
@@ -88,6 +123,14 @@ public:
     Type type() const { return m_type; }
     bool is_null() const { return m_type == Value::Type::Null; }
 
+    // Unchecked access, the value must be of the given type. Unlike to_*(),
+    // these don't convert or copy anything.
+    int int_value() const { return load<int>(); }
+    float float_value() const { return load<float>(); }
+    bool bool_value() const { return load<bool>(); }
+    std::string_view varchar_value() const;
+    Date time_value() const;
+
     std::string to_debug_string() const;
     std::string to_sql_serialized_string() const;
 
@@ -95,13 +138,63 @@ public:
     friend std::ostream& operator<<(std::ostream& out, Value const&);
 
 private:
-    Value(auto value, Type type)
-        : ValueBase(std::move(value))
-        , m_type(type) { }
+    struct LongString {
+        std::atomic<uint32_t> ref_count;
+        uint32_t size;
+
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    static constexpr size_t InlineStringCapacity = 14;
+    // Stored in m_string_size when the string is a LongString.
+    static constexpr uint8_t LongStringSize = 0xff;
+
+    explicit Value(Type type)
+        : m_type(type) { }
 
+    template<class T>
+    T load() const {
+        static_assert(sizeof(T) <= sizeof(m_data));
+        T value;
+        std::memcpy(&value, m_data, sizeof(T));
+        return value;
+    }
+
+    template<class T>
+    void store(T value) {
+        static_assert(sizeof(T) <= sizeof(m_data));
+        std::memcpy(m_data, &value, sizeof(T));
+    }
+
+    LongString* long_string() const {
+        return m_type == Type::Varchar && m_string_size == LongStringSize ? load<LongString*>() : nullptr;
+    }
+    void copy_from(Value const& other, bool add_reference) {
+        std::memcpy(m_data, other.m_data, sizeof(m_data));
+        m_string_size = other.m_string_size;
+        m_type = other.m_type;
+        if (auto string = long_string(); string && add_reference) {
+            string->ref_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void release() {
+        if (auto string = long_string(); string && string->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            free_long_string(string);
+        }
+        m_type = Type::Null;
+    }
+
+    static void free_long_string(LongString*);
+
+    // Int, float, bool, packed date, inline string or LongString pointer.
+    alignas(8) char m_data[InlineStringCapacity] {};
+    uint8_t m_string_size = 0;
     Type m_type { Type::Null };
 };
 
+static_assert(sizeof(Value) == 16);
+
 DbErrorOr<Value> operator+(Value const& lhs, Value const& rhs);
 DbErrorOr<Value> operator-(Value const& lhs, Value const& rhs);
 DbErrorOr<Value> operator*(Value const& lhs, Value const& rhs);
@@ -126,4 +219,17 @@ public:
     }
 };
 
+// Hash and equality of values for hash tables (e.g. of groups). Unlike
+// operator==, they never fail: NULLs are equal to each other, NaNs are
+// too, and numbers of any type are compared by their value.
+class ValueHash {
+public:
+    size_t operator()(Value const&) const;
+};
+
+class ValueEqual {
+public:
+    bool operator()(Value const&, Value const&) const;
+};
+
 }
@@ -80,6 +80,7 @@ std::vector<Token> Lexer::lex() {
                 { "IMPORT", Token::Type::KeywordImport },
                 { "IF", Token::Type::KeywordIf },
                 { "IN", Token::Type::KeywordIn },
+                { "INDEX", Token::Type::KeywordIndex },
                 { "INNER", Token::Type::KeywordInner },
                 { "INSERT", Token::Type::KeywordInsert },
                 { "INTO", Token::Type::KeywordInto },
@@ -35,6 +35,7 @@ struct Token {
         KeywordImport,
         KeywordIf,
         KeywordIn,
+        KeywordIndex,
         KeywordInner,
         KeywordInsert,
         KeywordInto,
@@ -88,12 +88,16 @@ SQLErrorOr<std::unique_ptr<AST::Statement>> Parser::parse_statement_impl() {
         auto what_to_create = m_tokens[m_offset + 1];
         if (what_to_create.type == Token::Type::KeywordTable)
             return TRY(parse_create_table());
+        if (what_to_create.type == Token::Type::KeywordIndex)
+            return TRY(parse_create_index());
         return expected("thing to create", what_to_create, m_offset + 1);
     }
     else if (keyword.type == Token::Type::KeywordDrop) {
         auto what_to_drop = m_tokens[m_offset + 1];
         if (what_to_drop.type == Token::Type::KeywordTable)
             return TRY(parse_drop_table());
+        if (what_to_drop.type == Token::Type::KeywordIndex)
+            return TRY(parse_drop_index());
         return expected("thing to drop", what_to_drop, m_offset + 1);
     }
     else if (keyword.type == Token::Type::KeywordTruncate) {
@@ -839,6 +843,67 @@ SQLErrorOr<std::unique_ptr<AST::AlterTable>> Parser::parse_alter_table() {
         std::move(constraint_to_add), std::move(constraint_to_alter), std::move(constraint_to_drop));
 }
 
+SQLErrorOr<std::unique_ptr<AST::CreateIndex>> Parser::parse_create_index() {
+    auto start = m_offset;
+    m_offset += 2; // CREATE INDEX
+
+    auto index_name = m_tokens[m_offset++];
+    if (index_name.type != Token::Type::Identifier)
+        return expected("index name", index_name, m_offset - 1);
+
+    auto on = m_tokens[m_offset++];
+    if (on.type != Token::Type::KeywordOn)
+        return expected("'ON' after index name", on, m_offset - 1);
+
+    auto table_name = m_tokens[m_offset++];
+    if (table_name.type != Token::Type::Identifier)
+        return expected("table name", table_name, m_offset - 1);
+
+    auto paren_open = m_tokens[m_offset++];
+    if (paren_open.type != Token::Type::ParenOpen)
+        return expected("'(' to open column list", paren_open, m_offset - 1);
+
+    std::vector<std::string> columns;
+    while (true) {
+        auto name = m_tokens[m_offset++];
+        if (name.type != Token::Type::Identifier)
+            return expected("column name", name, m_offset - 1);
+
+        columns.push_back(name.value);
+
+        auto comma = m_tokens[m_offset];
+        if (comma.type != Token::Type::Comma)
+            break;
+        m_offset++;
+    }
+
+    auto paren_close = m_tokens[m_offset++];
+    if (paren_close.type != Token::Type::ParenClose)
+        return expected("')' to close column list", paren_close, m_offset - 1);
+
+    return std::make_unique<AST::CreateIndex>(start, index_name.value, table_name.value, std::move(columns));
+}
+
+SQLErrorOr<std::unique_ptr<AST::DropIndex>> Parser::parse_drop_index() {
+    auto start = m_offset;
+    m_offset += 2; // DROP INDEX
+
+    auto index_name = m_tokens[m_offset++];
+    if (index_name.type != Token::Type::Identifier)
+        return expected("index name", index_name, m_offset - 1);
+
+    // Index names are local to tables.
+    auto on = m_tokens[m_offset++];
+    if (on.type != Token::Type::KeywordOn)
+        return expected("'ON' after index name", on, m_offset - 1);
+
+    auto table_name = m_tokens[m_offset++];
+    if (table_name.type != Token::Type::Identifier)
+        return expected("table name", table_name, m_offset - 1);
+
+    return std::make_unique<AST::DropIndex>(start, index_name.value, table_name.value);
+}
+
 SQLErrorOr<std::unique_ptr<AST::InsertInto>> Parser::parse_insert_into() {
     auto start = m_offset;
     m_offset += 2; // INSERT INTO
@@ -1043,8 +1108,11 @@ SQLErrorOr<std::optional<Core::DatabaseEngine>> Parser::parse_engine_specificati
             else if (compare_case_insensitive(engine_identifier.value, "MEMORY")) {
                 return Core::DatabaseEngine::Memory;
             }
+            else if (compare_case_insensitive(engine_identifier.value, "COLUMNAR")) {
+                return Core::DatabaseEngine::Columnar;
+            }
             else {
-                return SQLError { "Invalid database engine, expected 'EDB' or 'MEMORY'", m_offset - 1 };
+                return SQLError { "Invalid database engine, expected 'EDB', 'MEMORY' or 'COLUMNAR'", m_offset - 1 };
             }
         }
         else {
@@ -1431,7 +1499,11 @@ SQLErrorOr<std::unique_ptr<AST::Expression>> Parser::parse_function(std::string
     if (aggregate_function != AST::AggregateFunction::Function::Invalid) {
         // Aggregate function
         m_offset++; // (
-        auto expression = TRY(parse_expression());
+        std::unique_ptr<AST::Expression> expression;
+        if (aggregate_function == AST::AggregateFunction::Function::Count && m_tokens[m_offset].type == Token::Type::Asterisk)
+            m_offset++; // COUNT(*)
+        else
+            expression = TRY(parse_expression());
 
         if (m_tokens[m_offset++].type != Token::Type::ParenClose)
             return expected("')' to close aggregate function", m_tokens[m_offset], m_offset - 1);
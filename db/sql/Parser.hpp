@@ -34,6 +34,8 @@ private:
     SQLErrorOr<std::unique_ptr<AST::DropTable>> parse_drop_table();
     SQLErrorOr<std::unique_ptr<AST::TruncateTable>> parse_truncate_table();
     SQLErrorOr<std::unique_ptr<AST::AlterTable>> parse_alter_table();
+    SQLErrorOr<std::unique_ptr<AST::CreateIndex>> parse_create_index();
+    SQLErrorOr<std::unique_ptr<AST::DropIndex>> parse_drop_index();
     SQLErrorOr<std::unique_ptr<AST::InsertInto>> parse_insert_into();
     SQLErrorOr<std::unique_ptr<AST::DeleteFrom>> parse_delete_from();
     SQLErrorOr<std::unique_ptr<AST::Update>> parse_update();
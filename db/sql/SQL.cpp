@@ -21,11 +21,20 @@ SQLErrorOr<Core::ValueOrResultSet> run_query(Core::Database& db, std::string con
     // }
 
     auto statement = TRY(Db::Sql::Parser::parse_statement(tokens));
-    auto result = TRY(statement->execute(db));
+    auto result = statement->execute(db);
+    TRY(commit(db));
     // result.repl_dump(std::cerr);
     return result;
 }
 
+SQLErrorOr<void> commit(Core::Database& db) {
+    auto result = db.commit();
+    if (result.is_error()) {
+        return SQLError { fmt::format("Commit failed: {}", result.release_error()), 0 };
+    }
+    return {};
+}
+
 void display_error(SQLError const& error, ssize_t error_start, ssize_t error_end, std::string const& query) {
     Util::ReadableMemoryStream stream { { reinterpret_cast<uint8_t const*>(query.c_str()), query.size() } };
     Util::display_error(stream,
@@ -7,6 +7,10 @@
 namespace Db::Sql {
 
 SQLErrorOr<Core::ValueOrResultSet> run_query(Core::Database&, std::string const&);
+
+// Must be called after every statement, even a failed one (there are no
+// rollbacks, so whatever it did is kept).
+SQLErrorOr<void> commit(Core::Database&);
 void display_error(SQLError const& error, ssize_t error_start, ssize_t error_end, std::string const& query);
 
 }
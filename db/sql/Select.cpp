@@ -2,15 +2,21 @@
 
 #include <EssaUtil/Is.hpp>
 #include <EssaUtil/ScopeGuard.hpp>
+#include <algorithm>
 #include <cstddef>
 #include <db/core/Database.hpp>
 #include <db/core/DbError.hpp>
+#include <db/core/SortKey.hpp>
 #include <db/core/Table.hpp>
 #include <db/core/Tuple.hpp>
 #include <db/core/Value.hpp>
 #include <db/sql/Printing.hpp>
 #include <db/sql/SQLError.hpp>
+#include <db/sql/ast/Function.hpp>
 #include <memory>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace Db::Sql::AST {
 
@@ -41,12 +47,17 @@ SQLErrorOr<Core::ResultSet> Select::execute(EvaluationContext& context) const {
     auto& frame = context.frames.emplace_back(m_options.from.get(), columns);
     Util::ScopeGuard guard { [&] { context.frames.pop_back(); } };
 
+    bool rows_are_ordered = false;
     auto rows = TRY([&]() -> SQLErrorOr<std::vector<Core::TupleWithSource>> {
         if (m_options.from) {
             // SELECT etc.
-            // TODO: Make use of iterator capabilities of this instead of
-            //       reading everything into memory.
-            return collect_rows(context, *relation);
+            // TODO: Return rows through an iterator too, so that the result
+            //       doesn't need to be stored.
+            if (auto scan = plan_index_scan(context)) {
+                rows_are_ordered = scan->is_ordered;
+                return collect_rows(context, *relation, std::move(scan->rows), rows_are_ordered);
+            }
+            return collect_rows(context, *relation, relation->rows(), rows_are_ordered);
         }
 
         std::vector<Core::Value> values;
@@ -60,63 +71,48 @@ SQLErrorOr<Core::ResultSet> Select::execute(EvaluationContext& context) const {
 
     // DISTINCT
     if (m_options.distinct) {
-        std::vector<Core::TupleWithSource> occurences;
-
-        // FIXME: O(n^2)
-        for (const auto& row : rows) {
-            bool distinct = true;
-            for (const auto& to_compare : occurences) {
-                if (TRY((row == to_compare).map_error(DbToSQLError { m_start }))) {
-                    distinct = false;
-                    break;
-                }
-            }
-
-            if (distinct)
-                occurences.push_back(row);
+        // The first of equal rows is kept.
+        std::unordered_set<Core::Tuple, Core::TupleHash, Core::TupleEqual> seen_rows;
+        std::vector<Core::TupleWithSource> distinct_rows;
+        for (auto& row : rows) {
+            if (seen_rows.insert(row.tuple).second)
+                distinct_rows.push_back(std::move(row));
         }
 
-        rows = std::move(occurences);
+        rows = std::move(distinct_rows);
     }
 
     // ORDER BY
-    if (m_options.order_by) {
-        auto generate_tuple_pair_for_ordering = [&](Core::TupleWithSource const& lhs, Core::TupleWithSource const& rhs) -> SQLErrorOr<std::pair<Core::Tuple, Core::Tuple>> {
-            std::vector<Core::Value> lhs_values;
-            std::vector<Core::Value> rhs_values;
-
-            for (auto const& column : m_options.order_by->columns) {
-                frame.row = lhs;
-                auto lhs_value = TRY(column.expression->evaluate(context));
-                frame.row = rhs;
-                auto rhs_value = TRY(column.expression->evaluate(context));
-
-                if (column.order == OrderBy::Order::Ascending) {
-                    lhs_values.push_back(std::move(lhs_value));
-                    rhs_values.push_back(std::move(rhs_value));
-                }
-                else {
-                    lhs_values.push_back(std::move(rhs_value));
-                    rhs_values.push_back(std::move(lhs_value));
-                }
-            }
+    if (m_options.order_by && !rows_are_ordered) {
+        // Sort keys are evaluated once per row, and encoded so that they
+        // are compared as bytes.
+        std::vector<std::string> sort_keys;
+        sort_keys.reserve(rows.size());
+        for (auto& row : rows) {
+            // Moved to the frame and back, so that it isn't copied.
+            frame.row = std::move(row);
+            sort_keys.push_back(TRY(sort_key(context)));
+            row = std::move(frame.row);
+        }
 
-            return std::pair<Core::Tuple, Core::Tuple> { Core::Tuple { lhs_values }, Core::Tuple { rhs_values } };
-        };
+        // Equal keys are ordered by position, so that sorting is stable.
+        std::vector<size_t> order(rows.size());
+        std::iota(order.begin(), order.end(), 0);
+        auto is_before = [&](size_t lhs, size_t rhs) { return std::tie(sort_keys[lhs], lhs) < std::tie(sort_keys[rhs], rhs); };
+        if (m_options.top && m_options.top->unit == Top::Unit::Val && m_options.top->value < order.size()) {
+            // Only the first rows are needed.
+            std::partial_sort(order.begin(), order.begin() + m_options.top->value, order.end(), is_before);
+            order.resize(m_options.top->value);
+        }
+        else {
+            std::sort(order.begin(), order.end(), is_before);
+        }
 
-        std::optional<SQLError> error;
-        std::stable_sort(rows.begin(), rows.end(), [&](Core::TupleWithSource const& lhs, Core::TupleWithSource const& rhs) -> bool {
-            auto pair = generate_tuple_pair_for_ordering(lhs, rhs);
-            if (pair.is_error()) {
-                error = pair.release_error();
-                return false;
-            }
-            auto [lhs_value, rhs_value] = pair.release_value();
-            // std::cout << lhs_value << " < " << rhs_value << std::endl;
-            return lhs_value < rhs_value;
-        });
-        if (error)
-            return *error;
+        std::vector<Core::TupleWithSource> sorted_rows;
+        sorted_rows.reserve(rows.size());
+        for (auto index : order)
+            sorted_rows.push_back(std::move(rows[index]));
+        rows = std::move(sorted_rows);
     }
 
     if (m_options.top) {
@@ -138,7 +134,8 @@ SQLErrorOr<Core::ResultSet> Select::execute(EvaluationContext& context) const {
     }
 
     std::vector<Core::Tuple> output_rows;
-    for (auto const& row : rows)
+    output_rows.reserve(rows.size());
+    for (auto& row : rows)
         output_rows.push_back(std::move(row.tuple));
 
     Core::ResultSet result { column_names, std::move(output_rows) };
@@ -152,45 +149,391 @@ SQLErrorOr<Core::ResultSet> Select::execute(EvaluationContext& context) const {
     return result;
 }
 
-SQLErrorOr<std::vector<Core::TupleWithSource>> Select::collect_rows(EvaluationContext& context, Core::Relation& table) const {
-    auto& frame = context.current_frame();
+static void collect_conjuncts(Expression const& expression, std::vector<Expression const*>& conjuncts) {
+    auto binary_operator = dynamic_cast<BinaryOperator const*>(&expression);
+    if (binary_operator && binary_operator->operation() == BinaryOperator::Operation::And) {
+        collect_conjuncts(binary_operator->lhs(), conjuncts);
+        collect_conjuncts(*binary_operator->rhs(), conjuncts);
+        return;
+    }
+    conjuncts.push_back(&expression);
+}
 
-    auto should_include_row = [&](Core::Tuple const& row) -> SQLErrorOr<bool> {
-        if (!m_options.where)
-            return true;
-        frame.row = { .tuple = row, .source = {} };
-        return TRY(m_options.where->evaluate(context)).to_bool().map_error(DbToSQLError { m_start });
-    };
+static std::optional<Core::Value> literal_value(Expression const& expression) {
+    auto literal = dynamic_cast<Literal const*>(&expression);
+    if (!literal) {
+        return {};
+    }
+    return literal->value();
+}
 
-    // Collect all rows that should be included (applying WHERE and GROUP BY)
-    // There rows are not yet SELECT'ed - they contain columns from table, no aliases etc.
-    std::map<Core::Tuple, std::vector<Core::Tuple>> nonaggregated_row_groups;
+std::optional<Select::IndexScan> Select::plan_index_scan(EvaluationContext& context) const {
+    auto table_identifier = dynamic_cast<TableIdentifier const*>(m_options.from.get());
+    if (!context.db || !table_identifier) {
+        return {};
+    }
+    auto maybe_table = context.db->table(table_identifier->id());
+    if (maybe_table.is_error()) {
+        return {};
+    }
+    auto from_table = maybe_table.release_value();
 
-    TRY(table.rows().try_for_each_row([&](Core::Tuple const& row) -> SQLErrorOr<void> {
-        // WHERE
-        if (!TRY(should_include_row(row)))
+    // Column of the FROM table that `expression` refers to.
+    auto column_of = [&](Expression const& expression) -> std::optional<size_t> {
+        if (auto index_expression = dynamic_cast<IndexExpression const*>(&expression)) {
+            // Columns of SELECT *.
+            return index_expression->index();
+        }
+        auto identifier = dynamic_cast<Identifier const*>(&expression);
+        if (!identifier) {
             return {};
+        }
+        auto column = m_options.from->resolve_identifier(context.db, *identifier);
+        if (column.is_error()) {
+            return {};
+        }
+        return column.release_value();
+    };
 
-        std::vector<Core::Value> group_key;
+    std::vector<Expression const*> conjuncts;
+    if (m_options.where) {
+        collect_conjuncts(*m_options.where, conjuncts);
+    }
+
+    auto table = dynamic_cast<Core::MemoryBackedTable const*>(from_table);
+    if (!table) {
+        // Other engines can only look up rows equal to a value. They index
+        // just PRIMARY KEY and UNIQUE columns, so at most one row is found,
+        // and its order doesn't matter.
+        for (auto const* conjunct : conjuncts) {
+            auto binary_operator = dynamic_cast<BinaryOperator const*>(conjunct);
+            if (!binary_operator || binary_operator->operation() != BinaryOperator::Operation::Equal || !binary_operator->rhs()) {
+                continue;
+            }
+            auto column = column_of(binary_operator->lhs());
+            auto value = literal_value(*binary_operator->rhs());
+            if (!column || !value) {
+                column = column_of(*binary_operator->rhs());
+                value = literal_value(binary_operator->lhs());
+            }
+            if (!column || !value) {
+                continue;
+            }
+            if (auto rows = from_table->rows_with_value(*column, *value)) {
+                return IndexScan { .rows = std::move(*rows), .is_ordered = false };
+            }
+        }
+        return {};
+    }
+    if (table->ordered_indexes().empty()) {
+        return {};
+    }
+
+    auto index_for = [&](size_t column, std::vector<Core::Value> const& values) -> Core::OrderedIndex const* {
+        for (auto const& index : table->ordered_indexes()) {
+            if (index.columns()[0] == column && std::ranges::all_of(values, [&](auto const& value) { return index.can_compare_first_column(value); })) {
+                return &index;
+            }
+        }
+        return nullptr;
+    };
+
+    // A condition on the first column of an index which all rows matching
+    // WHERE satisfy. WHERE is still evaluated on every row found.
+    struct IndexCondition {
+        Core::OrderedIndex const* index = nullptr;
+        std::optional<Core::OrderedIndex::Bound> lower;
+        std::optional<Core::OrderedIndex::Bound> upper;
+        // For IN, rows equal to any of the values instead.
+        std::optional<std::vector<Core::Value>> values;
+    };
+
+    auto condition_for = [&](Expression const& expression) -> std::optional<IndexCondition> {
+        using Operation = BinaryOperator::Operation;
+        if (auto binary_operator = dynamic_cast<BinaryOperator const*>(&expression)) {
+            if (!binary_operator->rhs()) {
+                return {};
+            }
+            auto operation = binary_operator->operation();
+            auto column = column_of(binary_operator->lhs());
+            auto value = literal_value(*binary_operator->rhs());
+            if (!column || !value) {
+                // `value op column`
+                column = column_of(*binary_operator->rhs());
+                value = literal_value(binary_operator->lhs());
+                switch (operation) {
+                case Operation::Less:
+                    operation = Operation::Greater;
+                    break;
+                case Operation::LessEqual:
+                    operation = Operation::GreaterEqual;
+                    break;
+                case Operation::Greater:
+                    operation = Operation::Less;
+                    break;
+                case Operation::GreaterEqual:
+                    operation = Operation::LessEqual;
+                    break;
+                default:
+                    break;
+                }
+            }
+            if (!column || !value) {
+                return {};
+            }
+            auto index = index_for(*column, { *value });
+            if (!index) {
+                return {};
+            }
+            switch (operation) {
+            case Operation::Equal:
+                return IndexCondition { .index = index, .lower = { { *value, true } }, .upper = { { *value, true } }, .values = {} };
+            case Operation::Less:
+                return IndexCondition { .index = index, .lower = {}, .upper = { { *value, false } }, .values = {} };
+            case Operation::LessEqual:
+                return IndexCondition { .index = index, .lower = {}, .upper = { { *value, true } }, .values = {} };
+            case Operation::Greater:
+                return IndexCondition { .index = index, .lower = { { *value, false } }, .upper = {}, .values = {} };
+            case Operation::GreaterEqual:
+                return IndexCondition { .index = index, .lower = { { *value, true } }, .upper = {}, .values = {} };
+            default:
+                return {};
+            }
+        }
+        if (auto between = dynamic_cast<BetweenExpression const*>(&expression)) {
+            auto column = column_of(between->lhs());
+            auto min = literal_value(between->min());
+            auto max = literal_value(between->max());
+            if (!column || !min || !max) {
+                return {};
+            }
+            auto index = index_for(*column, { *min, *max });
+            if (!index) {
+                return {};
+            }
+            return IndexCondition { .index = index, .lower = { { *min, true } }, .upper = { { *max, true } }, .values = {} };
+        }
+        if (auto in = dynamic_cast<InExpression const*>(&expression)) {
+            auto column = column_of(in->lhs());
+            if (!column) {
+                return {};
+            }
+            // IN compares string forms of values, which are equal only for
+            // equal values of these types.
+            auto type = table->columns()[*column].type();
+            if (type != Core::Value::Type::Int && type != Core::Value::Type::Varchar && type != Core::Value::Type::Bool) {
+                return {};
+            }
+            std::vector<Core::Value> values;
+            for (auto const& arg : in->args()) {
+                auto value = literal_value(*arg);
+                if (!value) {
+                    return {};
+                }
+                values.push_back(std::move(*value));
+            }
+            auto index = index_for(*column, values);
+            if (!index) {
+                return {};
+            }
+            return IndexCondition { .index = index, .lower = {}, .upper = {}, .values = std::move(values) };
+        }
+        return {};
+    };
 
-        if (m_options.group_by) {
-            for (const auto& column_name : m_options.group_by->columns) {
-                // TODO: Handle aliases, indexes ("GROUP BY 1") and aggregate functions ("GROUP BY COUNT(x)")
-                // https://docs.microsoft.com/en-us/sql/t-sql/queries/select-transact-sql?view=sql-server-ver16#g-using-group-by-with-an-expression
-                auto column = table.get_column(column_name);
-                if (!column) {
-                    if (m_options.group_by->type == GroupBy::GroupOrPartition::GROUP)
-                        return SQLError { "Nonexistent column used in GROUP BY: '" + column_name + "'", m_start };
-                    else if (m_options.group_by->type == GroupBy::GroupOrPartition::PARTITION)
-                        return SQLError { "Nonexistent column used in PARTITION BY: '" + column_name + "'", m_start };
+    std::optional<IndexCondition> condition;
+    for (auto const* conjunct : conjuncts) {
+        condition = condition_for(*conjunct);
+        if (condition) {
+            break;
+        }
+    }
+
+    // Rows can be read in index order instead of sorting them, if ORDER BY
+    // lists exactly the columns of the index, ascending.
+    auto order_by_index = [&]() -> Core::OrderedIndex const* {
+        if (!m_options.order_by || m_options.group_by) {
+            return nullptr;
+        }
+        auto const& select_columns = context.current_frame().columns;
+        for (auto const& column : select_columns.columns()) {
+            if (column.column->contains_aggregate_function()) {
+                return nullptr;
+            }
+        }
+        std::vector<size_t> columns;
+        for (auto const& column : m_options.order_by->columns) {
+            auto identifier = dynamic_cast<Identifier const*>(column.expression.get());
+            if (column.order != OrderBy::Order::Ascending || !identifier) {
+                return nullptr;
+            }
+            auto table_column = column_of(*identifier);
+            if (!table_column) {
+                return nullptr;
+            }
+            // ORDER BY resolves aliases of SELECT columns first.
+            if (!identifier->table()) {
+                auto alias = select_columns.resolve_alias(identifier->id());
+                if (alias && column_of(alias->column) != table_column) {
+                    return nullptr;
                 }
-                group_key.push_back(row.value(column->index));
             }
+            columns.push_back(*table_column);
         }
+        for (auto const& index : table->ordered_indexes()) {
+            if (index.columns() == columns && !index.has_unordered_rows()) {
+                return &index;
+            }
+        }
+        return nullptr;
+    }();
 
-        nonaggregated_row_groups[{ group_key }].push_back(row);
+    std::vector<size_t> slots;
+    if (order_by_index && (!condition || (condition->index == order_by_index && !condition->values))) {
+        if (condition) {
+            order_by_index->find_range(condition->lower, condition->upper, slots);
+        }
+        else {
+            order_by_index->find_range({}, {}, slots);
+        }
+        return IndexScan { .rows = table->rows_in_slots(std::move(slots)), .is_ordered = true };
+    }
+
+    if (!condition) {
         return {};
-    }));
+    }
+
+    if (condition->values) {
+        for (auto const& value : *condition->values) {
+            Core::OrderedIndex::Bound bound { value, true };
+            condition->index->find_range(bound, bound, slots);
+        }
+    }
+    else {
+        condition->index->find_range(condition->lower, condition->upper, slots);
+    }
+    // Read rows in table order, as without an index.
+    std::ranges::sort(slots);
+    auto duplicates = std::ranges::unique(slots);
+    slots.erase(duplicates.begin(), duplicates.end());
+    return IndexScan { .rows = table->rows_in_slots(std::move(slots)), .is_ordered = false };
+}
+
+SQLErrorOr<std::string> Select::sort_key(EvaluationContext& context) const {
+    std::string key;
+    for (auto const& column : m_options.order_by->columns) {
+        Core::append_sort_key(key, TRY(column.expression->evaluate(context)), column.order == OrderBy::Order::Descending);
+    }
+    return key;
+}
+
+SQLErrorOr<std::vector<Core::TupleWithSource>> Select::collect_ungrouped_rows(EvaluationContext& context, Core::Relation& table, Core::RelationIterator rows, bool& rows_are_ordered) const {
+    auto& frame = context.current_frame();
+
+    // ORDER BY may refer to columns of the table.
+    bool keep_source = m_options.order_by.has_value();
+
+    // TOP without DISTINCT takes the first rows, so if they are read in
+    // ORDER BY order, the rest doesn't need to be read at all. Otherwise,
+    // only the best rows seen so far are kept (top-K).
+    std::optional<size_t> limit;
+    std::optional<size_t> top_k;
+    if (m_options.top && m_options.top->unit == Top::Unit::Val && !m_options.distinct) {
+        if (!m_options.order_by || rows_are_ordered || m_options.top->value == 0)
+            limit = m_options.top->value;
+        else
+            top_k = m_options.top->value;
+    }
+
+    // Max-heap of the best rows by (sort key, position), so that the worst
+    // one is on top. The position keeps the order of equal rows.
+    struct Candidate {
+        std::string key;
+        size_t position;
+        Core::TupleWithSource row;
+    };
+    auto is_better = [](Candidate const& lhs, Candidate const& rhs) {
+        return std::tie(lhs.key, lhs.position) < std::tie(rhs.key, rhs.position);
+    };
+    std::vector<Candidate> candidates;
+    size_t position = 0;
+
+    auto add_candidate = [&](Core::TupleWithSource row) -> SQLErrorOr<void> {
+        // ORDER BY is evaluated like for result rows.
+        frame.row = std::move(row);
+        frame.row_type = EvaluationContextFrame::RowType::FromResultSet;
+        auto key = sort_key(context);
+        frame.row_type = EvaluationContextFrame::RowType::FromTable;
+        Candidate candidate { .key = TRY(std::move(key)), .position = position++, .row = std::move(frame.row) };
+
+        if (candidates.size() < *top_k) {
+            candidates.push_back(std::move(candidate));
+            std::push_heap(candidates.begin(), candidates.end(), is_better);
+        }
+        else if (is_better(candidate, candidates.front())) {
+            std::pop_heap(candidates.begin(), candidates.end(), is_better);
+            candidates.back() = std::move(candidate);
+            std::push_heap(candidates.begin(), candidates.end(), is_better);
+        }
+        return {};
+    };
+
+    std::vector<Core::TupleWithSource> output_rows;
+    size_t row_count = 0;
+    while (!limit || output_rows.size() < *limit) {
+        auto const& batch = rows.next_batch();
+        if (batch.empty())
+            break;
+        row_count += batch.size();
+
+        for (auto const& row : batch) {
+            frame.row = { .tuple = row, .source = {} };
+
+            // WHERE
+            if (m_options.where && !TRY(TRY(m_options.where->evaluate(context)).to_bool().map_error(DbToSQLError { m_start })))
+                continue;
+
+            // SELECT
+            std::vector<Core::Value> values;
+            values.reserve(frame.columns.columns().size());
+            for (auto const& column : frame.columns.columns()) {
+                values.push_back(TRY(column.column->evaluate(context)));
+            }
+            Core::TupleWithSource output_row { .tuple = Core::Tuple { std::move(values) }, .source = keep_source ? std::optional { row } : std::nullopt };
+            if (top_k)
+                TRY(add_candidate(std::move(output_row)));
+            else
+                output_rows.push_back(std::move(output_row));
+
+            // TOP
+            if (limit && output_rows.size() == *limit)
+                break;
+        }
+    }
+
+    if (row_count == 0 && table.size() == 0) {
+        // Check column expressions for validity, even if they won't run
+        // on real rows.
+        Core::Tuple dummy_row { std::vector<Core::Value>(table.columns().size(), Core::Value::null()) };
+        frame.row = { .tuple = dummy_row, .source = {} };
+        for (auto const& column : frame.columns.columns()) {
+            TRY(column.column->evaluate(context));
+        }
+    }
+
+    if (top_k) {
+        std::sort_heap(candidates.begin(), candidates.end(), is_better);
+        output_rows.reserve(candidates.size());
+        for (auto& candidate : candidates)
+            output_rows.push_back(std::move(candidate.row));
+        rows_are_ordered = true;
+    }
+
+    return output_rows;
+}
+
+SQLErrorOr<std::vector<Core::TupleWithSource>> Select::collect_rows(EvaluationContext& context, Core::Relation& table, Core::RelationIterator rows, bool& rows_are_ordered) const {
+    auto& frame = context.current_frame();
 
     // Check if grouping / aggregation should be performed
     bool should_group = false;
@@ -206,35 +549,182 @@ SQLErrorOr<std::vector<Core::TupleWithSource>> Select::collect_rows(EvaluationCo
         }
     }
 
-    if (m_options.group_by->type == GroupBy::GroupOrPartition::PARTITION)
+    // Only grouping (and partitioning) needs all rows before evaluating
+    // SELECT columns.
+    if (!should_group)
+        return collect_ungrouped_rows(context, table, std::move(rows), rows_are_ordered);
+
+    if (m_options.group_by && m_options.group_by->type == GroupBy::GroupOrPartition::PARTITION)
         should_group = false;
 
-    // Special-case for empty sets
-    if (table.size() == 0) {
-        if (should_group) {
-            // We need to create at least one group to make aggregate
-            // functions return one row with value "0".
-            nonaggregated_row_groups.insert({ Core::Tuple {}, {} });
+    auto should_include_row = [&](Core::Tuple const& row) -> SQLErrorOr<bool> {
+        if (!m_options.where)
+            return true;
+        frame.row = { .tuple = row, .source = {} };
+        return TRY(m_options.where->evaluate(context)).to_bool().map_error(DbToSQLError { m_start });
+    };
+
+    std::vector<size_t> group_key_columns;
+    if (m_options.group_by) {
+        for (const auto& column_name : m_options.group_by->columns) {
+            // TODO: Handle aliases, indexes ("GROUP BY 1") and aggregate functions ("GROUP BY COUNT(x)")
+            // https://docs.microsoft.com/en-us/sql/t-sql/queries/select-transact-sql?view=sql-server-ver16#g-using-group-by-with-an-expression
+            auto column = table.get_column(column_name);
+            if (!column) {
+                if (m_options.group_by->type == GroupBy::GroupOrPartition::GROUP)
+                    return SQLError { "Nonexistent column used in GROUP BY: '" + column_name + "'", m_start };
+                else if (m_options.group_by->type == GroupBy::GroupOrPartition::PARTITION)
+                    return SQLError { "Nonexistent column used in PARTITION BY: '" + column_name + "'", m_start };
+            }
+            group_key_columns.push_back(column->index);
         }
+    }
 
-        // Let's also check column expressions for validity, even
-        // if they won't run on real rows.
+    // Aggregate functions are computed while reading rows, so that rows
+    // of a group don't need to be kept (except for PARTITION BY, which
+    // outputs every row).
+    std::vector<AggregateFunction const*> aggregate_functions;
+    auto collect_aggregate_functions = [&](Expression const& expression) {
+        std::vector<AggregateFunction const*> functions;
+        expression.collect_aggregate_functions(functions);
+        for (auto const* function : functions) {
+            if (std::find(aggregate_functions.begin(), aggregate_functions.end(), function) == aggregate_functions.end())
+                aggregate_functions.push_back(function);
+        }
+    };
+    for (auto const& column : frame.columns.columns()) {
+        collect_aggregate_functions(*column.column);
+    }
+    if (should_group && m_options.having) {
+        collect_aggregate_functions(*m_options.having);
+    }
+
+    struct Group {
+        Core::Tuple key;
+        Core::Tuple first_row;
+        std::vector<Core::Tuple> rows;
+        std::vector<AggregateFunction::State> states;
+        // Rows of the current batch are aggregated separately, and the
+        // result is merged into `states` after the batch.
+        std::vector<AggregateFunction::State> batch_states;
+    };
+    std::vector<Group> groups;
+    std::unordered_map<Core::Tuple, size_t, Core::TupleHash, Core::TupleEqual> group_indexes;
+    std::vector<size_t> groups_in_batch;
+
+    auto group_for = [&](Core::Tuple key, Core::Tuple const& first_row) -> size_t {
+        auto [it, inserted] = group_indexes.try_emplace(std::move(key), groups.size());
+        if (inserted) {
+            groups.push_back(Group { .key = it->first, .first_row = first_row, .rows = {}, .states = std::vector<AggregateFunction::State>(aggregate_functions.size()), .batch_states = {} });
+        }
+        return it->second;
+    };
+
+    // Apply WHERE and add rows to their groups. There rows are not yet
+    // SELECT'ed - they contain columns from table, no aliases etc.
+    auto collect_row = [&](Core::Tuple const& row) -> SQLErrorOr<void> {
+        // WHERE
+        if (!TRY(should_include_row(row)))
+            return {};
+
+        std::vector<Core::Value> group_key;
+        group_key.reserve(group_key_columns.size());
+        for (auto column : group_key_columns) {
+            group_key.push_back(row.value(column));
+        }
+
+        auto group_index = group_for(Core::Tuple { std::move(group_key) }, row);
+        auto& group = groups[group_index];
+        if (!should_group) {
+            group.rows.push_back(row);
+        }
+        if (group.batch_states.empty() && !aggregate_functions.empty()) {
+            group.batch_states.resize(aggregate_functions.size());
+            groups_in_batch.push_back(group_index);
+        }
+
+        frame.row = { .tuple = row, .source = {} };
+        for (size_t s = 0; s < aggregate_functions.size(); s++) {
+            TRY(aggregate_functions[s]->accumulate(context, group.batch_states[s]));
+        }
+        return {};
+    };
+
+    auto merge_batch_states = [&]() -> SQLErrorOr<void> {
+        for (auto group_index : groups_in_batch) {
+            auto& group = groups[group_index];
+            for (size_t s = 0; s < aggregate_functions.size(); s++) {
+                TRY(group.states[s].merge(group.batch_states[s]).map_error(DbToSQLError { m_start }));
+            }
+            group.batch_states.clear();
+        }
+        groups_in_batch.clear();
+        return {};
+    };
+
+    // COUNT(*) of all rows is the size of the relation, so rows don't
+    // need to be read if nothing else is computed from them.
+    bool only_counts_all_rows = !m_options.where && group_key_columns.empty() && !aggregate_functions.empty()
+        && std::all_of(aggregate_functions.begin(), aggregate_functions.end(), [](auto const* function) { return function->counts_all_rows(); });
+
+    frame.row_type = EvaluationContextFrame::RowType::FromTable;
+    size_t row_count = 0;
+    if (should_group && only_counts_all_rows) {
+        auto& group = groups[group_for(Core::Tuple {}, Core::Tuple {})];
+        for (auto& state : group.states) {
+            state.count = static_cast<int64_t>(table.size());
+        }
+    }
+    else {
+        TRY(rows.try_for_each_batch([&](Core::RowBatch const& batch) -> SQLErrorOr<void> {
+            row_count += batch.size();
+            for (auto const& row : batch) {
+                TRY(collect_row(row));
+            }
+            TRY(merge_batch_states());
+            return {};
+        }));
+    }
+
+    // Special-case for empty sets. The size of some relations (e.g. joins)
+    // is not known without reading them, so it's checked only if needed.
+    if (row_count == 0 && table.size() == 0) {
         std::vector<Core::Value> values;
         for (size_t s = 0; s < table.columns().size(); s++) {
             values.push_back(Core::Value::null());
         }
         Core::Tuple dummy_row { values };
+
+        if (should_group) {
+            // We need to create at least one group to make aggregate
+            // functions return one row with value "0".
+            group_for(Core::Tuple {}, dummy_row);
+        }
+
+        // Let's also check column expressions for validity, even
+        // if they won't run on real rows.
         frame.row_group = std::span { &dummy_row, 1 };
         for (auto const& column : m_options.columns.columns()) {
             frame.row = { .tuple = dummy_row, .source = {} };
             TRY(column.column->evaluate(context));
         }
+        frame.row_group = {};
     }
 
-    // std::cout << "should_group: " << should_group << std::endl;
-    // std::cout << "nonaggregated_row_groups.size(): " << nonaggregated_row_groups.size() << std::endl;
+    // Groups are output in order of their keys.
+    std::sort(groups.begin(), groups.end(), [](Group const& lhs, Group const& rhs) { return lhs.key < rhs.key; });
+
+    std::vector<std::pair<Expression const*, Core::Value>> aggregate_values;
+    Util::ScopeGuard aggregate_values_guard { [&] { frame.aggregate_values = nullptr; } };
+    auto set_aggregate_values = [&](Group const& group) {
+        aggregate_values.clear();
+        for (size_t s = 0; s < aggregate_functions.size(); s++) {
+            aggregate_values.emplace_back(aggregate_functions[s], aggregate_functions[s]->result(group.states[s]));
+        }
+        frame.aggregate_values = &aggregate_values;
+    };
 
-    // Group + aggregate rows if needed, otherwise just evaluate column expressions
+    // Evaluate column expressions, using computed values of aggregate functions
     std::vector<Core::TupleWithSource> aggregated_rows;
     if (should_group) {
         auto should_include_group = [&](EvaluationContext& context, Core::TupleWithSource const& row) -> SQLErrorOr<bool> {
@@ -255,9 +745,9 @@ SQLErrorOr<std::vector<Core::TupleWithSource>> Select::collect_rows(EvaluationCo
             return false;
         };
 
-        for (auto const& group : nonaggregated_row_groups) {
+        for (auto const& group : groups) {
             frame.row_type = EvaluationContextFrame::RowType::FromTable;
-            frame.row_group = group.second;
+            set_aggregate_values(group);
             std::vector<Core::Value> values;
             for (auto& column : frame.columns.columns()) {
                 if (column.column->contains_aggregate_function()) {
@@ -265,7 +755,7 @@ SQLErrorOr<std::vector<Core::TupleWithSource>> Select::collect_rows(EvaluationCo
                     values.push_back(TRY(column.column->evaluate(context)));
                 }
                 else if (is_in_group_by(column)) {
-                    frame.row = { .tuple = group.second[0], .source = {} };
+                    frame.row = { .tuple = group.first_row, .source = {} };
                     values.push_back(TRY(column.column->evaluate(context)));
                 }
                 else {
@@ -287,10 +777,10 @@ SQLErrorOr<std::vector<Core::TupleWithSource>> Select::collect_rows(EvaluationCo
         }
     }
     else {
-        for (auto const& group : nonaggregated_row_groups) {
-            for (auto const& row : group.second) {
+        for (auto const& group : groups) {
+            set_aggregate_values(group);
+            for (auto const& row : group.rows) {
                 std::vector<Core::Value> values;
-                frame.row_group = group.second;
                 for (auto& column : frame.columns.columns()) {
                     frame.row = { .tuple = row, .source = row };
                     values.push_back(TRY(column.column->evaluate(context)));
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <db/core/Database.hpp>
+#include <db/core/Table.hpp>
 #include <db/sql/ast/Expression.hpp>
 #include <db/sql/ast/TableExpression.hpp>
 #include <memory>
@@ -74,7 +75,24 @@ public:
     std::string to_string() const;
 
 private:
-    SQLErrorOr<std::vector<Core::TupleWithSource>> collect_rows(EvaluationContext&, Core::Relation&) const;
+    // Rows of the FROM table that are read with one of its indexes.
+    struct IndexScan {
+        Core::RelationIterator rows;
+        // Rows are already in ORDER BY order.
+        bool is_ordered = false;
+    };
+
+    std::optional<IndexScan> plan_index_scan(EvaluationContext&) const;
+
+    // `rows_are_ordered` tells if rows are read in ORDER BY order, and is
+    // set if they are sorted while collecting them.
+    SQLErrorOr<std::vector<Core::TupleWithSource>> collect_rows(EvaluationContext&, Core::Relation&, Core::RelationIterator rows, bool& rows_are_ordered) const;
+    // Evaluates WHERE and SELECT columns as each row is read, so that only
+    // output rows are kept. The result is still stored as a whole.
+    SQLErrorOr<std::vector<Core::TupleWithSource>> collect_ungrouped_rows(EvaluationContext&, Core::Relation&, Core::RelationIterator rows, bool& rows_are_ordered) const;
+
+    // Key of the current row of the frame for ORDER BY, see Core::append_sort_key().
+    SQLErrorOr<std::string> sort_key(EvaluationContext&) const;
 
     size_t m_start {};
     SelectOptions m_options;
@@ -2,6 +2,9 @@
 
 #include <db/sql/ast/SelectColumns.hpp>
 
+#include <atomic>
+#include <cstdint>
+
 namespace Db::Core {
 class Database;
 }
@@ -16,15 +19,29 @@ struct EvaluationContextFrame {
     Core::TupleWithSource row {};
 
     std::optional<std::span<Core::Tuple const>> row_group {};
+    // Results of aggregate functions of the current group, if they were
+    // computed while reading rows.
+    std::vector<std::pair<Expression const*, Core::Value>> const* aggregate_values = nullptr;
     enum class RowType {
         FromTable,
         FromResultSet
     };
     RowType row_type = RowType::FromTable;
 
+    // Unique for every frame, so that identifiers can remember where they
+    // were found in it.
+    uint64_t id;
+
     EvaluationContextFrame(TableExpression const* table_, SelectColumns const& columns_)
         : table(table_)
-        , columns(columns_) { }
+        , columns(columns_)
+        , id(next_id()) { }
+
+private:
+    static uint64_t next_id() {
+        static std::atomic<uint64_t> s_next_id = 0;
+        return s_next_id++;
+    }
 };
 
 struct EvaluationContext {
@@ -95,32 +95,65 @@ std::string Literal::to_string() const {
     return m_value.to_sql_serialized_string();
 }
 
-SQLErrorOr<Core::Value> Identifier::evaluate(EvaluationContext& context) const {
-    if (!context.db) {
-        return SQLError { "Identifiers cannot be resolved without database", start() };
-    }
-
-    if (context.current_frame().row_type == EvaluationContextFrame::RowType::FromTable) {
-        std::optional<size_t> index;
-        Core::TupleWithSource const* row = nullptr;
-        for (auto it = context.frames.rbegin(); it != context.frames.rend(); it++) {
+SQLErrorOr<Identifier::Slot> Identifier::resolve(EvaluationContext& context) const {
+    auto const& current_frame = context.current_frame();
+    if (current_frame.row_type == EvaluationContextFrame::RowType::FromTable) {
+        size_t depth = 0;
+        for (auto it = context.frames.rbegin(); it != context.frames.rend(); it++, depth++) {
             auto const& frame = *it;
             if (!frame.table) {
                 return SQLError { "Identifiers cannot be resolved without table", start() };
             }
-            index = TRY(frame.table->resolve_identifier(context.db, *this));
+            auto index = TRY(frame.table->resolve_identifier(context.db, *this));
             if (index) {
-                row = &frame.row;
-                break;
+                return Slot { .kind = Slot::Kind::TableColumn, .frame_id = current_frame.id, .depth = depth, .index = *index };
             }
         }
-        if (!index) {
-            return SQLError { "Invalid identifier", start() };
+        return SQLError { "Invalid identifier", start() };
+    }
+
+    if (!m_table) {
+        auto resolved_alias = current_frame.columns.resolve_alias(m_id);
+        if (resolved_alias)
+            return Slot { .kind = Slot::Kind::ResultColumn, .frame_id = current_frame.id, .depth = 0, .index = resolved_alias->index };
+    }
+
+    if (!current_frame.row.source) {
+        return SQLError { "Cannot use table columns on aggregated rows", start() };
+    }
+
+    for (auto it = context.frames.rbegin(); it != context.frames.rend(); it++) {
+        auto index = TRY(it->table->resolve_identifier(context.db, *this));
+        if (index) {
+            return Slot { .kind = Slot::Kind::SourceColumn, .frame_id = current_frame.id, .depth = 0, .index = *index };
         }
-        return row->tuple.value(*index);
+    }
+    return SQLError { "Invalid identifier", start() };
+}
+
+SQLErrorOr<Core::Value> Identifier::evaluate(EvaluationContext& context) const {
+    if (!context.db) {
+        return SQLError { "Identifiers cannot be resolved without database", start() };
+    }
+
+    auto const& frame = context.current_frame();
+    auto& slot = frame.row_type == EvaluationContextFrame::RowType::FromTable ? m_table_slot : m_result_slot;
+    if (!slot || slot->frame_id != frame.id) {
+        slot = TRY(resolve(context));
     }
 
-    return TRY(context.current_frame().columns.resolve_value(context, *this));
+    switch (slot->kind) {
+    case Slot::Kind::TableColumn:
+        return std::next(context.frames.rbegin(), static_cast<ssize_t>(slot->depth))->row.tuple.value(slot->index);
+    case Slot::Kind::ResultColumn:
+        return frame.row.tuple.value(slot->index);
+    case Slot::Kind::SourceColumn:
+        if (!frame.row.source) {
+            return SQLError { "Cannot use table columns on aggregated rows", start() };
+        }
+        return frame.row.source->value(slot->index);
+    }
+    __builtin_unreachable();
 }
 
 // FIXME: Char ranges doesn't work in row
@@ -382,6 +415,10 @@ bool NonOwningExpressionProxy::contains_aggregate_function() const {
     return m_expression.contains_aggregate_function();
 }
 
+void NonOwningExpressionProxy::collect_aggregate_functions(std::vector<AggregateFunction const*>& functions) const {
+    m_expression.collect_aggregate_functions(functions);
+}
+
 SQLErrorOr<Core::Value> IndexExpression::evaluate(EvaluationContext& context) const {
     auto const& tuple = context.current_frame().row.tuple;
     if (m_index >= tuple.value_count()) {
@@ -20,6 +20,7 @@ class Database;
 
 namespace Db::Sql::AST {
 
+class AggregateFunction;
 class Expression;
 struct EvaluationContext;
 class Identifier;
@@ -34,6 +35,10 @@ public:
     virtual std::string to_string() const = 0;
     virtual std::vector<std::string> referenced_columns() const { return {}; }
     virtual bool contains_aggregate_function() const { return false; }
+
+    // Appends aggregate functions that are evaluated as part of this
+    // expression, so that they can be computed while rows are read.
+    virtual void collect_aggregate_functions(std::vector<AggregateFunction const*>&) const { }
 };
 
 class Check : public Expression {
@@ -90,8 +95,33 @@ public:
     auto table() const { return m_table; }
 
 private:
+    // Where the value of the identifier is in rows of a frame.
+    struct Slot {
+        enum class Kind {
+            // Column of the table of a frame, `depth` frames below the
+            // current one.
+            TableColumn,
+            // SELECT column (or alias) of a result row.
+            ResultColumn,
+            // Column of the table row that a result row comes from.
+            SourceColumn,
+        };
+        Kind kind {};
+        uint64_t frame_id = 0;
+        size_t depth = 0;
+        size_t index = 0;
+    };
+
+    SQLErrorOr<Slot> resolve(EvaluationContext&) const;
+
     std::string m_id;
     std::optional<std::string> m_table;
+
+    // Identifiers are resolved once for every frame they are evaluated in,
+    // instead of looking up tables and columns by name for every row. Rows
+    // from table and result rows are resolved differently.
+    mutable std::optional<Slot> m_table_slot;
+    mutable std::optional<Slot> m_result_slot;
 };
 
 class BinaryOperator : public Expression {
@@ -130,6 +160,14 @@ public:
         return lhs_columns;
     }
     virtual bool contains_aggregate_function() const override { return m_lhs->contains_aggregate_function() || m_rhs->contains_aggregate_function(); }
+    virtual void collect_aggregate_functions(std::vector<AggregateFunction const*>& functions) const override {
+        m_lhs->collect_aggregate_functions(functions);
+        m_rhs->collect_aggregate_functions(functions);
+    }
+
+    Expression const& lhs() const { return *m_lhs; }
+    Operation operation() const { return m_operation; }
+    Expression const* rhs() const { return m_rhs.get(); }
 
 private:
     SQLErrorOr<bool> is_true(EvaluationContext&) const;
@@ -168,6 +206,10 @@ public:
     }
 
     virtual bool contains_aggregate_function() const override { return m_lhs->contains_aggregate_function() || m_rhs->contains_aggregate_function(); }
+    virtual void collect_aggregate_functions(std::vector<AggregateFunction const*>& functions) const override {
+        m_lhs->collect_aggregate_functions(functions);
+        m_rhs->collect_aggregate_functions(functions);
+    }
 
 private:
     std::unique_ptr<Expression> m_lhs;
@@ -198,6 +240,10 @@ public:
         return m_operand->contains_aggregate_function();
     }
 
+    virtual void collect_aggregate_functions(std::vector<AggregateFunction const*>& functions) const override {
+        m_operand->collect_aggregate_functions(functions);
+    }
+
 private:
     Operation m_operation {};
     std::unique_ptr<Expression> m_operand;
@@ -230,6 +276,15 @@ public:
     }
 
     virtual bool contains_aggregate_function() const override { return m_lhs->contains_aggregate_function() || m_min->contains_aggregate_function() || m_max->contains_aggregate_function(); }
+    virtual void collect_aggregate_functions(std::vector<AggregateFunction const*>& functions) const override {
+        m_lhs->collect_aggregate_functions(functions);
+        m_min->collect_aggregate_functions(functions);
+        m_max->collect_aggregate_functions(functions);
+    }
+
+    Expression const& lhs() const { return *m_lhs; }
+    Expression const& min() const { return *m_min; }
+    Expression const& max() const { return *m_max; }
 
 private:
     std::unique_ptr<Expression> m_lhs;
@@ -279,6 +334,16 @@ public:
         return false;
     }
 
+    virtual void collect_aggregate_functions(std::vector<AggregateFunction const*>& functions) const override {
+        m_lhs->collect_aggregate_functions(functions);
+        for (auto const& arg : m_args) {
+            arg->collect_aggregate_functions(functions);
+        }
+    }
+
+    Expression const& lhs() const { return *m_lhs; }
+    std::vector<std::unique_ptr<Expression>> const& args() const { return m_args; }
+
 private:
     std::unique_ptr<Expression> m_lhs;
     std::vector<std::unique_ptr<Expression>> m_args;
@@ -310,6 +375,10 @@ public:
         return m_lhs->contains_aggregate_function();
     }
 
+    virtual void collect_aggregate_functions(std::vector<AggregateFunction const*>& functions) const override {
+        m_lhs->collect_aggregate_functions(functions);
+    }
+
 private:
     std::unique_ptr<Expression> m_lhs;
     What m_what {};
@@ -361,6 +430,15 @@ public:
         return false;
     }
 
+    virtual void collect_aggregate_functions(std::vector<AggregateFunction const*>& functions) const override {
+        for (auto const& case_ : m_cases) {
+            case_.expr->collect_aggregate_functions(functions);
+            case_.value->collect_aggregate_functions(functions);
+        }
+        if (m_else_value)
+            m_else_value->collect_aggregate_functions(functions);
+    }
+
 private:
     std::vector<CasePair> m_cases;
 
@@ -377,6 +455,7 @@ public:
     virtual std::string to_string() const override;
     virtual std::vector<std::string> referenced_columns() const override;
     virtual bool contains_aggregate_function() const override;
+    virtual void collect_aggregate_functions(std::vector<AggregateFunction const*>&) const override;
 
 private:
     Expression const& m_expression;
@@ -393,6 +472,8 @@ public:
     virtual std::string to_string() const override;
     virtual std::vector<std::string> referenced_columns() const override;
 
+    size_t index() const { return m_index; }
+
 private:
     size_t m_index = 0;
     std::string m_name;
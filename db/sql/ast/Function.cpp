@@ -483,6 +483,12 @@ std::string Function::to_string() const {
 
 SQLErrorOr<Core::Value> AggregateFunction::evaluate(EvaluationContext& context) const {
     auto& frame = context.current_frame();
+    if (frame.aggregate_values) {
+        for (auto const& [function, value] : *frame.aggregate_values) {
+            if (function == this)
+                return value;
+        }
+    }
     if (frame.row_group) {
         return TRY(aggregate(context, *frame.row_group));
     }
@@ -491,69 +497,111 @@ SQLErrorOr<Core::Value> AggregateFunction::evaluate(EvaluationContext& context)
     return TRY(aggregate(context, { &tuple, 1 }));
 }
 
-SQLErrorOr<Core::Value> AggregateFunction::aggregate(EvaluationContext& context, std::span<Core::Tuple const> rows) const {
-    auto& frame = context.frames.emplace_back(context.current_frame().table, context.current_frame().columns);
-    Util::ScopeGuard guard { [&] { context.frames.pop_back(); } };
+Core::DbErrorOr<void> AggregateFunction::State::merge(State const& other) {
+    count += other.count;
+    int_sum += other.int_sum;
+    float_sum += other.float_sum;
+    if (!other.min.is_null() && (min.is_null() || TRY(other.min < min)))
+        min = other.min;
+    if (!other.max.is_null() && (max.is_null() || TRY(other.max > max)))
+        max = other.max;
+    return {};
+}
 
-    switch (m_function) {
-    case Function::Count: {
-        int count = 0;
-        for (auto& row : rows) {
-            frame.row = { .tuple = row, .source = {} };
-            auto value = TRY(m_expression->evaluate(context));
-            if (value.type() != Core::Value::Type::Null)
-                count += 1;
-        }
-        return Core::Value::create_int(count);
+// NULL counts as 0, like in to_float().
+static Core::DbErrorOr<double> aggregated_number(Core::Value const& value) {
+    switch (value.type()) {
+    case Core::Value::Type::Int:
+        return static_cast<double>(value.int_value());
+    case Core::Value::Type::Float:
+        return static_cast<double>(value.float_value());
+    default:
+        return static_cast<double>(TRY(value.to_float()));
     }
-    case Function::Sum: {
-        float sum = 0;
-        for (auto& row : rows) {
-            frame.row = { .tuple = row, .source = {} };
-            auto value = TRY(m_expression->evaluate(context));
-            sum += TRY(value.to_float().map_error(DbToSQLError { start() }));
-        }
+}
 
-        return Core::Value::create_float(sum);
+SQLErrorOr<void> AggregateFunction::accumulate(EvaluationContext& context, State& state) const {
+    if (!m_expression) {
+        state.count++;
+        return {};
     }
-    case Function::Min: {
-        float min = std::numeric_limits<float>::max();
-        for (auto& row : rows) {
-            frame.row = { .tuple = row, .source = {} };
-            auto value = TRY(m_expression->evaluate(context));
-            min = std::min(min, TRY(value.to_float().map_error(DbToSQLError { start() })));
-        }
 
-        return Core::Value::create_float(min);
-    }
+    auto value = TRY(m_expression->evaluate(context));
+    switch (m_function) {
+    case Function::Count:
+        if (value.type() != Core::Value::Type::Null)
+            state.count++;
+        return {};
+    case Function::Sum:
+    case Function::Avg:
+        if (value.type() == Core::Value::Type::Int)
+            state.int_sum += value.int_value();
+        else
+            state.float_sum += TRY(aggregated_number(value).map_error(DbToSQLError { start() }));
+        // AVG counts NULLs too.
+        state.count++;
+        return {};
+    case Function::Min:
     case Function::Max: {
-        float max = std::numeric_limits<float>::min();
-        for (auto& row : rows) {
-            frame.row = { .tuple = row, .source = {} };
-            auto value = TRY(m_expression->evaluate(context));
-            max = std::max(max, TRY(value.to_float().map_error(DbToSQLError { start() })));
-        }
-
-        return Core::Value::create_float(max);
+        // NULLs are skipped, unlike in other aggregates.
+        if (value.is_null())
+            return {};
+        auto& extreme = m_function == Function::Min ? state.min : state.max;
+        if (extreme.is_null()
+            || TRY((m_function == Function::Min ? value < extreme : value > extreme).map_error(DbToSQLError { start() })))
+            extreme = std::move(value);
+        return {};
     }
-    case Function::Avg: {
-        float sum = 0;
-        size_t count = 0;
-        for (auto& row : rows) {
-            frame.row = { .tuple = row, .source = {} };
-            auto value = TRY(m_expression->evaluate(context));
-            sum += TRY(value.to_int().map_error(DbToSQLError { start() }));
-            count++;
-        }
+    default:
+        break;
+    }
+    __builtin_unreachable();
+}
 
-        return Core::Value::create_float(sum / (count != 0 ? count : 1));
+// Numbers are returned as FLOAT, like other aggregates. MIN and MAX of
+// no values are NULL.
+static Core::Value extreme_result(Core::Value const& value) {
+    switch (value.type()) {
+    case Core::Value::Type::Int:
+        return Core::Value::create_float(static_cast<float>(value.int_value()));
+    case Core::Value::Type::Float:
+        return Core::Value::create_float(value.float_value());
+    default:
+        return value;
     }
+}
+
+Core::Value AggregateFunction::result(State const& state) const {
+    auto sum = static_cast<double>(state.int_sum) + state.float_sum;
+    switch (m_function) {
+    case Function::Count:
+        return Core::Value::create_int(static_cast<int>(state.count));
+    case Function::Sum:
+        return Core::Value::create_float(static_cast<float>(sum));
+    case Function::Min:
+        return extreme_result(state.min);
+    case Function::Max:
+        return extreme_result(state.max);
+    case Function::Avg:
+        return Core::Value::create_float(static_cast<float>(sum / static_cast<double>(state.count != 0 ? state.count : 1)));
     default:
         break;
     }
     __builtin_unreachable();
 }
 
+SQLErrorOr<Core::Value> AggregateFunction::aggregate(EvaluationContext& context, std::span<Core::Tuple const> rows) const {
+    auto& frame = context.frames.emplace_back(context.current_frame().table, context.current_frame().columns);
+    Util::ScopeGuard guard { [&] { context.frames.pop_back(); } };
+
+    State state;
+    for (auto& row : rows) {
+        frame.row = { .tuple = row, .source = {} };
+        TRY(accumulate(context, state));
+    }
+    return result(state);
+}
+
 std::string AggregateFunction::to_string() const {
     std::string str;
     switch (m_function) {
@@ -577,7 +625,7 @@ std::string AggregateFunction::to_string() const {
         break;
     }
     str += "(";
-    str += m_expression->to_string();
+    str += m_expression ? m_expression->to_string() : "*";
     str += ")";
     return str;
 }
@@ -23,6 +23,12 @@ public:
         return columns;
     }
 
+    virtual void collect_aggregate_functions(std::vector<AggregateFunction const*>& functions) const override {
+        for (auto const& arg : m_args) {
+            arg->collect_aggregate_functions(functions);
+        }
+    }
+
 private:
     std::string m_name;
     std::vector<std::unique_ptr<Expression>> m_args;
@@ -48,13 +54,38 @@ public:
     virtual SQLErrorOr<Core::Value> evaluate(EvaluationContext&) const override;
     virtual std::string to_string() const override;
 
+    // Running state of the aggregate, updated with one row at a time.
+    // Integers are summed separately, so that they don't lose precision.
+    // States of parts of the input can be merged, in any order.
+    struct State {
+        int64_t count = 0;
+        int64_t int_sum = 0;
+        double float_sum = 0;
+        // Values as they were read, null until there is a non-null value.
+        Core::Value min;
+        Core::Value max;
+
+        Core::DbErrorOr<void> merge(State const&);
+    };
+
+    // Adds the row of the current frame to `state`.
+    SQLErrorOr<void> accumulate(EvaluationContext&, State&) const;
+    Core::Value result(State const&) const;
+
     SQLErrorOr<Core::Value> aggregate(EvaluationContext&, std::span<Core::Tuple const> rows) const;
 
-    virtual std::vector<std::string> referenced_columns() const override { return m_expression->referenced_columns(); }
+    // COUNT(*), which counts all rows.
+    bool counts_all_rows() const { return !m_expression; }
+
+    virtual std::vector<std::string> referenced_columns() const override {
+        return m_expression ? m_expression->referenced_columns() : std::vector<std::string> {};
+    }
     virtual bool contains_aggregate_function() const override { return true; }
+    virtual void collect_aggregate_functions(std::vector<AggregateFunction const*>& functions) const override { functions.push_back(this); }
 
 private:
     Function m_function {};
+    // Null for COUNT(*).
     std::unique_ptr<Expression> m_expression;
     std::optional<std::string> m_over;
 };
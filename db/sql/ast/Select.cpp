@@ -1,6 +1,7 @@
 #include <db/sql/ast/Select.hpp>
 
 #include <db/core/TupleFromValues.hpp>
+#include <unordered_set>
 
 namespace Db::Sql::AST {
 
@@ -53,28 +54,18 @@ SQLErrorOr<Core::ValueOrResultSet> Union::execute(Core::Database& db) const {
     }
 
     std::vector<Core::Tuple> rows;
+    std::unordered_set<Core::Tuple, Core::TupleHash, Core::TupleEqual> seen_rows;
 
-    for (const auto& row : lhs.rows()) {
-        rows.push_back(row);
-    }
-
-    for (const auto& row : rhs.rows()) {
-        if (m_distinct) {
-            bool distinct = true;
-            for (const auto& to_compare : lhs.rows()) {
-                if (TRY((row == to_compare).map_error(DbToSQLError { start() }))) {
-                    distinct = false;
-                    break;
-                }
-            }
-
-            if (distinct)
+    // UNION (without ALL) outputs the first occurrence of every row,
+    // including rows repeated within one side.
+    auto add_rows = [&](Core::ResultSet const& result) {
+        for (const auto& row : result.rows()) {
+            if (!m_distinct || seen_rows.insert(row).second)
                 rows.push_back(row);
         }
-        else {
-            rows.push_back(row);
-        }
-    }
+    };
+    add_rows(lhs);
+    add_rows(rhs);
 
     return Core::ResultSet { lhs.column_names(), std::move(rows) };
 }
@@ -95,23 +86,25 @@ SQLErrorOr<Core::ValueOrResultSet> InsertInto::execute(Core::Database& db) const
     EvaluationContext context { .db = &db };
     if (m_select) {
         auto result = TRY(m_select.value().execute(context));
+        std::vector<Core::Tuple> rows;
+        rows.reserve(result.rows().size());
         for (const auto& row : result.rows()) {
             if (m_columns.empty()) {
                 std::vector<Core::Value> values;
-                for (size_t s = 0; s < table->size(); s++) {
+                for (size_t s = 0; s < table->columns().size(); s++) {
                     values.push_back(row.value(s));
                 }
-                TRY(table->insert(&db, Core::Tuple { values }).map_error(DbToSQLError { start() }));
+                rows.push_back(Core::Tuple { values });
             }
             else {
                 std::vector<std::pair<std::string, Core::Value>> values;
                 for (size_t i = 0; i < m_columns.size(); i++) {
                     values.push_back({ m_columns[i], row.value(i) });
                 }
-                TRY(table->insert(&db, TRY(create_tuple_from_values(*table, values).map_error(DbToSQLError { start() })))
-                        .map_error(DbToSQLError { start() }));
+                rows.push_back(TRY(create_tuple_from_values(*table, values).map_error(DbToSQLError { start() })));
             }
         }
+        TRY(table->insert_batch(&db, rows).map_error(DbToSQLError { start() }));
     }
     else {
         if (m_columns.empty()) {
@@ -10,6 +10,7 @@
 #include <db/core/IndexedRelation.hpp>
 #include <db/core/Table.hpp>
 #include <db/core/ValueOrResultSet.hpp>
+#include <db/sql/SQL.hpp>
 #include <db/sql/ast/EvaluationContext.hpp>
 #include <db/sql/ast/TableExpression.hpp>
 #include <iostream>
@@ -25,7 +26,9 @@ SQLErrorOr<Core::ValueOrResultSet> StatementList::execute(Core::Database& db) co
 
     std::optional<Core::ValueOrResultSet> result;
     for (auto const& stmt : m_statements) {
-        TRY(stmt->execute(db));
+        auto stmt_result = stmt->execute(db);
+        TRY(commit(db));
+        TRY(std::move(stmt_result));
     }
     return *result;
 }
@@ -45,28 +48,34 @@ SQLErrorOr<Core::ValueOrResultSet> DeleteFrom::execute(Core::Database& db) const
         return TRY(m_where->evaluate(context)).to_bool().map_error(DbToSQLError { start() });
     };
 
-    std::set<size_t> rows_to_remove;
+    // WHERE is evaluated for all rows before removing anything, so that
+    // subqueries see the table as it was before the statement.
+    std::vector<size_t> rows_to_remove;
     {
         size_t idx = 0;
-        TRY(table->writable_rows().try_for_each_row_reference([&](Core::RowReference const& ref) -> SQLErrorOr<void> {
-            auto should_include = TRY(should_include_row(ref.read()));
-            if (should_include) {
-                rows_to_remove.insert(idx);
+        TRY(table->rows().try_for_each_batch([&](Core::RowBatch const& batch) -> SQLErrorOr<void> {
+            for (auto const& row : batch) {
+                if (TRY(should_include_row(row))) {
+                    rows_to_remove.push_back(idx);
+                }
+                idx++;
             }
-            idx++;
             return {};
         }));
     }
 
-    {
+    if (!rows_to_remove.empty()) {
+        auto rows = table->writable_rows();
+        auto to_remove = rows_to_remove.begin();
         size_t idx = 0;
-        TRY(table->writable_rows().try_for_each_row_reference([&](Core::RowReference& ref) -> SQLErrorOr<void> {
-            if (rows_to_remove.contains(idx)) {
-                ref.remove();
+        for (auto batch = &rows.next_batch(); !batch->empty() && to_remove != rows_to_remove.end(); batch = &rows.next_batch()) {
+            for (size_t s = 0; s < batch->size() && to_remove != rows_to_remove.end(); s++, idx++) {
+                if (*to_remove == idx) {
+                    TRY(rows.remove_batch_row(s).map_error(DbToSQLError { start() }));
+                    to_remove++;
+                }
             }
-            idx++;
-            return {};
-        }));
+        }
     }
 
     return Core::Value::null();
@@ -85,13 +94,15 @@ SQLErrorOr<Core::ValueOrResultSet> Update::execute(Core::Database& db) const {
     for (const auto& update_pair : m_to_update) {
         auto column = table->get_column(update_pair.column);
 
-        TRY(table->writable_rows().try_for_each_row_reference([&](Core::RowReference& row) -> SQLErrorOr<void> {
-            auto tuple = row.read();
-            context.current_frame().row = { .tuple = tuple, .source = {} };
-            tuple.set_value(column->index, TRY(update_pair.expr->evaluate(context)));
-            row.write(tuple);
-            return {};
-        }));
+        auto rows = table->writable_rows();
+        for (auto batch = &rows.next_batch(); !batch->empty(); batch = &rows.next_batch()) {
+            for (size_t s = 0; s < batch->size(); s++) {
+                auto tuple = (*batch)[s];
+                context.current_frame().row = { .tuple = tuple, .source = {} };
+                tuple.set_value(column->index, TRY(update_pair.expr->evaluate(context)));
+                TRY(rows.write_batch_row(s, tuple).map_error(DbToSQLError { start() }));
+            }
+        }
     }
 
     return Core::Value::null();
@@ -119,21 +130,17 @@ SQLErrorOr<Core::ValueOrResultSet> CreateTable::execute(Core::Database& db) cons
     setup.name = m_name;
     for (auto const& column : m_columns) {
         setup.columns.push_back(column.column);
+        // Storage engine may need to know the primary key to index it.
+        if (auto pk = std::get_if<Core::PrimaryKey>(&column.key)) {
+            setup.primary_key = *pk;
+        }
     }
     auto table = TRY(db.create_table(std::move(setup), m_check, m_engine.value_or(db.default_engine())).map_error(DbToSQLError { start() }));
 
     for (auto const& column : m_columns) {
-        std::visit(
-            Util::Overloaded {
-                [](std::monostate) {},
-                [&](Core::PrimaryKey const& pk) {
-                    table->set_primary_key(pk);
-                },
-                [&](Core::ForeignKey const& fk) {
-                    table->add_foreign_key(fk);
-                },
-            },
-            column.key);
+        if (auto fk = std::get_if<Core::ForeignKey>(&column.key)) {
+            table->add_foreign_key(*fk);
+        }
     }
     return { Core::Value::null() };
 }
@@ -154,15 +161,44 @@ SQLErrorOr<Core::ValueOrResultSet> TruncateTable::execute(Core::Database& db) co
     }
 
     // Just drop table and recreate it with the same settings :^)
-    // FIXME: Handle primary and foreign keys
+    // FIXME: Handle foreign keys
     auto table = TRY(db.table(m_name).map_error(DbToSQLError { start() }));
-    Core::TableSetup setup { table->name(), table->columns() };
+    Core::TableSetup setup { table->name(), table->columns(), table->primary_key() };
     auto memory_backed_table = dynamic_cast<Core::MemoryBackedTable*>(table);
     auto check = memory_backed_table ? memory_backed_table->check() : nullptr;
+    auto indexes = memory_backed_table ? memory_backed_table->index_setups() : std::vector<Core::MemoryBackedTable::IndexSetup> {};
     auto engine = table->engine();
 
     TRY(db.drop_table(m_name).map_error(DbToSQLError { start() }));
-    TRY(db.create_table(setup, check, engine).map_error(DbToSQLError { start() }));
+    auto new_table = TRY(db.create_table(setup, check, engine).map_error(DbToSQLError { start() }));
+    if (auto new_memory_backed_table = dynamic_cast<Core::MemoryBackedTable*>(new_table)) {
+        for (auto const& index : indexes) {
+            TRY(new_memory_backed_table->create_index(index.name, index.columns).map_error(DbToSQLError { start() }));
+        }
+    }
+    return { Core::Value::null() };
+}
+
+// Indexes are ordered, kept in memory and used by SELECT, so only tables
+// with rows in memory can have them.
+static SQLErrorOr<Core::MemoryBackedTable*> table_for_index(Core::Database& db, std::string const& name, size_t start) {
+    auto table = TRY(db.table(name).map_error(DbToSQLError { start }));
+    auto memory_backed_table = dynamic_cast<Core::MemoryBackedTable*>(table);
+    if (!memory_backed_table) {
+        return SQLError { "(FIXME) Indexes are supported only on MemoryBackedTables", start };
+    }
+    return memory_backed_table;
+}
+
+SQLErrorOr<Core::ValueOrResultSet> CreateIndex::execute(Core::Database& db) const {
+    auto table = TRY(table_for_index(db, m_table, start()));
+    TRY(table->create_index(m_name, m_columns).map_error(DbToSQLError { start() }));
+    return { Core::Value::null() };
+}
+
+SQLErrorOr<Core::ValueOrResultSet> DropIndex::execute(Core::Database& db) const {
+    auto table = TRY(table_for_index(db, m_table, start()));
+    TRY(table->drop_index(m_name).map_error(DbToSQLError { start() }));
     return { Core::Value::null() };
 }
 
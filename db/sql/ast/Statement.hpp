@@ -169,6 +169,36 @@ private:
     std::string m_name;
 };
 
+class CreateIndex : public Statement {
+public:
+    CreateIndex(ssize_t start, std::string name, std::string table, std::vector<std::string> columns)
+        : Statement(start)
+        , m_name(std::move(name))
+        , m_table(std::move(table))
+        , m_columns(std::move(columns)) { }
+
+    virtual SQLErrorOr<Core::ValueOrResultSet> execute(Core::Database&) const override;
+
+private:
+    std::string m_name;
+    std::string m_table;
+    std::vector<std::string> m_columns;
+};
+
+class DropIndex : public Statement {
+public:
+    DropIndex(ssize_t start, std::string name, std::string table)
+        : Statement(start)
+        , m_name(std::move(name))
+        , m_table(std::move(table)) { }
+
+    virtual SQLErrorOr<Core::ValueOrResultSet> execute(Core::Database&) const override;
+
+private:
+    std::string m_name;
+    std::string m_table;
+};
+
 class AlterTable : public TableStatement {
 public:
     AlterTable(ssize_t start, ExistenceCondition existence, std::string name, std::vector<ParsedColumn> to_add, std::vector<ParsedColumn> to_alter, std::vector<std::string> to_drop,
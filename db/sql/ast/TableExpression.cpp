@@ -5,6 +5,7 @@
 #include <EssaUtil/Config.hpp>
 #include <db/core/Database.hpp>
 #include <db/core/DbError.hpp>
+#include <db/core/HashJoinRelation.hpp>
 
 namespace Db::Sql::AST {
 
@@ -91,147 +92,21 @@ SQLErrorOr<size_t> TableIdentifier::column_count(Core::Database* db) const {
 }
 
 SQLErrorOr<std::unique_ptr<Core::Relation>> JoinExpression::evaluate(EvaluationContext& context) const {
-    auto lhs = TRY(m_lhs->evaluate(context));
-    auto rhs = TRY(m_rhs->evaluate(context));
-
-    std::vector<Core::Column> columns;
-    std::multimap<Core::Value, std::pair<Core::Relation*, Core::Tuple>, Core::ValueSorter> contents;
-
-    auto add_columns = [&columns, &contents, this](Core::Relation& source_table, Identifier const* on_id) -> SQLErrorOr<void> {
-        bool add_to_index = true;
-        size_t index = 0;
-        for (const auto& column : source_table.columns()) {
-            if (column.name() == on_id->referenced_columns().front())
-                add_to_index = false;
-            if (add_to_index)
-                index++;
-            columns.push_back(Core::Column(column.name(), column.type(), false, false, false));
-        }
-        TRY(source_table.rows().try_for_each_row([&](auto const& row) -> SQLErrorOr<void> {
-            if (index >= row.value_count()) {
-                return SQLError { fmt::format("Invalid column `{}` used in join expression", on_id->to_string()), start() };
-            }
-            contents.insert(std::pair(row.value(index), std::make_pair(&source_table, row)));
-            return {};
-        }));
-        return {};
-    };
-
-    TRY(add_columns(*lhs, m_on_lhs.get()));
-    TRY(add_columns(*rhs, m_on_rhs.get()));
-    auto table = std::make_unique<Core::MemoryBackedTable>(nullptr, Core::TableSetup { "Join", columns });
-
-    auto beg = contents.begin();
-    beg++;
-    auto last = contents.begin();
-
-    switch (m_join_type) {
-    case Type::InnerJoin: {
-        for (auto it = beg; it != contents.end(); it++) {
-            if (last->second.first == lhs.get() && it->second.first == rhs.get()) {
-                if (TRY((it->first == last->first).map_error(DbToSQLError { start() }))) {
-                    auto row = create_joined_tuple(last->second.second, it->second.second);
-                    TRY(table->insert_unchecked(row).map_error(DbToSQLError { start() }));
-                    it++;
-                    if (it == contents.end())
-                        break;
-                }
-            }
-            last = it;
-        }
-
-        break;
-    }
-
-    case Type::LeftJoin: {
-        for (auto it = beg; it != contents.end(); it++) {
-            if (last->second.first == lhs.get()) {
-                if (TRY((it->first == last->first).map_error(DbToSQLError { start() }))) {
-                    auto row = create_joined_tuple(last->second.second, it->second.second);
-                    TRY(table->insert_unchecked(row).map_error(DbToSQLError { start() }));
-                    it++;
-                    if (it == contents.end())
-                        break;
-                }
-                else {
-                    std::vector<Core::Value> values(rhs->columns().size(), Core::Value::null());
-                    Core::Tuple dummy(values);
-
-                    auto row = create_joined_tuple(last->second.second, dummy);
-
-                    TRY(table->insert_unchecked(row).map_error(DbToSQLError { start() }));
-                }
-            }
-            last = it;
-        }
-
-        break;
-    }
-
-    case Type::RightJoin: {
-        for (auto it = beg; it != contents.end(); it++) {
-            if (last->second.first == rhs.get() || it->second.first == rhs.get()) {
-                if (TRY((it->first == last->first).map_error(DbToSQLError { start() }))) {
-                    auto row = create_joined_tuple(last->second.second, it->second.second);
-                    TRY(table->insert_unchecked(row).map_error(DbToSQLError { start() }));
-                    it++;
-                    if (it == contents.end())
-                        break;
-
-                    last = it;
-                }
-                else {
-                    std::vector<Core::Value> values(lhs->columns().size(), Core::Value::null());
-                    Core::Tuple dummy(values);
-
-                    auto row = create_joined_tuple(dummy, it->second.second);
-
-                    TRY(table->insert_unchecked(row).map_error(DbToSQLError { start() }));
-                }
-            }
-            last = it;
-        }
-
-        break;
+    if (m_join_type == Type::Invalid) {
+        return SQLError { fmt::format("Internal error: Invalid join type"), start() };
     }
 
-    case Type::OuterJoin: {
-        for (auto it = beg; it != contents.end(); it++) {
-            if (last->second.first == lhs.get() && it->second.first == rhs.get() && TRY((it->first == last->first).map_error(DbToSQLError { start() }))) {
-                auto row = create_joined_tuple(last->second.second, it->second.second);
-                TRY(table->insert_unchecked(row).map_error(DbToSQLError { start() }));
-                it++;
-                if (it == contents.end())
-                    break;
-            }
-            else if (last->second.first == lhs.get()) {
-                std::vector<Core::Value> values(rhs->columns().size(), Core::Value::null());
-                Core::Tuple dummy(values);
-
-                auto row = create_joined_tuple(last->second.second, dummy);
-
-                TRY(table->insert_unchecked(row).map_error(DbToSQLError { start() }));
-            }
-            else if (last->second.first == rhs.get()) {
-                std::vector<Core::Value> values(lhs->columns().size(), Core::Value::null());
-                Core::Tuple dummy(values);
-
-                auto row = create_joined_tuple(dummy, it->second.second);
-
-                TRY(table->insert_unchecked(row).map_error(DbToSQLError { start() }));
-            }
-            last = it;
+    auto side = [&](std::unique_ptr<Core::Relation> relation, Identifier const& on_id, bool keep_unmatched) -> SQLErrorOr<Core::HashJoinRelation::Side> {
+        auto column = relation->get_column(on_id.id());
+        if (!column) {
+            return SQLError { fmt::format("Invalid column `{}` used in join expression", on_id.to_string()), start() };
         }
+        return Core::HashJoinRelation::Side { .relation = std::move(relation), .key_column = column->index, .keep_unmatched = keep_unmatched };
+    };
 
-        break;
-    }
-
-    case Type::Invalid:
-        return SQLError { fmt::format("Internal error: Invalid join type"), start() };
-        break;
-    }
-
-    return table;
+    auto lhs = TRY(side(TRY(m_lhs->evaluate(context)), *m_on_lhs, m_join_type == Type::LeftJoin || m_join_type == Type::OuterJoin));
+    auto rhs = TRY(side(TRY(m_rhs->evaluate(context)), *m_on_rhs, m_join_type == Type::RightJoin || m_join_type == Type::OuterJoin));
+    return std::make_unique<Core::HashJoinRelation>(std::move(lhs), std::move(rhs));
 }
 
 SQLErrorOr<std::optional<size_t>> JoinExpression::resolve_identifier(Core::Database* db, Identifier const& id) const {
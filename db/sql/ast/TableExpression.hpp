@@ -49,6 +49,8 @@ public:
     virtual SQLErrorOr<std::optional<size_t>> resolve_identifier(Core::Database* db, Identifier const&) const override;
     virtual SQLErrorOr<size_t> column_count(Core::Database* db) const override;
 
+    std::string const& id() const { return m_id; }
+
 private:
     std::string m_id;
     std::optional<std::string> m_alias;
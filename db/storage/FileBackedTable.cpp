@@ -9,19 +9,19 @@
 
 namespace Db::Storage {
 
-Util::OsErrorOr<std::unique_ptr<FileBackedTable>> FileBackedTable::initialize(std::string database_path, Core::TableSetup setup) {
+Util::OsErrorOr<std::unique_ptr<FileBackedTable>> FileBackedTable::initialize(std::string database_path, Core::TableSetup setup, EDB::WriteAheadLog* wal, EDB::BufferPool* buffer_pool) {
     auto path = fmt::format("{}/{}.edb", database_path, setup.name);
     Util::File file { ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644), true };
-    auto table = TRY(FileBackedTable::create(TRY(EDB::EDBFile::initialize(std::move(file), setup))));
+    auto table = TRY(FileBackedTable::create(TRY(EDB::EDBFile::initialize(std::move(file), setup, wal, buffer_pool))));
     table->m_database_path = std::move(database_path);
     table->m_table_name = std::move(setup.name);
     return table;
 }
 
-Util::OsErrorOr<std::unique_ptr<FileBackedTable>> FileBackedTable::open(std::string database_path, std::string table_name) {
+Util::OsErrorOr<std::unique_ptr<FileBackedTable>> FileBackedTable::open(std::string database_path, std::string table_name, EDB::WriteAheadLog* wal, EDB::BufferPool* buffer_pool) {
     auto path = fmt::format("{}/{}.edb", database_path, table_name);
     Util::File file { ::open(path.c_str(), O_RDWR), true };
-    auto table = TRY(FileBackedTable::create(TRY(EDB::EDBFile::open(std::move(file)))));
+    auto table = TRY(FileBackedTable::create(TRY(EDB::EDBFile::open(std::move(file), wal, buffer_pool))));
     table->m_database_path = std::move(database_path);
     table->m_table_name = std::move(table_name);
     return table;
@@ -39,6 +39,11 @@ Util::OsErrorOr<std::unique_ptr<FileBackedTable>> FileBackedTable::create(std::u
 
 Util::OsErrorOr<void> FileBackedTable::read_header() {
     m_columns = TRY(m_file->read_columns());
+    for (auto const& key : m_file->keys()) {
+        if (key.type == EDB::KeyType::Primary) {
+            set_primary_key(Core::PrimaryKey { .local_column = m_columns[key.local_column].name() });
+        }
+    }
     return {};
 }
 
@@ -59,7 +64,7 @@ size_t FileBackedTable::size() const {
 }
 
 std::string FileBackedTable::name() const {
-    return m_file->read_heap(m_file->header().table_name).decode_infallible().encode();
+    return m_file->table_name();
 }
 
 int FileBackedTable::next_auto_increment_value(std::string const&) {
@@ -94,6 +99,36 @@ Core::DbErrorOr<void> FileBackedTable::insert_unchecked(Core::Tuple const& tuple
     return {};
 }
 
+Core::DbErrorOr<bool> FileBackedTable::contains_value(size_t column, Core::Value const& value) const {
+    auto rows = m_file->find_rows(column, value);
+    if (!rows) {
+        return Table::contains_value(column, value);
+    }
+    for (auto row : *rows) {
+        if (TRY(m_file->read_row(row).value(column) == value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::optional<Core::RelationIterator> FileBackedTable::rows_with_value(size_t column, Core::Value const& value) const {
+    auto rows = m_file->find_rows(column, value);
+    if (!rows) {
+        return {};
+    }
+    return Core::RelationIterator { std::make_unique<EDB::EDBFoundRowsIteratorImpl>(*m_file, std::move(*rows)) };
+}
+
+void FileBackedTable::begin_batch() {
+    m_file->begin_batch();
+}
+
+Core::DbErrorOr<void> FileBackedTable::end_batch() {
+    TRY(m_file->end_batch().map_error(os_to_db_error));
+    return {};
+}
+
 void FileBackedTable::dump_storage_debug() {
     fmt::print("path={}\n", m_database_path);
     m_file->dump();
@@ -103,4 +138,23 @@ std::string FileBackedTable::edb_file_path() const {
     return fmt::format("{}/{}.edb", m_database_path, m_table_name);
 }
 
+Util::OsErrorOr<void> FileBackedTable::replay(EDB::WriteAheadLog::Record const& record) {
+    switch (record.type) {
+    case EDB::WriteAheadLog::RecordType::Insert:
+        return m_file->insert(record.tuple);
+    case EDB::WriteAheadLog::RecordType::Remove:
+        return m_file->remove(record.row, record.prev_row);
+    case EDB::WriteAheadLog::RecordType::Update:
+        return m_file->update(record.row, record.tuple);
+    case EDB::WriteAheadLog::RecordType::Commit:
+        break;
+    }
+    ESSA_UNREACHABLE;
+}
+
+EDB::WriteAheadLog::FileImage FileBackedTable::take_checkpoint_image() {
+    // Log lives in the database directory, so files are referenced by name.
+    return m_file->take_checkpoint_image(m_table_name + ".edb");
+}
+
 }
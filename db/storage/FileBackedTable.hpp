@@ -9,8 +9,8 @@ namespace Db::Storage {
 
 class FileBackedTable : public Core::Table {
 public:
-    static Util::OsErrorOr<std::unique_ptr<FileBackedTable>> initialize(std::string database_path, Core::TableSetup);
-    static Util::OsErrorOr<std::unique_ptr<FileBackedTable>> open(std::string database_path, std::string table_name);
+    static Util::OsErrorOr<std::unique_ptr<FileBackedTable>> initialize(std::string database_path, Core::TableSetup, EDB::WriteAheadLog* = nullptr, EDB::BufferPool* = nullptr);
+    static Util::OsErrorOr<std::unique_ptr<FileBackedTable>> open(std::string database_path, std::string table_name, EDB::WriteAheadLog* = nullptr, EDB::BufferPool* = nullptr);
 
     // ^Relation
     virtual std::vector<Core::Column> const& columns() const override;
@@ -25,10 +25,23 @@ public:
     virtual int increment(std::string const& column) override;
     virtual Core::DbErrorOr<void> rename(std::string const& new_name) override;
     virtual Core::DbErrorOr<void> insert_unchecked(Core::Tuple const&) override;
+    virtual Core::DbErrorOr<bool> contains_value(size_t column, Core::Value const&) const override;
+    virtual bool has_index(size_t column) const override { return m_file->has_index(column); }
+    virtual std::optional<Core::RelationIterator> rows_with_value(size_t column, Core::Value const&) const override;
     virtual void dump_storage_debug() override;
 
     std::string edb_file_path() const;
 
+    // Apply a record of the write-ahead log during recovery.
+    Util::OsErrorOr<void> replay(EDB::WriteAheadLog::Record const&);
+    EDB::WriteAheadLog::FileImage take_checkpoint_image();
+    void finish_checkpoint() { m_file->finish_checkpoint(); }
+
+protected:
+    // ^Table
+    virtual void begin_batch() override;
+    virtual Core::DbErrorOr<void> end_batch() override;
+
 private:
     friend std::unique_ptr<FileBackedTable> std::make_unique<FileBackedTable>(std::unique_ptr<Db::Storage::EDB::EDBFile>&&);
 
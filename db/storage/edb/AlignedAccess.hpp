@@ -1,8 +1,11 @@
 #pragma once
 
 #include <algorithm>
+#include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <fmt/format.h>
+#include <span>
 #include <utility>
 
 namespace Db::Storage::EDB {
@@ -129,4 +132,26 @@ private:
     size_t m_size = 0;
 };
 
+// Read-only counterpart of AlignedAccess for sequential reads, e.g. when
+// decoding rows. Every field is loaded with memcpy, so nothing needs to be
+// aligned, copied upfront or flushed back to the mapping.
+class UnalignedReader {
+public:
+    explicit UnalignedReader(std::span<uint8_t const> data)
+        : m_data(data) { }
+
+    template<class T>
+    T read() {
+        assert(m_offset + sizeof(T) <= m_data.size());
+        T object;
+        std::memcpy(&object, m_data.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return object;
+    }
+
+private:
+    std::span<uint8_t const> m_data;
+    size_t m_offset = 0;
+};
+
 }
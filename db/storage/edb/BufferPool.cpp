@@ -0,0 +1,301 @@
+#include "BufferPool.hpp"
+
+#include <EssaUtil/Config.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <unistd.h>
+
+namespace Db::Storage::EDB {
+
+// Offsets, sizes and buffers of O_DIRECT I/O must be aligned to the logical
+// block size of the device. Page size is enough for all common devices.
+constexpr size_t DirectIoAlignment = 4096;
+
+static Util::OsErrorOr<void> pread_all(int fd, uint8_t* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        auto result = ::pread(fd, data, size, offset);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return Util::OsError { .error = errno, .function = "BufferPool: pread" };
+        }
+        if (result == 0) {
+            // Past the end of file, e.g. rounded up for O_DIRECT.
+            std::fill_n(data, size, 0);
+            return {};
+        }
+        data += result;
+        size -= result;
+        offset += result;
+    }
+    return {};
+}
+
+static Util::OsErrorOr<void> pwrite_all(int fd, uint8_t const* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        auto result = ::pwrite(fd, data, size, offset);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return Util::OsError { .error = errno, .function = "BufferPool: pwrite" };
+        }
+        data += result;
+        size -= result;
+        offset += result;
+    }
+    return {};
+}
+
+struct AlignedBuffer {
+    explicit AlignedBuffer(size_t size)
+        : data(static_cast<uint8_t*>(std::aligned_alloc(DirectIoAlignment, size))) { }
+    ~AlignedBuffer() { std::free(data); }
+
+    uint8_t* data;
+};
+
+Util::OsErrorOr<size_t> BufferPool::allocate_frame(PooledPageStore& store, BlockIndex block, size_t size) {
+    TRY(evict_until(m_capacity > size ? m_capacity - size : 0));
+
+    size_t index;
+    if (!m_free_frames.empty()) {
+        index = m_free_frames.back();
+        m_free_frames.pop_back();
+    }
+    else {
+        index = m_frames.size();
+        m_frames.emplace_back();
+    }
+    auto& frame = m_frames[index];
+    frame.store = &store;
+    frame.block = block;
+    frame.data = std::make_unique<uint8_t[]>(size);
+    frame.size = size;
+    frame.dirty = false;
+    frame.in_checkpoint = false;
+    m_used_bytes += size;
+    touch(index);
+    return index;
+}
+
+void BufferPool::release_frame(size_t index) {
+    auto& frame = m_frames[index];
+    assert(frame.store);
+    m_used_bytes -= frame.size;
+    frame = {};
+    m_free_frames.push_back(index);
+}
+
+void BufferPool::touch(size_t index) {
+    auto& frame = m_frames[index];
+    frame.referenced = true;
+    frame.scope_epoch = m_scope_epoch;
+}
+
+bool BufferPool::can_evict(Frame const& frame) const {
+    if (frame.in_checkpoint || (frame.dirty && !frame.store->m_write_back)) {
+        return false;
+    }
+    // Outside of scopes, pointers are valid only until the next access.
+    return m_scope_depth == 0 || frame.scope_epoch != m_scope_epoch;
+}
+
+Util::OsErrorOr<void> BufferPool::evict_until(size_t target_bytes) {
+    // Every frame is visited at most twice: first time its reference bit
+    // may be cleared, the second time it's evicted.
+    for (size_t step = 0; m_used_bytes > target_bytes && step < 2 * m_frames.size(); step++) {
+        auto index = m_clock_hand;
+        m_clock_hand = (m_clock_hand + 1) % m_frames.size();
+        auto& frame = m_frames[index];
+        if (!frame.store || !can_evict(frame)) {
+            continue;
+        }
+        if (frame.referenced) {
+            frame.referenced = false;
+            continue;
+        }
+        TRY(frame.store->evict(index));
+        release_frame(index);
+    }
+    return {};
+}
+
+void BufferPool::begin_scope() {
+    if (m_scope_depth++ == 0) {
+        m_scope_epoch++;
+    }
+}
+
+void BufferPool::end_scope() {
+    assert(m_scope_depth > 0);
+    if (--m_scope_depth == 0) {
+        evict_until(m_capacity).release_value_but_fixme_should_propagate_errors();
+    }
+}
+
+Util::OsErrorOr<std::unique_ptr<PooledPageStore>> PooledPageStore::create(BufferPool& pool, int fd, size_t size, bool write_back) {
+    std::optional<Util::File> direct_file;
+    if (pool.direct_io()) {
+        auto path = fmt::format("/proc/self/fd/{}", fd);
+        direct_file = Util::File { ::open(path.c_str(), O_RDWR | O_DIRECT | O_CLOEXEC), true };
+        if (direct_file->fd() < 0) {
+            return Util::OsError { .error = errno, .function = "PooledPageStore: open with O_DIRECT" };
+        }
+    }
+    return std::unique_ptr<PooledPageStore>(new PooledPageStore(pool, fd, std::move(direct_file), size, write_back));
+}
+
+PooledPageStore::PooledPageStore(BufferPool& pool, int fd, std::optional<Util::File> direct_file, size_t size, bool write_back)
+    : m_pool(pool)
+    , m_fd(fd)
+    , m_direct_file(std::move(direct_file))
+    , m_file_size(size)
+    , m_write_back(write_back) {
+}
+
+PooledPageStore::~PooledPageStore() {
+    // Modified blocks are written by flush() or a checkpoint before that.
+    for (auto frame : m_frame_of_block) {
+        if (frame != 0) {
+            m_pool.release_frame(frame - 1);
+        }
+    }
+}
+
+Util::OsErrorOr<void> PooledPageStore::resize(size_t size) {
+    m_file_size = size;
+    return {};
+}
+
+std::optional<size_t> PooledPageStore::frame_index(BlockIndex index) const {
+    if (index >= m_frame_of_block.size() || m_frame_of_block[index] == 0) {
+        return {};
+    }
+    return m_frame_of_block[index] - 1;
+}
+
+BufferPool::Frame& PooledPageStore::frame(BlockIndex index) const {
+    assert(index != 0);
+    assert(block_offset(index) + m_block_size <= m_file_size);
+
+    auto existing_frame = frame_index(index);
+    if (existing_frame) {
+        m_pool.touch(*existing_frame);
+        return m_pool.m_frames[*existing_frame];
+    }
+
+    // Note: This may evict frames, but never the one that is loaded.
+    auto new_frame = m_pool.allocate_frame(const_cast<PooledPageStore&>(*this), index, m_block_size).release_value_but_fixme_should_propagate_errors();
+    auto& frame = m_pool.m_frames[new_frame];
+    read_block(index, frame.data.get()).release_value_but_fixme_should_propagate_errors();
+    if (index >= m_frame_of_block.size()) {
+        m_frame_of_block.resize(index + 1);
+    }
+    m_frame_of_block[index] = new_frame + 1;
+    return frame;
+}
+
+uint8_t* PooledPageStore::block(BlockIndex index) {
+    auto& frame = this->frame(index);
+    frame.dirty = true;
+    return frame.data.get();
+}
+
+uint8_t const* PooledPageStore::block(BlockIndex index) const {
+    return frame(index).data.get();
+}
+
+Util::OsErrorOr<void> PooledPageStore::evict(size_t frame_index) {
+    auto& frame = m_pool.m_frames[frame_index];
+    assert(frame.store == this);
+    if (frame.dirty) {
+        TRY(write_block(frame.block, frame.data.get()));
+    }
+    m_frame_of_block[frame.block] = 0;
+    return {};
+}
+
+std::vector<BlockIndex> PooledPageStore::take_dirty_blocks() {
+    std::vector<BlockIndex> blocks;
+    for (BlockIndex s = 1; s < m_frame_of_block.size(); s++) {
+        auto index = frame_index(s);
+        if (!index) {
+            continue;
+        }
+        auto& frame = m_pool.m_frames[*index];
+        if (frame.dirty) {
+            frame.dirty = false;
+            frame.in_checkpoint = true;
+            blocks.push_back(s);
+        }
+    }
+    return blocks;
+}
+
+void PooledPageStore::finish_checkpoint() {
+    for (BlockIndex s = 1; s < m_frame_of_block.size(); s++) {
+        if (auto index = frame_index(s)) {
+            m_pool.m_frames[*index].in_checkpoint = false;
+        }
+    }
+}
+
+Util::OsErrorOr<void> PooledPageStore::flush() {
+    for (BlockIndex s = 1; s < m_frame_of_block.size(); s++) {
+        auto index = frame_index(s);
+        if (!index) {
+            continue;
+        }
+        auto& frame = m_pool.m_frames[*index];
+        if (frame.dirty) {
+            TRY(write_block(s, frame.data.get()));
+            frame.dirty = false;
+        }
+    }
+    return {};
+}
+
+Util::OsErrorOr<void> PooledPageStore::read_block(BlockIndex index, uint8_t* data) const {
+    auto offset = block_offset(index);
+    if (!m_direct_file) {
+        return pread_all(m_fd, data, m_block_size, offset);
+    }
+
+    // Blocks aren't aligned, so read whole aligned range around the block.
+    auto begin = offset / DirectIoAlignment * DirectIoAlignment;
+    auto end = (offset + m_block_size + DirectIoAlignment - 1) / DirectIoAlignment * DirectIoAlignment;
+    AlignedBuffer buffer { end - begin };
+    TRY(pread_all(m_direct_file->fd(), buffer.data, end - begin, begin));
+    std::memcpy(data, buffer.data + (offset - begin), m_block_size);
+    return {};
+}
+
+Util::OsErrorOr<void> PooledPageStore::write_block(BlockIndex index, uint8_t const* data) const {
+    auto offset = block_offset(index);
+    if (!m_direct_file) {
+        return pwrite_all(m_fd, data, m_block_size, offset);
+    }
+
+    // Parts of neighbouring blocks (or the header) that share aligned
+    // ranges with the block are written back as they are on disk.
+    auto begin = offset / DirectIoAlignment * DirectIoAlignment;
+    auto end = (offset + m_block_size + DirectIoAlignment - 1) / DirectIoAlignment * DirectIoAlignment;
+    AlignedBuffer buffer { end - begin };
+    TRY(pread_all(m_direct_file->fd(), buffer.data, end - begin, begin));
+    std::memcpy(buffer.data + (offset - begin), data, m_block_size);
+    TRY(pwrite_all(m_direct_file->fd(), buffer.data, end - begin, begin));
+
+    // The aligned range may go past the end of file.
+    if (end > m_file_size && ::ftruncate(m_direct_file->fd(), m_file_size) < 0) {
+        return Util::OsError { .error = errno, .function = "BufferPool: ftruncate" };
+    }
+    return {};
+}
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <EssaUtil/Error.hpp>
+#include <EssaUtil/Stream/File.hpp>
+#include <db/storage/edb/Definitions.hpp>
+#include <db/storage/edb/PageStore.hpp>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace Db::Storage::EDB {
+
+class PooledPageStore;
+
+// Fixed amount of memory for blocks of all table files of a database, as
+// an alternative to mapping them. Blocks are read into frames with pread()
+// and evicted with the CLOCK algorithm: every access sets the reference
+// bit of a frame, and the clock hand gives referenced frames a second
+// chance before evicting them.
+//
+// Frames accessed in the current PageScope are never evicted, so the pool
+// may go over its capacity during an operation that touches many blocks.
+// It shrinks back when the scope ends. Modified blocks of logged files
+// can't be written before a checkpoint, so they aren't evicted either.
+class BufferPool {
+public:
+    BufferPool(size_t capacity, bool direct_io)
+        : m_capacity(capacity)
+        , m_direct_io(direct_io) { }
+
+    BufferPool(BufferPool const&) = delete;
+    BufferPool& operator=(BufferPool const&) = delete;
+
+    size_t capacity() const { return m_capacity; }
+    size_t used_bytes() const { return m_used_bytes; }
+    bool direct_io() const { return m_direct_io; }
+
+private:
+    friend class PooledPageStore;
+
+    struct Frame {
+        PooledPageStore* store = nullptr;
+        BlockIndex block = 0;
+        std::unique_ptr<uint8_t[]> data;
+        size_t size = 0;
+        bool referenced = false;
+        bool dirty = false;
+        bool in_checkpoint = false;
+        uint64_t scope_epoch = 0;
+    };
+
+    Util::OsErrorOr<size_t> allocate_frame(PooledPageStore&, BlockIndex, size_t size);
+    void release_frame(size_t index);
+    void touch(size_t index);
+    bool can_evict(Frame const&) const;
+    Util::OsErrorOr<void> evict_until(size_t target_bytes);
+
+    void begin_scope();
+    void end_scope();
+
+    size_t m_capacity;
+    bool m_direct_io;
+    std::vector<Frame> m_frames;
+    std::vector<size_t> m_free_frames;
+    size_t m_clock_hand = 0;
+    size_t m_used_bytes = 0;
+    size_t m_scope_depth = 0;
+    uint64_t m_scope_epoch = 0;
+};
+
+class PooledPageStore : public PageStore {
+public:
+    // Without `write_back` (for logged files), modified blocks are kept in
+    // memory until they are written by a checkpoint.
+    static Util::OsErrorOr<std::unique_ptr<PooledPageStore>> create(BufferPool&, int fd, size_t size, bool write_back);
+    virtual ~PooledPageStore();
+
+    virtual Util::OsErrorOr<void> resize(size_t size) override;
+    virtual uint8_t* block(BlockIndex) override;
+    virtual uint8_t const* block(BlockIndex) const override;
+    virtual std::vector<BlockIndex> take_dirty_blocks() override;
+    virtual void finish_checkpoint() override;
+    virtual Util::OsErrorOr<void> flush() override;
+
+private:
+    friend class BufferPool;
+
+    PooledPageStore(BufferPool&, int fd, std::optional<Util::File> direct_file, size_t size, bool write_back);
+
+    virtual void begin_scope() const override { m_pool.begin_scope(); }
+    virtual void end_scope() const override { m_pool.end_scope(); }
+
+    BufferPool::Frame& frame(BlockIndex) const;
+    std::optional<size_t> frame_index(BlockIndex) const;
+
+    // Called by the pool when the frame is evicted.
+    Util::OsErrorOr<void> evict(size_t frame_index);
+
+    Util::OsErrorOr<void> read_block(BlockIndex, uint8_t* data) const;
+    Util::OsErrorOr<void> write_block(BlockIndex, uint8_t const* data) const;
+
+    BufferPool& m_pool;
+    int m_fd;
+    // Separate open file description, so that O_DIRECT doesn't affect
+    // header I/O done on `m_fd`.
+    std::optional<Util::File> m_direct_file;
+    size_t m_file_size;
+    bool m_write_back;
+
+    // Frame index + 1 for every block, 0 if the block isn't in memory.
+    mutable std::vector<uint32_t> m_frame_of_block;
+};
+
+}
@@ -14,7 +14,7 @@ using BlockIndex = uint32_t;
 class EDBFile;
 
 constexpr uint8_t Magic[] = { 0x65, 0x73, 0x64, 0x62, 0x0d, 0x0a }; // esdb\r\n
-constexpr uint16_t CurrentVersion = 0x0001;
+constexpr uint16_t CurrentVersion = 0x0004;
 constexpr size_t RowsPerBlock = 256;
 
 struct [[gnu::packed]] HeapPtr {
@@ -22,6 +22,9 @@ struct [[gnu::packed]] HeapPtr {
     LittleEndian<uint32_t> offset;
 
     bool is_null() const { return block == 0; }
+    bool operator==(HeapPtr const& other) const {
+        return block.value() == other.block.value() && offset.value() == other.offset.value();
+    }
 };
 
 struct [[gnu::packed]] HeapSpan {
@@ -39,6 +42,7 @@ struct [[gnu::packed]] EDBHeader {
     HeapPtr last_row_ptr;
     BlockIndex last_table_block;
     BlockIndex last_heap_block;
+    HeapPtr first_free_row;
     HeapSpan table_name;
     HeapSpan check_statement;
     uint8_t auto_increment_value_count;
@@ -49,7 +53,8 @@ enum class BlockType : uint8_t {
     Free,
     Table,
     Heap,
-    Big
+    Big,
+    Index
 };
 
 struct [[gnu::packed]] Block {
@@ -87,9 +92,27 @@ struct Column {
     Value default_value;
 };
 
+enum class KeyType : uint8_t {
+    Primary,
+    Foreign,
+    Unique
+};
+
+struct [[gnu::packed]] Key {
+    KeyType type;
+    uint8_t local_column;
+    HeapSpan referenced_table;
+    uint8_t referenced_column;
+    // Root of B+tree index on local column, 0 if the key is not indexed.
+    // It never changes, so the header doesn't need to be rewritten.
+    LittleEndian<BlockIndex> index_root;
+};
+
 namespace Table {
 
 struct RowSpec {
+    // For used rows, this points to the next row in table. For unused
+    // rows, this points to the next free row slot.
     HeapPtr next_row;
     uint8_t is_used;
     uint8_t row[0];
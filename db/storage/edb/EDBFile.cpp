@@ -5,6 +5,8 @@
 #include <EssaUtil/ScopeGuard.hpp>
 #include <EssaUtil/Stream/File.hpp>
 #include <EssaUtil/Stream/Stream.hpp>
+#include <algorithm>
+#include <bit>
 #include <db/core/Value.hpp>
 #include <db/storage/edb/Definitions.hpp>
 #include <db/storage/edb/MappedFile.hpp>
@@ -24,9 +26,10 @@ Util::OsErrorOr<void> ftruncate(int fd, off_t size) {
     return {};
 }
 
-EDBFile::EDBFile(Util::File f, MappedFile mapped_file)
-    : m_mapped_file(std::move(mapped_file))
-    , m_file(std::move(f)) {
+EDBFile::EDBFile(Util::File f, std::unique_ptr<PageStore> pages, WriteAheadLog* wal)
+    : m_pages(std::move(pages))
+    , m_file(std::move(f))
+    , m_wal(wal) {
 }
 
 EDBFile::~EDBFile() {
@@ -36,23 +39,34 @@ EDBFile::~EDBFile() {
     }
 }
 
-Util::OsErrorOr<std::unique_ptr<EDBFile>> EDBFile::open(Util::File file) {
+Util::OsErrorOr<std::unique_ptr<PageStore>> EDBFile::create_page_store(int fd, size_t size, WriteAheadLog* wal, BufferPool* buffer_pool) {
+    // Logged files must not be modified until checkpoint, so they are
+    // mapped privately, or their blocks are never written back.
+    if (buffer_pool) {
+        return TRY(PooledPageStore::create(*buffer_pool, fd, size, !wal));
+    }
+    return TRY(MappedPageStore::create(fd, size, wal ? MappedFile::Mode::Private : MappedFile::Mode::Shared));
+}
+
+Util::OsErrorOr<std::unique_ptr<EDBFile>> EDBFile::open(Util::File file, WriteAheadLog* wal, BufferPool* buffer_pool) {
     struct stat stat;
     if (::fstat(file.fd(), &stat) < 0) {
         return Util::OsError { .error = errno, .function = "EDBFile::open(): stat" };
     }
-    auto mapped_file = TRY(MappedFile::map(file.fd(), stat.st_size));
-    auto edb_file = std::unique_ptr<EDBFile>(new EDBFile(std::move(file), std::move(mapped_file)));
+    auto pages = TRY(create_page_store(file.fd(), stat.st_size, wal, buffer_pool));
+    auto edb_file = std::unique_ptr<EDBFile>(new EDBFile(std::move(file), std::move(pages), wal));
+    PageScope scope { *edb_file->m_pages };
     TRY(edb_file->read_header());
     return edb_file;
 }
 
-Util::OsErrorOr<std::unique_ptr<EDBFile>> EDBFile::initialize(Util::File file, Db::Core::TableSetup setup) {
+Util::OsErrorOr<std::unique_ptr<EDBFile>> EDBFile::initialize(Util::File file, Db::Core::TableSetup setup, WriteAheadLog* wal, BufferPool* buffer_pool) {
     if (file.fd() == -1) {
         return Util::OsError { .error = errno, .function = "EDBFile::initialize() open" };
     }
-    auto mapped_file = TRY(MappedFile::map(file.fd(), sizeof(EDBHeader)));
-    auto edb_file = std::unique_ptr<EDBFile>(new EDBFile(std::move(file), std::move(mapped_file)));
+    auto pages = TRY(create_page_store(file.fd(), sizeof(EDBHeader), wal, buffer_pool));
+    auto edb_file = std::unique_ptr<EDBFile>(new EDBFile(std::move(file), std::move(pages), wal));
+    PageScope scope { *edb_file->m_pages };
 
     TRY(edb_file->write_header_first_pass(setup));
 
@@ -60,6 +74,11 @@ Util::OsErrorOr<std::unique_ptr<EDBFile>> EDBFile::initialize(Util::File file, D
     TRY(edb_file->allocate_block(BlockType::Table));
     TRY(edb_file->allocate_block(BlockType::Heap));
 
+    // Keys are checked for every inserted row, so they are indexed.
+    for (auto& key : edb_file->m_keys) {
+        key.index_root = TRY(Index::create(*edb_file));
+    }
+
     TRY(edb_file->write_header(setup));
     TRY(edb_file->read_header());
 
@@ -67,6 +86,7 @@ Util::OsErrorOr<std::unique_ptr<EDBFile>> EDBFile::initialize(Util::File file, D
 }
 
 void EDBFile::dump_blocks() {
+    PageScope scope { *m_pages };
     fmt::print("Block count: {}\n", m_block_count);
     for (size_t s = 1; s < m_block_count; s++) {
         auto block = access<Block>({ s, 0 });
@@ -85,6 +105,9 @@ void EDBFile::dump_blocks() {
         case BlockType::Big:
             fmt::print("BIG");
             break;
+        case BlockType::Index:
+            fmt::print("INDEX");
+            break;
         }
         fmt::print("\n");
     }
@@ -98,6 +121,7 @@ T copy(T ref) {
 }
 
 void EDBFile::dump() {
+    PageScope scope { *m_pages };
     fmt::print("--- EDB File Dump ---\n");
     fmt::print("Header:\n");
     fmt::print("  magic = ");
@@ -113,6 +137,7 @@ void EDBFile::dump() {
     fmt::print("  last_row_ptr = {}\n", copy(m_header.last_row_ptr));
     fmt::print("  last_table_block = {}\n", copy(m_header.last_table_block));
     fmt::print("  last_heap_block = {}\n", copy(m_header.last_heap_block));
+    fmt::print("  first_free_row = {}\n", copy(m_header.first_free_row));
     fmt::print("  auto_increment_value_count = {}\n", copy(m_header.auto_increment_value_count));
     fmt::print("  key_count = {}\n", copy(m_header.key_count));
     fmt::print("  row size = {}\n", row_size());
@@ -136,6 +161,9 @@ void EDBFile::dump() {
         case BlockType::Big:
             fmt::print("BIG");
             break;
+        case BlockType::Index:
+            fmt::print("INDEX");
+            break;
         }
         fmt::print("\n");
 
@@ -171,25 +199,56 @@ void EDBFile::dump() {
             heap_block->dump(*this, s);
         } break;
         case BlockType::Big:
-            fmt::print("  TODO\n");
+            fmt::print("    {} B of data\n", big_block_data_size());
+            break;
+        case BlockType::Index:
             break;
         }
     }
+
+    for (auto const& index : m_indexes) {
+        fmt::print("Column {} ", index.column);
+        index.index.dump();
+    }
 }
 
 Util::Buffer EDBFile::read_heap(HeapSpan span) const {
-    auto ptr = heap_ptr_to_mapped_ptr(span.offset);
-    // fmt::print("read_heap({}:{} +{}) = [", span.offset.block, span.offset.offset, (uint32_t)span.size);
-    // for (auto b : std::span { ptr, span.size }) {
-    //     fmt::print("{:02x} ", static_cast<uint16_t>(b));
-    // }
-    // fmt::print("]\n");
-    return Util::Buffer { { ptr, span.size } };
+    // fmt::print("read_heap({}:{} +{})\n", span.offset.block, span.offset.offset, (uint32_t)span.size);
+    PageScope scope { *m_pages };
+    std::vector<uint8_t> data;
+    data.reserve(span.size);
+    for_each_heap_chunk(span, [&](std::span<uint8_t const> chunk) {
+        data.insert(data.end(), chunk.begin(), chunk.end());
+    });
+    return Util::Buffer { { data.data(), data.size() } };
+}
+
+void EDBFile::write_heap(HeapSpan span, std::span<uint8_t const> data) {
+    assert(data.size() == span.size);
+    if (span.size == 0) {
+        return;
+    }
+    if (block_header(span.offset.block).type != BlockType::Big) {
+        std::copy(data.begin(), data.end(), mapped_span(span.offset, span.size).begin());
+        return;
+    }
+    BlockIndex current_block = span.offset.block;
+    while (!data.empty()) {
+        assert(current_block != 0);
+        auto chunk_size = std::min(data.size(), big_block_data_size());
+        std::copy(data.begin(), data.begin() + chunk_size, mapped_span({ current_block, sizeof(Block) }, chunk_size).begin());
+        data = data.subspan(chunk_size);
+        current_block = block_header(current_block).next_block;
+    }
+}
+
+Block EDBFile::block_header(BlockIndex index) const {
+    return UnalignedReader { mapped_span({ index, 0 }, sizeof(Block)) }.read<Block>();
 }
 
 size_t EDBFile::header_size() const {
-    // TODO: AI, keys
-    return sizeof(EDBHeader) + m_header.column_count * sizeof(Column);
+    // TODO: AI
+    return sizeof(EDBHeader) + m_header.column_count * sizeof(Column) + m_header.key_count * sizeof(Key);
 }
 
 size_t EDBFile::block_size() const {
@@ -201,20 +260,12 @@ size_t EDBFile::block_offset(BlockIndex idx) const {
     return header_size() + block_size() * (idx - 1);
 }
 
-uint8_t* EDBFile::heap_ptr_to_mapped_ptr(HeapPtr ptr) {
-    return reinterpret_cast<uint8_t*>(m_mapped_file.data().data() + block_offset(ptr.block) + ptr.offset);
-}
-
-uint8_t const* EDBFile::heap_ptr_to_mapped_ptr(HeapPtr ptr) const {
-    return reinterpret_cast<uint8_t const*>(m_mapped_file.data().data() + block_offset(ptr.block) + ptr.offset);
-}
-
 Util::OsErrorOr<void> EDBFile::expand(size_t blocks) {
     TRY(ftruncate(m_file.fd(), m_file_size + blocks * block_size()));
     m_file_size += blocks * block_size();
     m_block_count += blocks;
     // fmt::print("Remap to size={} block_size={}\n", m_file_size, block_size());
-    TRY(m_mapped_file.remap(m_file_size));
+    TRY(m_pages->resize(m_file_size));
     return {};
 }
 
@@ -222,17 +273,26 @@ Util::OsErrorOr<BlockIndex> EDBFile::allocate_block(BlockType block_type) {
     // fmt::print("!!!!! allocate block\n");
 
     BlockIndex allocated_block = 0;
-    for (BlockIndex s = 1; s < m_block_count; s++) {
+    for (BlockIndex s = m_free_block_hint; s < m_block_count; s++) {
         // fmt::print("Checking block: {}\n", s);
-        auto block = access<Block>({ s, 0 });
-        if (block->type == BlockType::Free) {
+        if (block_header(s).type == BlockType::Free) {
             allocated_block = s;
             break;
         }
     }
-    // fmt::print("!!! expand {}\n", m_block_count);
-    TRY(expand(1));
-    allocated_block = m_block_count - 1;
+    if (allocated_block == 0) {
+        // Double the block count, so that file is resized and remapped
+        // only O(log n) times. New blocks are zeroed, i.e free.
+        // fmt::print("!!! expand {}\n", m_block_count);
+        allocated_block = m_block_count;
+        TRY(expand(std::max<size_t>(1, m_block_count - 1)));
+    }
+    else {
+        // The block may contain leftovers of a freed Big extent.
+        std::fill_n(m_pages->block(allocated_block), block_size(), 0);
+    }
+    // This was the first free block, so all blocks before it are used.
+    m_free_block_hint = allocated_block + 1;
 
     auto block = access<Block>({ allocated_block, 0 }, block_size());
     block->type = block_type;
@@ -247,6 +307,21 @@ Util::OsErrorOr<BlockIndex> EDBFile::allocate_block(BlockType block_type) {
         }
         block->prev_block = m_header.last_table_block;
         m_header.last_table_block = allocated_block;
+        // This would override free list if not flushed here!
+        block.flush();
+        block.clear();
+
+        // Put all slots of the new block in front of the free list, so
+        // that they are filled in order.
+        auto row_spec_size = sizeof(Table::RowSpec) + row_size();
+        auto slot_count = rows_per_table_block();
+        for (size_t s = slot_count; s > 0; s--) {
+            HeapPtr slot { allocated_block, static_cast<uint32_t>(sizeof(Block) + sizeof(Table::TableBlock) + (s - 1) * row_spec_size) };
+            auto row = access<Table::RowSpec>(slot);
+            row->is_used = 0;
+            row->next_row = m_header.first_free_row;
+            m_header.first_free_row = slot;
+        }
         break;
     }
     case BlockType::Heap: {
@@ -262,13 +337,13 @@ Util::OsErrorOr<BlockIndex> EDBFile::allocate_block(BlockType block_type) {
         // fmt::print("Initializing heap block @ {}\n", allocated_block);
         auto heap_block = access<Data::HeapBlock>({ allocated_block, sizeof(Block) }, block_size() - sizeof(Block));
         heap_block->init(*this);
-        // fmt::print("heap before flushing is at {:x}\n", heap_block.original_ptr() - m_mapped_file.data().data());
         heap_block.flush();
         // fmt::print("Heap dump just after initializing:\n");
         // m_heap.dump();
         break;
     }
     case BlockType::Big:
+    case BlockType::Index:
         break;
     }
 
@@ -277,6 +352,57 @@ Util::OsErrorOr<BlockIndex> EDBFile::allocate_block(BlockType block_type) {
     return allocated_block;
 }
 
+Util::OsErrorOr<BlockIndex> EDBFile::allocate_big_extent(size_t block_count) {
+    assert(block_count > 0);
+
+    // 1. Find a run of free blocks, or a free run at the end of file that
+    //    can be extended.
+    BlockIndex run_start = 0;
+    size_t run_length = 0;
+    for (BlockIndex s = m_free_block_hint; s < m_block_count && run_length < block_count; s++) {
+        if (block_header(s).type == BlockType::Free) {
+            if (run_length == 0) {
+                run_start = s;
+            }
+            run_length++;
+        }
+        else {
+            run_length = 0;
+        }
+    }
+    if (run_length < block_count) {
+        if (run_length == 0) {
+            run_start = m_block_count;
+        }
+        TRY(expand(std::max<size_t>(block_count - run_length, m_block_count - 1)));
+    }
+    if (run_start == m_free_block_hint) {
+        m_free_block_hint = run_start + block_count;
+    }
+
+    // 2. Link blocks into a list, the same way as other blocks.
+    for (size_t s = 0; s < block_count; s++) {
+        BlockIndex index = run_start + s;
+        auto block = access<Block>({ index, 0 });
+        block->type = BlockType::Big;
+        block->prev_block = s == 0 ? 0 : index - 1;
+        block->next_block = s == block_count - 1 ? 0 : index + 1;
+    }
+    return run_start;
+}
+
+void EDBFile::free_big_extent(BlockIndex first_block) {
+    BlockIndex current_block = first_block;
+    while (current_block != 0) {
+        auto block = access<Block>({ current_block, 0 });
+        assert(block->type == BlockType::Big);
+        auto next_block = block->next_block;
+        *block = Block { .type = BlockType::Free, .prev_block = 0, .next_block = 0 };
+        current_block = next_block;
+    }
+    m_free_block_hint = std::min(m_free_block_hint, first_block);
+}
+
 Util::OsErrorOr<void> EDBFile::write_header_first_pass(Db::Core::TableSetup const& setup) {
     uint32_t block_size = 0;
     block_size += sizeof(Table::RowSpec);
@@ -286,6 +412,7 @@ Util::OsErrorOr<void> EDBFile::write_header_first_pass(Db::Core::TableSetup cons
         }
         block_size += value_size_for_type(column.type());
     }
+    m_row_size = block_size - sizeof(Table::RowSpec);
     block_size *= 255;
     block_size += sizeof(Table::TableBlock) + sizeof(Block);
 
@@ -294,8 +421,31 @@ Util::OsErrorOr<void> EDBFile::write_header_first_pass(Db::Core::TableSetup cons
     // fmt::print("Block size: {}\n", block_size);
     m_header.last_table_block = 0;
     m_header.last_heap_block = 0;
+    m_header.first_free_row = {};
     m_header.column_count = setup.columns.size();
+
+    auto add_key = [&](KeyType type, std::string const& column_name) {
+        auto column = std::ranges::find_if(setup.columns, [&](auto const& column) { return column.name() == column_name; });
+        assert(column != setup.columns.end());
+        m_keys.push_back(Key {
+            .type = type,
+            .local_column = static_cast<uint8_t>(column - setup.columns.begin()),
+            .referenced_table = {},
+            .referenced_column = 0,
+            .index_root = 0,
+        });
+    };
+    if (setup.primary_key) {
+        add_key(KeyType::Primary, setup.primary_key->local_column);
+    }
+    for (auto const& column : setup.columns) {
+        if (column.unique() && !(setup.primary_key && setup.primary_key->local_column == column.name())) {
+            add_key(KeyType::Unique, column.name());
+        }
+    }
+    m_header.key_count = m_keys.size();
     m_file_size = header_size();
+    m_pages->set_layout(header_size(), block_size);
     return {};
 }
 
@@ -304,8 +454,7 @@ Util::OsErrorOr<void> EDBFile::write_header(Db::Core::TableSetup const& setup) {
         return Util::OsError { .error = 0, .function = "Columns > 255 not supported" };
     }
 
-    auto table_name = TRY(heap_allocate_and_get_span(setup.name.size()));
-    std::copy(setup.name.begin(), setup.name.end(), reinterpret_cast<char*>(table_name.mapped_span.data()));
+    auto table_name = TRY(copy_to_heap(setup.name));
 
     EDBHeader header {
         .magic = {},
@@ -317,10 +466,11 @@ Util::OsErrorOr<void> EDBFile::write_header(Db::Core::TableSetup const& setup) {
         .last_row_ptr = { 0, 0 },
         .last_table_block = 1,
         .last_heap_block = 2,
-        .table_name = table_name.heap_span,
+        .first_free_row = m_header.first_free_row,
+        .table_name = table_name,
         .check_statement = {},           // TODO
         .auto_increment_value_count = 0, // TODO
-        .key_count = 0,                  // TODO
+        .key_count = static_cast<uint8_t>(m_keys.size()),
     };
 
     auto stream = Util::WritableFileStream::borrow_fd(m_file.fd());
@@ -334,7 +484,10 @@ Util::OsErrorOr<void> EDBFile::write_header(Db::Core::TableSetup const& setup) {
     }
 
     // TODO: AI
-    // TODO: Keys
+
+    for (auto const& key : m_keys) {
+        TRY(writer.write_struct(key));
+    }
 
     return {};
 }
@@ -350,107 +503,181 @@ Util::OsErrorOr<void> EDBFile::read_header() {
     TRY(stream.seek(0, Util::SeekDirection::FromStart));
     Util::BinaryReader reader { stream };
     m_header = TRY(reader.read_struct<EDB::EDBHeader>());
+    if (!std::equal(std::begin(Magic), std::end(Magic), m_header.magic)) {
+        return Util::OsError { .error = 0, .function = "EDBFile: read_header: Invalid magic" };
+    }
+    if (m_header.version != CurrentVersion) {
+        return Util::OsError { .error = 0, .function = "EDBFile: read_header: Unsupported version" };
+    }
     m_block_count = (m_file_size - header_size()) / block_size() + 1;
+    m_pages->set_layout(header_size(), block_size());
 
     for (size_t s = 0; s < m_header.column_count; s++) {
         m_columns.push_back(TRY(reader.read_struct<Column>()));
     }
 
+    m_keys.clear();
+    m_indexes.clear();
+    for (size_t s = 0; s < m_header.key_count; s++) {
+        auto key = TRY(reader.read_struct<Key>());
+        if (key.index_root != 0) {
+            m_indexes.push_back({ .column = key.local_column, .index = Index { *this, key.index_root } });
+        }
+        m_keys.push_back(key);
+    }
+
+    m_row_size = 0;
+    for (auto const& column : m_columns) {
+        if (!column.not_null) {
+            m_row_size += 1;
+        }
+        m_row_size += value_size_for_type(static_cast<Core::Value::Type>(column.type));
+    }
+
+    m_table_name = read_heap(m_header.table_name).decode_infallible().encode();
     return {};
 }
 
 Util::OsErrorOr<void> EDBFile::flush_header() {
+    // Header is a part of checkpoint image then.
+    if (m_wal) {
+        return {};
+    }
+    // Blocks go first, so that the header never points to unwritten ones.
+    TRY(m_pages->flush());
     auto stream = Util::WritableFileStream::borrow_fd(m_file.fd());
     TRY(stream.seek(0, Util::SeekDirection::FromStart));
     TRY(Util::Writer { stream }.write_struct(m_header));
     return {};
 }
 
+Util::OsErrorOr<void> EDBFile::flush_header_unless_batched() {
+    if (m_batch_depth > 0) {
+        return {};
+    }
+    return flush_header();
+}
+
+void EDBFile::begin_batch() {
+    m_batch_depth++;
+}
+
+Util::OsErrorOr<void> EDBFile::end_batch() {
+    assert(m_batch_depth > 0);
+    m_batch_depth--;
+    return flush_header_unless_batched();
+}
+
 Util::OsErrorOr<void> EDBFile::rename(std::string const& new_name) {
+    PageScope scope { *m_pages };
     TRY(heap_free(m_header.table_name.offset));
     m_header.table_name = TRY(copy_to_heap(new_name));
+    m_table_name = new_name;
     return {};
 }
 
 Util::OsErrorOr<void> EDBFile::insert(Core::Tuple const& tuple) {
+    PageScope scope { *m_pages };
     // fmt::print("===== Insert\n");
 
-    // 1. Find free place in Table blocks
-    std::optional<HeapPtr> place_for_allocation;
-    if (m_header.last_row_ptr.is_null()) {
-        place_for_allocation = { 1, sizeof(Block) + sizeof(Table::TableBlock) };
+    // 1. Find the first slot of the free list, allocating a new block if
+    //    there are no free slots left. The slot is taken off the list only
+    //    once the row is written and indexed, so that it isn't lost if
+    //    that fails.
+    if (m_header.first_free_row.is_null()) {
+        TRY(allocate_block(BlockType::Table));
     }
-    else {
-        HeapPtr last_row_ptr = { 1, sizeof(Block) + sizeof(Table::TableBlock) };
-        while (true) {
-            if (last_row_ptr.offset + sizeof(Table::RowSpec) + row_size() > block_size()) {
-                // TODO: Skip blocks that are full (rows_in_block == 255)
-                last_row_ptr.block = last_row_ptr.block + 1;
-                last_row_ptr.offset = sizeof(Block) + sizeof(Table::TableBlock);
-                if (last_row_ptr.block >= m_block_count) {
-                    fmt::print("no free block :(\n");
-                    break;
-                }
-            }
-            // fmt::print("Last row: {}:{}\n", last_row_ptr.block, last_row_ptr.offset);
-            auto row = access<Table::RowSpec>(last_row_ptr);
-            if (!row->is_used) {
-                place_for_allocation = last_row_ptr;
-                break;
-            }
-            last_row_ptr = { last_row_ptr.block, last_row_ptr.offset + sizeof(Table::RowSpec) + row_size() };
+    HeapPtr place_for_allocation = m_header.first_free_row;
+    HeapPtr next_free_row;
+    {
+        auto row = access<Table::RowSpec>(place_for_allocation);
+        if (row->is_used) {
+            return Util::OsError { .error = 0, .function = "Corruption: EDBFile::insert: Free list points to used row" };
         }
+        next_free_row = row->next_row;
     }
 
-    if (!place_for_allocation) {
-        // 2. If there is no free place, allocate new block
-        fmt::print("will need to allocate block\n");
-        auto block = TRY(allocate_block(BlockType::Table));
-        place_for_allocation = HeapPtr { block, sizeof(Block) + sizeof(Table::TableBlock) };
-    }
-
-    // fmt::print("Place for allocation: {}:{}\n", place_for_allocation->block, place_for_allocation->offset);
+    // fmt::print("Place for allocation: {}:{}\n", place_for_allocation.block, place_for_allocation.offset);
 
-    // 3. Actually write row
+    // 2. Actually write row
     {
         Util::WritableMemoryStream stream;
         Util::Writer writer { stream };
         // Note: This invalidates all Accesses.
         TRY(Serializer::write_row(*this, writer, m_columns, tuple));
 
-        auto row = access<Table::RowSpec>(*place_for_allocation, sizeof(Table::RowSpec) + row_size());
+        auto row = access<Table::RowSpec>(place_for_allocation, sizeof(Table::RowSpec) + row_size());
         row->is_used = 1;
         row->next_row = {};
         std::copy(stream.data().begin(), stream.data().end(), row->row);
     }
+    for (size_t s = 0; s < m_indexes.size(); s++) {
+        auto key = encode_index_key(tuple.value(m_indexes[s].column));
+        if (!key) {
+            continue;
+        }
+        auto result = m_indexes[s].index.insert(*key, place_for_allocation);
+        if (result.is_error()) {
+            // Undo everything done so far, leaving the slot free.
+            for (size_t i = 0; i < s; i++) {
+                if (auto written_key = encode_index_key(tuple.value(m_indexes[i].column))) {
+                    m_indexes[i].index.remove(*written_key, place_for_allocation);
+                }
+            }
+            auto row = access<Table::RowSpec>(place_for_allocation, sizeof(Table::RowSpec) + row_size());
+            (void)row->free_data(*this);
+            row->is_used = 0;
+            row->next_row = next_free_row;
+            return result.release_error();
+        }
+    }
+    m_header.first_free_row = next_free_row;
 
-    // 4. Point last row or header into the newly placed row.
+    // 3. Point last row or header into the newly placed row.
     if (!m_header.last_row_ptr.is_null()) {
         auto last_row = access<Table::RowSpec>(m_header.last_row_ptr);
-        last_row->next_row = *place_for_allocation;
+        last_row->next_row = place_for_allocation;
     }
     else {
-        m_header.first_row_ptr = *place_for_allocation;
+        m_header.first_row_ptr = place_for_allocation;
     }
 
-    // 5. Update headers (EDB: last row, row count; block: rows in block)
-    m_header.last_row_ptr = *place_for_allocation;
+    // 4. Update headers (EDB: last row, row count; block: rows in block)
+    m_header.last_row_ptr = place_for_allocation;
     m_header.row_count = m_header.row_count + 1;
-    access<Table::TableBlock>({ place_for_allocation->block, sizeof(Block) })->rows_in_block++;
-    TRY(flush_header());
+    access<Table::TableBlock>({ place_for_allocation.block, sizeof(Block) })->rows_in_block++;
+
+    // Logged only now, so that a failed insert (which is still followed
+    // by a commit) doesn't leave a record of a row that never existed.
+    if (m_wal) {
+        m_wal->log_insert(m_table_name, tuple);
+    }
+    TRY(flush_header_unless_batched());
     return {};
 }
 
 Util::OsErrorOr<void> EDBFile::remove(HeapPtr row, HeapPtr prev_row) {
-    // 1. Mark row as unused
+    PageScope scope { *m_pages };
+
+    // 1. Drop index entries, while values can still be read
+    if (!m_indexes.empty()) {
+        auto tuple = read_row(row);
+        for (auto& index : m_indexes) {
+            if (auto key = encode_index_key(tuple.value(index.column))) {
+                index.index.remove(*key, row);
+            }
+        }
+    }
+
+    // 2. Mark row as unused
     auto current = access<Table::RowSpec>(row, row_size() + sizeof(Table::RowSpec));
     current->is_used = false;
     // fmt::print("remove before {}..{}..{}\n", prev_row, row, current->next_row);
 
-    // 2. Heap free data
+    // 3. Heap free data
     TRY(current->free_data(*this));
 
-    // 3. Point previous row or header to next row
+    // 4. Point previous row or header to next row
     if (!prev_row.is_null()) {
         auto previous = access<Table::RowSpec>(prev_row);
         previous->next_row = current->next_row;
@@ -459,32 +686,196 @@ Util::OsErrorOr<void> EDBFile::remove(HeapPtr row, HeapPtr prev_row) {
         m_header.first_row_ptr = current->next_row;
     }
 
-    // 4. Update block row count
+    // 5. Update block row count
     access<Table::TableBlock>({ row.block, sizeof(Block) })->rows_in_block--;
 
-    // FIXME: 5. Free block if needed
+    // FIXME: 6. Free block if needed
 
-    // 6. Update main header (last block, row count)
+    // 7. Update main header (last block, row count)
     if (current->next_row.is_null()) {
         m_header.last_row_ptr = prev_row;
     }
     m_header.row_count = m_header.row_count - 1;
-    TRY(flush_header());
+
+    // 8. Give the slot back to the free list
+    current->next_row = m_header.first_free_row;
+    m_header.first_free_row = row;
+
+    if (m_wal) {
+        m_wal->log_remove(m_table_name, row, prev_row);
+    }
+    TRY(flush_header_unless_batched());
+    return {};
+}
+
+Util::OsErrorOr<void> EDBFile::update(HeapPtr row, Core::Tuple const& tuple) {
+    PageScope scope { *m_pages };
+
+    std::optional<Core::Tuple> old_tuple;
+    if (!m_indexes.empty()) {
+        old_tuple = read_row(row);
+    }
+
+    // Nothing is changed until everything that may fail is done, so that
+    // a failed update leaves the row and its index entries as they were.
+    struct KeyChange {
+        Index& index;
+        std::optional<IndexKey> old_key;
+        std::optional<IndexKey> new_key;
+    };
+    std::vector<KeyChange> key_changes;
+    for (auto& index : m_indexes) {
+        auto old_key = encode_index_key(old_tuple->value(index.column));
+        auto new_key = encode_index_key(tuple.value(index.column));
+        if (old_key != new_key) {
+            key_changes.push_back({ .index = index.index, .old_key = std::move(old_key), .new_key = std::move(new_key) });
+        }
+    }
+    auto remove_new_keys = [&](size_t count) {
+        for (size_t s = 0; s < count; s++) {
+            if (key_changes[s].new_key) {
+                key_changes[s].index.remove(*key_changes[s].new_key, row);
+            }
+        }
+    };
+
+    // 1. Index new keys, next to the old ones
+    for (size_t s = 0; s < key_changes.size(); s++) {
+        if (!key_changes[s].new_key) {
+            continue;
+        }
+        auto result = key_changes[s].index.insert(*key_changes[s].new_key, row);
+        if (result.is_error()) {
+            remove_new_keys(s);
+            return result.release_error();
+        }
+    }
+
+    // 2. Write new data, the old data is still in place
+    Util::WritableMemoryStream stream;
+    Util::Writer writer { stream };
+    auto result = Serializer::write_row(*this, writer, m_columns, tuple);
+    if (result.is_error()) {
+        remove_new_keys(key_changes.size());
+        return result.release_error();
+    }
+
+    // 3. Free old data and replace it
+    auto row_spec = access<Table::RowSpec>(row, row_size() + sizeof(Table::RowSpec));
+    TRY(row_spec->free_data(*this));
+    row_spec = access<Table::RowSpec>(row, row_size() + sizeof(Table::RowSpec));
+    std::copy(stream.data().begin(), stream.data().end(), row_spec->row);
+
+    // 4. Drop index entries of old keys
+    for (auto& change : key_changes) {
+        if (change.old_key) {
+            change.index.remove(*change.old_key, row);
+        }
+    }
+
+    if (m_wal) {
+        m_wal->log_update(m_table_name, row, tuple);
+    }
     return {};
 }
 
-size_t EDBFile::row_size() const {
-    size_t size = 0;
+WriteAheadLog::FileImage EDBFile::take_checkpoint_image(std::string file_name) {
+    WriteAheadLog::FileImage image { .file_name = std::move(file_name), .file_size = m_file_size, .extents = {} };
+
+    // Columns are written only on initialization, so only the fixed part
+    // of the header can change.
+    auto header = reinterpret_cast<uint8_t const*>(&m_header);
+    image.extents.push_back({ .offset = 0, .data = { header, header + sizeof(m_header) } });
+
+    // Consecutive dirty blocks are written as one extent.
+    PageScope scope { *m_pages };
+    for (auto block : m_pages->take_dirty_blocks()) {
+        auto data = std::as_const(*m_pages).block(block);
+        auto offset = block_offset(block);
+        if (image.extents.size() > 1 && image.extents.back().offset + image.extents.back().data.size() == offset) {
+            image.extents.back().data.insert(image.extents.back().data.end(), data, data + block_size());
+        }
+        else {
+            image.extents.push_back({ .offset = offset, .data = { data, data + block_size() } });
+        }
+    }
+    return image;
+}
+
+size_t EDBFile::rows_per_table_block() const {
+    return (block_size() - sizeof(Block) - sizeof(Table::TableBlock)) / (sizeof(Table::RowSpec) + row_size());
+}
+
+Core::Tuple EDBFile::read_row(HeapPtr row) const {
+    PageScope scope { *m_pages };
+    // Rows are only read here, so decode them straight from the mapping
+    // instead of copying them (and writing them back) with an access.
+    UnalignedReader reader { mapped_span(row, row_size() + sizeof(Table::RowSpec)) };
+    reader.read<HeapPtr>();
+    reader.read<uint8_t>();
+
+    std::vector<Core::Value> values;
+    values.reserve(m_columns.size());
     for (auto const& column : m_columns) {
-        if (!column.not_null) {
-            size += 1;
+        auto is_null = column.not_null ? false : reader.read<uint8_t>();
+        switch (static_cast<Core::Value::Type>(column.type)) {
+        case Core::Value::Type::Null:
+            ESSA_UNREACHABLE;
+            break;
+        case Core::Value::Type::Int: {
+            auto i = reader.read<LittleEndian<uint32_t>>().value();
+            values.push_back(is_null ? Core::Value::null() : Core::Value::create_int(i));
+            break;
+        }
+        case Core::Value::Type::Float: {
+            auto f = std::bit_cast<float>(reader.read<LittleEndian<uint32_t>>().value());
+            values.push_back(is_null ? Core::Value::null() : Core::Value::create_float(f));
+            break;
+        }
+        case Core::Value::Type::Varchar: {
+            auto span = reader.read<HeapSpan>();
+            if (is_null) {
+                values.push_back(Core::Value::null());
+                break;
+            }
+            std::string string;
+            string.reserve(span.size);
+            for_each_heap_chunk(span, [&](std::span<uint8_t const> chunk) {
+                string.append(reinterpret_cast<char const*>(chunk.data()), chunk.size());
+            });
+            values.push_back(Core::Value::create_varchar(std::move(string)));
+            break;
+        }
+        case Core::Value::Type::Bool: {
+            auto b = reader.read<uint8_t>();
+            values.push_back(is_null ? Core::Value::null() : Core::Value::create_bool(b));
+            break;
+        }
+        case Core::Value::Type::Time: {
+            auto time = reader.read<Date>();
+            values.push_back(is_null ? Core::Value::null() : Core::Value::create_time(Core::Date { .year = time.year, .month = time.month, .day = time.day }));
+            break;
+        }
         }
-        size += value_size_for_type(static_cast<Core::Value::Type>(column.type));
     }
-    return size;
+    return Core::Tuple { values };
+}
+
+std::optional<std::vector<HeapPtr>> EDBFile::find_rows(size_t column, Core::Value const& value) const {
+    PageScope scope { *m_pages };
+    auto index = std::ranges::find_if(m_indexes, [&](auto const& index) { return index.column == column; });
+    if (index == m_indexes.end() || value.type() != static_cast<Core::Value::Type>(m_columns[column].type)) {
+        return {};
+    }
+    auto key = encode_index_key(value);
+    if (!key) {
+        return {};
+    }
+    return index->index.find(*key);
 }
 
 Util::OsErrorOr<std::vector<Core::Column>> EDBFile::read_columns() const {
+    PageScope scope { *m_pages };
     std::vector<Core::Column> columns;
     for (auto const& column : m_columns) {
         columns.push_back(Core::Column {
@@ -522,15 +913,15 @@ Util::OsErrorOr<Value> EDBFile::write_edb_value(Core::Value const& value) {
     case Core::Value::Type::Null:
         ESSA_UNREACHABLE;
     case Core::Value::Type::Int:
-        return Value { .int_value = std::get<int>(value) };
+        return Value { .int_value = value.int_value() };
     case Core::Value::Type::Float:
-        return Value { .float_value = { std::get<float>(value) } };
+        return Value { .float_value = { value.float_value() } };
     case Core::Value::Type::Varchar:
-        return Value { .varchar_value = TRY(copy_to_heap(std::get<std::string>(value))) };
+        return Value { .varchar_value = TRY(copy_to_heap(value.varchar_value())) };
     case Core::Value::Type::Bool:
-        return Value { .bool_value = std::get<bool>(value) };
+        return Value { .bool_value = value.bool_value() };
     case Core::Value::Type::Time: {
-        auto time = std::get<Core::Date>(value);
+        auto time = value.time_value();
         return Value { .time_value = { .year = time.year, .month = static_cast<uint8_t>(time.month), .day = static_cast<uint8_t>(time.day) } };
     }
     }
@@ -538,6 +929,12 @@ Util::OsErrorOr<Value> EDBFile::write_edb_value(Core::Value const& value) {
 }
 
 Util::OsErrorOr<HeapSpan> EDBFile::heap_allocate(size_t size) {
+    if (size > Data::HeapBlock::max_allocation_size(*this)) {
+        auto block_count = (size + big_block_data_size() - 1) / big_block_data_size();
+        auto first_block = TRY(allocate_big_extent(block_count));
+        return HeapSpan { { first_block, sizeof(Block) }, size };
+    }
+
     // fmt::print("Dump before alloc({}):\n", size);
     // m_heap.dump();
     HeapSpan span { TRY(m_heap.alloc(size)), size };
@@ -547,6 +944,10 @@ Util::OsErrorOr<HeapSpan> EDBFile::heap_allocate(size_t size) {
 }
 
 Util::OsErrorOr<void> EDBFile::heap_free(HeapPtr ptr) {
+    if (block_header(ptr.block).type == BlockType::Big) {
+        free_big_extent(ptr.block);
+        return {};
+    }
     return m_heap.free(ptr);
 }
 
@@ -3,13 +3,17 @@
 #include <EssaUtil/Error.hpp>
 #include <EssaUtil/Stream.hpp>
 #include <EssaUtil/Stream/File.hpp>
+#include <algorithm>
 #include <cstddef>
 #include <db/core/Column.hpp>
 #include <db/core/TableSetup.hpp>
 #include <db/storage/edb/AlignedAccess.hpp>
+#include <db/storage/edb/BufferPool.hpp>
 #include <db/storage/edb/Definitions.hpp>
 #include <db/storage/edb/Heap.hpp>
-#include <db/storage/edb/MappedFile.hpp>
+#include <db/storage/edb/Index.hpp>
+#include <db/storage/edb/PageStore.hpp>
+#include <db/storage/edb/WriteAheadLog.hpp>
 #include <memory>
 #include <utility>
 
@@ -20,68 +24,118 @@ public:
     EDBFile(EDBFile const&) = delete;
     ~EDBFile();
 
-    static Util::OsErrorOr<std::unique_ptr<EDBFile>> initialize(Util::File, Db::Core::TableSetup);
-    static Util::OsErrorOr<std::unique_ptr<EDBFile>> open(Util::File);
+    // With `wal`, modifications are logged and kept in memory until they
+    // are written by a checkpoint (see take_checkpoint_image()). With
+    // `buffer_pool`, blocks are cached in the pool instead of mapping the
+    // whole file.
+    static Util::OsErrorOr<std::unique_ptr<EDBFile>> initialize(Util::File, Db::Core::TableSetup, WriteAheadLog* wal = nullptr, BufferPool* buffer_pool = nullptr);
+    static Util::OsErrorOr<std::unique_ptr<EDBFile>> open(Util::File, WriteAheadLog* wal = nullptr, BufferPool* buffer_pool = nullptr);
 
     Util::OsErrorOr<void> rename(std::string const& new_name);
     Util::OsErrorOr<void> insert(Core::Tuple const& tuple);
     Util::OsErrorOr<void> remove(HeapPtr row, HeapPtr prev_row);
+    Util::OsErrorOr<void> update(HeapPtr row, Core::Tuple const& tuple);
+
+    // Copy of everything that was modified since the last call.
+    WriteAheadLog::FileImage take_checkpoint_image(std::string file_name);
+
+    // The last image was written to the file.
+    void finish_checkpoint() { m_pages->finish_checkpoint(); }
+
+    std::string const& table_name() const { return m_table_name; }
+
+    // Header is written to disk only once, on the outermost end_batch(),
+    // instead of after every insert/remove. Batches can be nested.
+    void begin_batch();
+    Util::OsErrorOr<void> end_batch();
 
     Util::OsErrorOr<std::vector<Core::Column>> read_columns() const;
     auto const& header() const { return m_header; }
     auto const& raw_columns() const { return m_columns; }
+    auto const& keys() const { return m_keys; }
+
+    // Decode values of a used row.
+    Core::Tuple read_row(HeapPtr row) const;
+
+    // Rows which may have `value` in `column`, found with an index. Varchars
+    // are compared only by prefix, so candidates need to be checked. This
+    // returns nothing if the lookup can't be done with an index.
+    std::optional<std::vector<HeapPtr>> find_rows(size_t column, Core::Value const& value) const;
+    bool has_index(size_t column) const {
+        return std::ranges::any_of(m_indexes, [&](auto const& index) { return index.column == column; });
+    }
 
     size_t block_size() const;
-    size_t row_size() const;
+    size_t row_size() const { return m_row_size; }
+    size_t rows_per_table_block() const;
 
     template<class T>
     AlignedAccess<T> access(HeapPtr ptr) {
         assert(!ptr.is_null());
         assert(ptr.offset + sizeof(T) <= block_size());
-        auto mapped_ptr = heap_ptr_to_mapped_ptr(ptr);
-        // fmt::print(":: access: {}:{} +{} = {:x}\n", ptr.block, ptr.offset, sizeof(T), mapped_ptr - m_mapped_file.data().data());
-        assert(mapped_ptr + sizeof(T) <= m_mapped_file.data().end().base());
-        return AlignedAccess<T> { mapped_ptr };
+        return AlignedAccess<T> { heap_ptr_to_mapped_ptr(ptr) };
     }
 
     template<class T>
     AllocatingAlignedAccess<T> access(HeapPtr ptr, size_t size) {
         assert(!ptr.is_null());
         assert(ptr.offset + size <= block_size());
-        auto mapped_ptr = heap_ptr_to_mapped_ptr(ptr);
-        // fmt::print(":: allocating access: {}:{} +{} = {:x}\n", ptr.block, ptr.offset, size, mapped_ptr - m_mapped_file.data().data());
-        // fmt::print("   address range: {}..{}\n", fmt::ptr(mapped_ptr), fmt::ptr(mapped_ptr + size));
-        assert(mapped_ptr + size <= m_mapped_file.data().end().base());
-        return AllocatingAlignedAccess<T> { mapped_ptr, size };
+        return AllocatingAlignedAccess<T> { heap_ptr_to_mapped_ptr(ptr), size };
     }
 
     Util::Buffer read_heap(HeapSpan) const;
 
-    void dump_blocks();
-    void dump();
+    // Call `callback` with consecutive parts of data, without copying it.
+    // Big values are split across blocks of their extent.
+    template<class Callback>
+    void for_each_heap_chunk(HeapSpan span, Callback&& callback) const {
+        if (span.size == 0) {
+            return;
+        }
+        if (block_header(span.offset.block).type != BlockType::Big) {
+            callback(mapped_span(span.offset, span.size));
+            return;
+        }
+        size_t remaining = span.size;
+        BlockIndex current_block = span.offset.block;
+        while (remaining > 0) {
+            assert(current_block != 0);
+            auto chunk_size = std::min(remaining, big_block_data_size());
+            callback(mapped_span({ current_block, sizeof(Block) }, chunk_size));
+            remaining -= chunk_size;
+            current_block = block_header(current_block).next_block;
+        }
+    }
 
-    Util::OsErrorOr<HeapSpan> heap_allocate(size_t size);
+    // Direct view into the block. It is invalidated by everything that
+    // can remap the file, e.g. allocations, and is valid only as long as
+    // the block is kept in memory (see PageStore).
+    std::span<uint8_t const> mapped_span(HeapPtr ptr, size_t size) const {
+        assert(!ptr.is_null());
+        assert(ptr.offset + size <= block_size());
+        return { heap_ptr_to_mapped_ptr(ptr), size };
+    }
 
-    Util::OsErrorOr<HeapSpan> copy_to_heap(std::string const& str) {
-        auto span = TRY(heap_allocate_and_get_span(str.size()));
-        std::copy(str.begin(), str.end(), span.mapped_span.begin());
-        return span.heap_span;
+    std::span<uint8_t> mapped_span(HeapPtr ptr, size_t size) {
+        assert(!ptr.is_null());
+        assert(ptr.offset + size <= block_size());
+        return { heap_ptr_to_mapped_ptr(ptr), size };
     }
 
-    struct HeapAllocationResult {
-        HeapSpan heap_span;
-        std::span<uint8_t> mapped_span;
-    };
+    void dump_blocks();
+    void dump();
 
-    Util::OsErrorOr<HeapAllocationResult> heap_allocate_and_get_span(size_t size) {
-        auto span = TRY(heap_allocate(size));
-        return HeapAllocationResult { span, { heap_ptr_to_mapped_ptr(span.offset), span.size } };
-    }
+    // Values that don't fit in a heap block are put into an extent of
+    // `Big` blocks.
+    Util::OsErrorOr<HeapSpan> heap_allocate(size_t size);
 
-    template<class T>
-    Util::OsErrorOr<AllocatingAlignedAccess<T>> heap_allocate(size_t size) {
-        auto addr = TRY(heap_allocate(size));
-        return AllocatingAlignedAccess<T> { heap_ptr_to_mapped_ptr(addr.offset), addr.size };
+    // Write `data` to a span returned by heap_allocate().
+    void write_heap(HeapSpan, std::span<uint8_t const> data);
+
+    Util::OsErrorOr<HeapSpan> copy_to_heap(std::string_view str) {
+        auto span = TRY(heap_allocate(str.size()));
+        write_heap(span, { reinterpret_cast<uint8_t const*>(str.data()), str.size() });
+        return span;
     }
 
     Util::OsErrorOr<void> heap_free(HeapPtr);
@@ -89,25 +143,37 @@ public:
     Core::Value read_edb_value(Core::Value::Type, Value const&) const;
     Util::OsErrorOr<Value> write_edb_value(Core::Value const&);
 
-    // Find first free block or expand file if it is not possible (Max O(n))
+    // Find first free block or expand file if it is not possible (O(1) amortized)
     Util::OsErrorOr<BlockIndex> allocate_block(BlockType);
 
+    Block block_header(BlockIndex) const;
+    size_t big_block_data_size() const { return block_size() - sizeof(Block); }
+
 private:
-    EDBFile(Util::File, MappedFile);
+    EDBFile(Util::File, std::unique_ptr<PageStore>, WriteAheadLog*);
+
+    static Util::OsErrorOr<std::unique_ptr<PageStore>> create_page_store(int fd, size_t size, WriteAheadLog*, BufferPool*);
 
-    uint8_t* heap_ptr_to_mapped_ptr(HeapPtr);
-    uint8_t const* heap_ptr_to_mapped_ptr(HeapPtr) const;
+    // Everything that is written through a mutable accessor counts as
+    // modified.
+    uint8_t* heap_ptr_to_mapped_ptr(HeapPtr ptr) { return m_pages->block(ptr.block) + ptr.offset; }
+    uint8_t const* heap_ptr_to_mapped_ptr(HeapPtr ptr) const { return std::as_const(*m_pages).block(ptr.block) + ptr.offset; }
 
     size_t header_size() const;
     size_t block_offset(BlockIndex) const;
 
     Util::OsErrorOr<void> read_header();
 
+    // Allocate contiguous `Big` blocks, linked with prev/next.
+    Util::OsErrorOr<BlockIndex> allocate_big_extent(size_t block_count);
+    void free_big_extent(BlockIndex first_block);
+
     // Write enough header to make allocate_block() work.
     Util::OsErrorOr<void> write_header_first_pass(Db::Core::TableSetup const&);
 
     Util::OsErrorOr<void> write_header(Db::Core::TableSetup const&);
     Util::OsErrorOr<void> flush_header();
+    Util::OsErrorOr<void> flush_header_unless_batched();
 
     // Add `blocks` blocks to file without initializing them.
     Util::OsErrorOr<void> expand(size_t blocks);
@@ -116,12 +182,24 @@ private:
 
     EDBHeader m_header;
     std::vector<Column> m_columns;
+    std::vector<Key> m_keys;
+
+    struct ColumnIndex {
+        size_t column;
+        Index index;
+    };
+    std::vector<ColumnIndex> m_indexes;
     Data::Heap m_heap { *this };
-    MappedFile m_mapped_file;
+    std::unique_ptr<PageStore> m_pages;
     Util::File m_file;
     std::string m_file_path;
     size_t m_file_size = 0;
+    size_t m_row_size = 0;
     BlockIndex m_block_count = 1;
+    BlockIndex m_free_block_hint = 1;
+    size_t m_batch_depth = 0;
+    std::string m_table_name;
+    WriteAheadLog* m_wal = nullptr;
 };
 
 }
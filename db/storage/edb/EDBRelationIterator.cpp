@@ -2,10 +2,10 @@
 
 #include <EssaUtil/Config.hpp>
 #include <EssaUtil/Error.hpp>
-#include <EssaUtil/Stream/MemoryStream.hpp>
+#include <cstring>
 #include <db/core/Relation.hpp>
 #include <db/storage/edb/Definitions.hpp>
-#include <db/storage/edb/Serializer.hpp>
+#include <utility>
 
 namespace Db::Storage::EDB {
 
@@ -27,21 +27,17 @@ public:
         if (!m_should_write) {
             return;
         }
-        auto row = file().access<Table::RowSpec>(m_row_ptr, file().row_size() + sizeof(Table::RowSpec));
-        row->free_data(file()).release_value_but_fixme_should_propagate_errors();
-        Util::WritableMemoryStream stream;
-        Util::Writer writer { stream };
-        Serializer::write_row(file(), writer, file().raw_columns(), m_tuple).release_value_but_fixme_should_propagate_errors();
-        std::copy(stream.data().begin(), stream.data().end(), row->row);
+        file().update(m_row_ptr, m_tuple).release_value_but_fixme_should_propagate_errors();
     }
 
 private:
     virtual Core::Tuple read() const override {
         return m_tuple;
     }
-    virtual void write(Core::Tuple const& tuple) override {
+    virtual Core::DbErrorOr<void> write(Core::Tuple const& tuple) override {
         m_tuple = tuple;
         m_should_write = true;
+        return {};
     }
     virtual void remove() override {
         file().remove(m_row_ptr, m_prev_row_ptr).release_value_but_fixme_should_propagate_errors();
@@ -59,67 +55,117 @@ private:
     EDBRelationIteratorImpl& m_iterator;
 };
 
-Util::OsErrorOr<std::unique_ptr<Core::RowReference>> EDBRelationIteratorImpl::next_impl() {
+Util::OsErrorOr<std::optional<EDBRelationIteratorImpl::RowPosition>> EDBRelationIteratorImpl::next_position() {
     if (m_row_ptr.is_null()) {
-        return std::unique_ptr<Core::RowReference> {};
+        return std::optional<RowPosition> {};
     }
 
-    auto row = m_file.access<Table::RowSpec>(m_row_ptr, m_file.row_size() + sizeof(Table::RowSpec));
-    // fmt::print("{}..{}..{}\n", m_prev_row_ptr, m_row_ptr, row->next_row);
-    if (!row->is_used) {
+    UnalignedReader reader { std::as_const(m_file).mapped_span(m_row_ptr, sizeof(Table::RowSpec)) };
+    auto next_row = reader.read<HeapPtr>();
+    auto is_used = reader.read<uint8_t>();
+    // fmt::print("{}..{}..{}\n", m_prev_row_ptr, m_row_ptr, next_row);
+    if (!is_used) {
         fmt::print("{} is already freed, aborting\n", m_row_ptr);
         return Util::OsError { 0, "EDBRelationIterator: Row points to freed row" };
     }
 
-    auto prev_row_ptr = m_prev_row_ptr;
+    RowPosition position { .row_ptr = m_row_ptr, .prev_row_ptr = m_prev_row_ptr };
     m_prev_row_ptr = m_row_ptr;
-    m_row_ptr = row->next_row;
-
-    Util::ReadableMemoryStream stream { { row->row, m_file.row_size() } };
-    Util::BinaryReader writer { stream };
+    m_row_ptr = next_row;
+    return position;
+}
 
-    std::vector<Core::Value> values;
-    for (auto const& column : m_file.raw_columns()) {
-        auto is_null = column.not_null ? false : TRY(writer.read_little_endian<uint8_t>());
-        switch (static_cast<Core::Value::Type>(column.type)) {
-        case Core::Value::Type::Null:
-            ESSA_UNREACHABLE;
-            break;
-        case Core::Value::Type::Int: {
-            auto i = TRY(writer.read_little_endian<uint32_t>());
-            values.push_back(is_null ? Core::Value::null() : Core::Value::create_int(i));
-            break;
-        }
-        case Core::Value::Type::Float: {
-            auto f = TRY(writer.read_little_endian<float>());
-            values.push_back(is_null ? Core::Value::null() : Core::Value::create_float(f));
-            break;
-        }
-        case Core::Value::Type::Varchar: {
-            auto span = TRY(writer.read_struct<HeapSpan>());
-            values.push_back(is_null ? Core::Value::null() : Core::Value::create_varchar(m_file.read_heap(span).decode_infallible().encode()));
-            break;
-        }
-        case Core::Value::Type::Bool: {
-            auto b = TRY(writer.read_little_endian<uint8_t>());
-            values.push_back(is_null ? Core::Value::null() : Core::Value::create_bool(b));
-            break;
-        }
-        case Core::Value::Type::Time: {
-            auto time = TRY(writer.read_struct<Date>());
-            values.push_back(is_null ? Core::Value::null() : Core::Value::create_time(Core::Date { .year = time.year, .month = time.month, .day = time.day }));
-            break;
-        }
-        }
+Util::OsErrorOr<std::unique_ptr<Core::RowReference>> EDBRelationIteratorImpl::next_impl() {
+    auto position = TRY(next_position());
+    if (!position) {
+        return std::unique_ptr<Core::RowReference> {};
     }
 
+    auto tuple = m_file.read_row(position->row_ptr);
+
     // fmt::print("D: ");
-    // for (auto const& v : values) {
+    // for (auto const& v : tuple) {
     //     fmt::print("{} ", v.to_debug_string());
     // }
     // fmt::print("\n");
 
-    return std::make_unique<EDBRowReference>(Core::Tuple { values }, m_prev_row_ptr, prev_row_ptr, *this);
+    return std::make_unique<EDBRowReference>(std::move(tuple), position->row_ptr, position->prev_row_ptr, *this);
+}
+
+Core::RowBatch const& EDBRelationIteratorImpl::next_batch(size_t max_rows) {
+    m_batch.reset(max_rows);
+    m_batch_positions.clear();
+    while (m_batch.size() < max_rows) {
+        auto position = next_position().release_value_but_fixme_should_propagate_errors();
+        if (!position) {
+            break;
+        }
+        m_batch.add_owned_row(m_file.read_row(position->row_ptr));
+        m_batch_positions.push_back(*position);
+    }
+    return m_batch;
+}
+
+static Core::DbError os_to_db_error(Util::OsError&& error) {
+    return Core::DbError { fmt::format("OSError: {}: {}", error.function, strerror(error.error)) };
+}
+
+Core::DbErrorOr<void> EDBRelationIteratorImpl::write_batch_row(size_t index, Core::Tuple const& tuple) {
+    TRY(m_file.update(m_batch_positions[index].row_ptr, tuple).map_error(os_to_db_error));
+    return {};
+}
+
+Core::DbErrorOr<void> EDBRelationIteratorImpl::remove_batch_row(size_t index) {
+    auto position = m_batch_positions[index];
+    TRY(m_file.remove(position.row_ptr, position.prev_row_ptr).map_error(os_to_db_error));
+
+    // The row that followed the removed one is now linked to its predecessor.
+    if (index + 1 < m_batch_positions.size() && m_batch_positions[index + 1].prev_row_ptr == position.row_ptr) {
+        m_batch_positions[index + 1].prev_row_ptr = position.prev_row_ptr;
+    }
+    if (m_prev_row_ptr == position.row_ptr) {
+        m_prev_row_ptr = position.prev_row_ptr;
+    }
+    return {};
+}
+
+class EDBFoundRowReference : public Core::RowReference {
+public:
+    explicit EDBFoundRowReference(Core::Tuple tuple)
+        : m_tuple(std::move(tuple)) { }
+
+private:
+    virtual Core::Tuple read() const override { return m_tuple; }
+    virtual Core::DbErrorOr<void> write(Core::Tuple const&) override { ESSA_UNREACHABLE; }
+    virtual void remove() override { ESSA_UNREACHABLE; }
+    virtual std::unique_ptr<RowReference> clone() const override {
+        return std::make_unique<EDBFoundRowReference>(*this);
+    }
+
+    Core::Tuple m_tuple;
+};
+
+std::unique_ptr<Core::RowReference> EDBFoundRowsIteratorImpl::next() {
+    if (m_index == m_rows.size()) {
+        return {};
+    }
+    return std::make_unique<EDBFoundRowReference>(m_file.read_row(m_rows[m_index++]));
+}
+
+Core::Tuple const* EDBFoundRowsIteratorImpl::next_tuple() {
+    if (m_index == m_rows.size()) {
+        return nullptr;
+    }
+    m_tuple = m_file.read_row(m_rows[m_index++]);
+    return &*m_tuple;
+}
+
+Core::RowBatch const& EDBFoundRowsIteratorImpl::next_batch(size_t max_rows) {
+    m_batch.reset(max_rows);
+    while (m_batch.size() < max_rows && m_index < m_rows.size()) {
+        m_batch.add_owned_row(m_file.read_row(m_rows[m_index++]));
+    }
+    return m_batch;
 }
 
 }
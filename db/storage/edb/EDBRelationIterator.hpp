@@ -12,15 +12,44 @@ public:
         , m_row_ptr { file.header().first_row_ptr } { }
 
     virtual std::unique_ptr<Core::RowReference> next() override;
+    virtual Core::RowBatch const& next_batch(size_t max_rows) override;
+    virtual Core::DbErrorOr<void> write_batch_row(size_t index, Core::Tuple const& tuple) override;
+    virtual Core::DbErrorOr<void> remove_batch_row(size_t index) override;
 
 private:
     friend class EDBRowReference;
 
+    struct RowPosition {
+        HeapPtr row_ptr;
+        HeapPtr prev_row_ptr;
+    };
+
     Util::OsErrorOr<std::unique_ptr<Core::RowReference>> next_impl();
+    Util::OsErrorOr<std::optional<RowPosition>> next_position();
 
     EDBFile& m_file;
     HeapPtr m_prev_row_ptr { 0, 0 };
     HeapPtr m_row_ptr;
+    std::vector<RowPosition> m_batch_positions;
+};
+
+// Iterates over rows found with an index, in the given order. Rows can
+// only be read through it.
+class EDBFoundRowsIteratorImpl : public Core::RelationIteratorImpl {
+public:
+    EDBFoundRowsIteratorImpl(EDBFile const& file, std::vector<HeapPtr> rows)
+        : m_file(file)
+        , m_rows(std::move(rows)) { }
+
+    virtual std::unique_ptr<Core::RowReference> next() override;
+    virtual Core::Tuple const* next_tuple() override;
+    virtual Core::RowBatch const& next_batch(size_t max_rows) override;
+
+private:
+    EDBFile const& m_file;
+    std::vector<HeapPtr> m_rows;
+    size_t m_index = 0;
+    std::optional<Core::Tuple> m_tuple;
 };
 
 }
@@ -5,6 +5,9 @@
 #include "db/storage/edb/Definitions.hpp"
 
 #include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
 
 namespace Db::Storage::EDB {
 
@@ -13,6 +16,8 @@ namespace Data {
 struct HeapHeader {
     Signature signature;
     uint32_t size {};
+    // Size of the previous chunk, used for merging with it. 0 for the first chunk.
+    uint32_t prev_size {};
 
     bool has_valid_signature() const {
         return signature == Signature::Empty
@@ -48,76 +53,229 @@ struct HeapHeader {
     }
 };
 
+// Stored at the beginning of data of available chunks. Offsets are of
+// chunk headers, 0 means none.
+struct FreeChunkLinks {
+    uint32_t next;
+    uint32_t prev;
+};
+
+struct HeapBlockHeader {
+    uint32_t free_lists[HeapBlock::SizeClassCount];
+    // Bit N is set if free_lists[N] is not empty.
+    uint32_t non_empty_size_classes;
+};
+
+// Every chunk must be able to hold free list links when it is freed.
+constexpr uint32_t MinimumChunkSize = sizeof(FreeChunkLinks);
+constexpr uint32_t FirstChunkOffset = sizeof(HeapBlockHeader);
+
+static size_t size_class(uint32_t size) {
+    return std::bit_width(size) - 1;
+}
+
+uint32_t HeapBlock::chunk_size_for(size_t size) {
+    return std::max(static_cast<uint32_t>(size), MinimumChunkSize);
+}
+
+std::optional<uint32_t> HeapBlock::largest_free_chunk_size() const {
+    HeapBlockHeader block_header;
+    std::memcpy(&block_header, m_data, sizeof(HeapBlockHeader));
+    if (!block_header.non_empty_size_classes) {
+        return {};
+    }
+    // The biggest chunk is in the highest non-empty size class.
+    uint32_t largest = 0;
+    auto offset = block_header.free_lists[std::bit_width(block_header.non_empty_size_classes) - 1];
+    while (offset) {
+        largest = std::max(largest, header_at(offset).size);
+        FreeChunkLinks links;
+        std::memcpy(&links, m_data + offset + sizeof(HeapHeader), sizeof(FreeChunkLinks));
+        offset = links.next;
+    }
+    return largest;
+}
+
+HeapHeader HeapBlock::header_at(uint32_t offset) const {
+    HeapHeader header;
+    std::memcpy(&header, m_data + offset, sizeof(HeapHeader));
+    return header;
+}
+
+void HeapBlock::set_header(uint32_t offset, HeapHeader const& header) {
+    std::memcpy(m_data + offset, &header, sizeof(HeapHeader));
+}
+
+void HeapBlock::add_to_free_list(uint32_t offset) {
+    AlignedAccess<HeapBlockHeader> block_header { m_data };
+    auto size_class = Data::size_class(header_at(offset).size);
+    auto head = block_header->free_lists[size_class];
+    if (head) {
+        AlignedAccess<FreeChunkLinks> head_links { m_data + head + sizeof(HeapHeader) };
+        head_links->prev = offset;
+    }
+    AlignedAccess<FreeChunkLinks> links { m_data + offset + sizeof(HeapHeader) };
+    *links = { .next = head, .prev = 0 };
+    block_header->free_lists[size_class] = offset;
+    block_header->non_empty_size_classes |= 1u << size_class;
+}
+
+void HeapBlock::remove_from_free_list(uint32_t offset) {
+    AlignedAccess<HeapBlockHeader> block_header { m_data };
+    auto size_class = Data::size_class(header_at(offset).size);
+    AlignedAccess<FreeChunkLinks> links { m_data + offset + sizeof(HeapHeader) };
+    if (links->prev) {
+        AlignedAccess<FreeChunkLinks> prev_links { m_data + links->prev + sizeof(HeapHeader) };
+        prev_links->next = links->next;
+    }
+    else {
+        block_header->free_lists[size_class] = links->next;
+        if (!links->next) {
+            block_header->non_empty_size_classes &= ~(1u << size_class);
+        }
+    }
+    if (links->next) {
+        AlignedAccess<FreeChunkLinks> next_links { m_data + links->next + sizeof(HeapHeader) };
+        next_links->prev = links->prev;
+    }
+}
+
 void HeapBlock::place_edge_headers(EDBFile& file) {
-    AlignedAccess<HeapHeader> start { m_data };
-    *start = HeapHeader { Signature::Empty, static_cast<uint32_t>(data_size(file) - sizeof(HeapHeader) * 2) };
-    AlignedAccess<HeapHeader> end { m_data + data_size(file) - sizeof(HeapHeader) };
-    *end = HeapHeader { Signature::EndEdge };
+    {
+        AlignedAccess<HeapBlockHeader> block_header { m_data };
+        *block_header = {};
+    }
+    auto first_chunk_size = static_cast<uint32_t>(max_allocation_size(file));
+    set_header(FirstChunkOffset, HeapHeader { Signature::Empty, first_chunk_size, 0 });
+    set_header(data_size(file) - sizeof(HeapHeader), HeapHeader { Signature::EndEdge, 0, first_chunk_size });
+    add_to_free_list(FirstChunkOffset);
 }
 
 void HeapBlock::init(EDBFile& file) {
-    place_edge_headers(file);
-
     // Initialize rest of heap with scrub bytes
-    memset(m_data + sizeof(HeapHeader), 0xef, data_size(file) - sizeof(HeapHeader) * 2);
+    memset(m_data + FirstChunkOffset + sizeof(HeapHeader), 0xef, max_allocation_size(file));
+
+    place_edge_headers(file);
 }
 
-Util::OsErrorOr<void> HeapBlock::merge_and_cleanup(EDBFile& edb_file) {
-    // TODO
-    (void)edb_file;
-    return {};
+Util::OsErrorOr<uint32_t> HeapBlock::merge_and_cleanup(EDBFile& file, uint32_t offset) {
+    auto header = header_at(offset);
+
+    // 1. Absorb the next chunk. It is always there, because the last
+    //    chunk is the end edge.
+    auto next_offset = offset + sizeof(HeapHeader) + header.size;
+    if (next_offset + sizeof(HeapHeader) > data_size(file)) {
+        return Util::OsError { .error = 0, .function = "Corruption: EDB HeapBlock::merge_and_cleanup: Out of range without end edge" };
+    }
+    auto next = header_at(next_offset);
+    if (next.is_available()) {
+        remove_from_free_list(next_offset);
+        header.size += sizeof(HeapHeader) + next.size;
+        set_header(next_offset, HeapHeader { Signature::ScrubBytes });
+    }
+
+    // 2. Let the previous chunk absorb this one.
+    if (offset != FirstChunkOffset) {
+        auto prev_offset = offset - sizeof(HeapHeader) - header.prev_size;
+        auto prev = header_at(prev_offset);
+        if (prev.is_available()) {
+            remove_from_free_list(prev_offset);
+            set_header(offset, HeapHeader { Signature::ScrubBytes });
+            prev.size += sizeof(HeapHeader) + header.size;
+            header = prev;
+            offset = prev_offset;
+        }
+    }
+
+    set_header(offset, header);
+
+    // 3. Fix back link of the chunk that follows the merged one.
+    auto following_offset = offset + sizeof(HeapHeader) + header.size;
+    auto following = header_at(following_offset);
+    following.prev_size = header.size;
+    set_header(following_offset, following);
+    return offset;
 }
 
-size_t HeapBlock::data_size(EDBFile& file) const {
+size_t HeapBlock::data_size(EDBFile& file) {
     return file.block_size() - sizeof(HeapBlock) - sizeof(Block);
 }
 
-Util::OsErrorOr<std::optional<uint32_t>> HeapBlock::alloc(EDBFile& file, size_t size) {
-    uint8_t* header_ptr = m_data;
-    while (true) {
-        // printf("HEADER %x size=%u @%p next @%p\n", (uint32_t)header->signature, header->size, header, header->next());
-        AlignedAccess<HeapHeader> header { header_ptr };
-        if (!header->has_valid_signature()) {
-            fmt::print("heap_alloc_impl: Invalid header signature {:x}\n", (uint32_t)header->signature);
-            return Util::OsError { .error = 0, .function = "Corruption: EDB HeapBlock::alloc: Invalid header signature" };
-        }
-        if (header->is_available()) {
-            // Calculate total free size
-            size_t free_size = header->size;
-            if (free_size < size + sizeof(HeapHeader) * 2) {
-                // Skip and try next block.
-            }
-            else {
-                auto distance_to_next_header = header->size - size - sizeof(HeapHeader);
+size_t HeapBlock::max_allocation_size(EDBFile& file) {
+    return data_size(file) - FirstChunkOffset - sizeof(HeapHeader) * 2;
+}
 
-                // Set old header to be used.
-                header->signature = Signature::Used;
-                header->size = size;
+Util::OsErrorOr<std::optional<uint32_t>> HeapBlock::alloc(EDBFile&, size_t size) {
+    auto chunk_size = chunk_size_for(size);
+    auto size_class = Data::size_class(chunk_size);
 
-                // Create a new header after data.
-                AlignedAccess<HeapHeader> new_header { header_ptr + header->size + sizeof(HeapHeader) };
-                *new_header = { Signature::Empty, static_cast<uint32_t>(distance_to_next_header) };
-                return header_ptr - m_data + sizeof(HeapHeader);
+    // 1. Find a chunk. Chunks in higher size classes always fit, so the
+    //    rest of the own class is searched only if the list head doesn't
+    //    fit and there are no bigger chunks.
+    uint32_t offset = 0;
+    {
+        AlignedAccess<HeapBlockHeader> block_header { m_data };
+        auto head = block_header->free_lists[size_class];
+        auto higher_classes = size_class + 1 < SizeClassCount ? block_header->non_empty_size_classes & ~((2u << size_class) - 1) : 0;
+        if (head && header_at(head).size >= chunk_size) {
+            offset = head;
+        }
+        else if (higher_classes) {
+            offset = block_header->free_lists[std::countr_zero(higher_classes)];
+        }
+        else {
+            for (auto candidate = head; candidate;) {
+                if (header_at(candidate).size >= chunk_size) {
+                    offset = candidate;
+                    break;
+                }
+                AlignedAccess<FreeChunkLinks> links { m_data + candidate + sizeof(HeapHeader) };
+                candidate = links->next;
+            }
+            if (!offset) {
+                return std::optional<uint32_t> {};
             }
         }
+    }
 
-        // Check for overflow
-        if (header->signature == Signature::EndEdge) {
-            return std::optional<uint32_t> {};
-        }
+    auto header = header_at(offset);
+    if (!header.is_available()) {
+        fmt::print("heap_alloc_impl: Invalid header signature {:x}\n", (uint32_t)header.signature);
+        return Util::OsError { .error = 0, .function = "Corruption: EDB HeapBlock::alloc: Free list points to used chunk" };
+    }
+    remove_from_free_list(offset);
 
-        // Try out next header, if it exists.
-        header_ptr += header->size + sizeof(HeapHeader);
-        if (header_ptr > m_data + data_size(file)) {
-            return Util::OsError { .error = 0, .function = "Corruption: EDB HeapBlock::alloc: Out of range without end edge" };
-        }
+    // 2. Split off the rest of chunk if it can hold another one.
+    if (header.size >= chunk_size + sizeof(HeapHeader) + MinimumChunkSize) {
+        auto rest_offset = offset + sizeof(HeapHeader) + chunk_size;
+        auto rest_size = static_cast<uint32_t>(header.size - chunk_size - sizeof(HeapHeader));
+        set_header(rest_offset, HeapHeader { Signature::Freed, rest_size, chunk_size });
+
+        auto following_offset = rest_offset + sizeof(HeapHeader) + rest_size;
+        auto following = header_at(following_offset);
+        following.prev_size = rest_size;
+        set_header(following_offset, following);
+
+        add_to_free_list(rest_offset);
+        header.size = chunk_size;
     }
+
+    header.signature = Signature::Used;
+    set_header(offset, header);
+    return offset + sizeof(HeapHeader);
 }
 
-Util::OsErrorOr<void> HeapBlock::free(uint32_t offset) {
-    AlignedAccess<HeapHeader> header { m_data + offset - sizeof(HeapHeader) };
-    header->signature = Signature::Freed;
-    // TODO: Merge and cleanup
+Util::OsErrorOr<void> HeapBlock::free(EDBFile& file, uint32_t offset) {
+    auto header_offset = offset - sizeof(HeapHeader);
+    auto header = header_at(header_offset);
+    if (header.signature != Signature::Used) {
+        return Util::OsError { .error = 0, .function = "Corruption: EDB HeapBlock::free: Freeing chunk that is not used" };
+    }
+    header.signature = Signature::Freed;
+    set_header(header_offset, header);
+
+    auto merged_offset = TRY(merge_and_cleanup(file, header_offset));
+    add_to_free_list(merged_offset);
     return {};
 }
 
@@ -127,63 +285,98 @@ void HeapBlock::leak_check() {
 
 void HeapBlock::dump(EDBFile& file, BlockIndex index) {
     fmt::print("HeapBlock {}\n", index);
-    uint8_t* header_ptr = m_data;
+    uint32_t header_offset = FirstChunkOffset;
     while (true) {
-        AlignedAccess<HeapHeader> header { header_ptr };
-        fmt::print("- {:05x}: ", header_ptr - m_data);
-        if (!header->has_valid_signature()) {
-            fmt::print("INVALID({:08x})", static_cast<uint32_t>(header->signature));
+        auto header = header_at(header_offset);
+        fmt::print("- {:05x}: ", header_offset);
+        if (!header.has_valid_signature()) {
+            fmt::print("INVALID({:08x})", static_cast<uint32_t>(header.signature));
         }
         else {
-            fmt::print("{} ", header->signature_string());
+            fmt::print("{} ", header.signature_string());
         }
-        fmt::print(" size={}\n", header->size);
-        header_ptr += header->size + sizeof(HeapHeader);
-        if (header_ptr + sizeof(HeapHeader) > m_data + data_size(file)) {
+        fmt::print(" size={} prev_size={}\n", header.size, header.prev_size);
+        header_offset += header.size + sizeof(HeapHeader);
+        if (header_offset + sizeof(HeapHeader) > data_size(file)) {
             break;
         }
     }
 }
 
-Util::OsErrorOr<HeapPtr> Heap::alloc(size_t size) {
-    if (size > m_file.block_size() - sizeof(HeapHeader)) {
-        return Util::OsError { .error = 0, .function = "TODO: Big blocks" };
+// Heap blocks are accessed in place, copying the whole block for every
+// (de)allocation would make them O(block size).
+static HeapBlock& heap_block_at(EDBFile& file, BlockIndex block) {
+    return *reinterpret_cast<HeapBlock*>(file.mapped_span(HeapPtr { block, sizeof(Block) }, file.block_size() - sizeof(Block)).data());
+}
+
+// Doesn't mark the block as modified.
+static HeapBlock const& heap_block_at(EDBFile const& file, BlockIndex block) {
+    return *reinterpret_cast<HeapBlock const*>(file.mapped_span(HeapPtr { block, sizeof(Block) }, file.block_size() - sizeof(Block)).data());
+}
+
+Util::OsErrorOr<void> Heap::build_directory() {
+    // Note: First heap block is always 2.
+    BlockIndex current_block = 2;
+    while (current_block) {
+        auto block = m_file.block_header(current_block);
+        if (block.type != BlockType::Heap) {
+            return Util::OsError { .error = 0, .function = "Corruption: Found non-heap block in heap block list" };
+        }
+        update_directory(current_block);
+        current_block = block.next_block;
     }
+    m_directory_built = true;
+    return {};
+}
 
-    // First, try to allocate in every block in the list.
-    {
-        // Note: First heap block is always 2.
-        size_t current_block = 2;
-        while (true) {
-            auto block = m_file.access<Block>(HeapPtr { current_block, 0 }, m_file.block_size());
-            if (block->type != BlockType::Heap) {
-                return Util::OsError { .error = 0, .function = "Corruption: Found non-heap block in heap block list" };
-            }
+void Heap::update_directory(BlockIndex block) {
+    auto it = m_largest_free_chunk_of_block.find(block);
+    if (it != m_largest_free_chunk_of_block.end()) {
+        m_blocks_by_largest_free_chunk.erase({ it->second, block });
+        m_largest_free_chunk_of_block.erase(it);
+    }
+    auto largest = heap_block_at(std::as_const(m_file), block).largest_free_chunk_size();
+    if (largest) {
+        m_blocks_by_largest_free_chunk.insert({ *largest, block });
+        m_largest_free_chunk_of_block.insert({ block, *largest });
+    }
+}
 
-            auto& heap_block = reinterpret_cast<HeapBlock&>(block->data);
-            auto result = TRY(heap_block.alloc(m_file, size));
-            if (result) {
-                return HeapPtr { current_block, *result + sizeof(Block) };
-            }
-            // FIXME: Merge&cleanup here
+Util::OsErrorOr<HeapPtr> Heap::alloc(size_t size) {
+    if (size > HeapBlock::max_allocation_size(m_file)) {
+        return Util::OsError { .error = 0, .function = "EDB Heap::alloc: Value too big for heap block" };
+    }
+    if (!m_directory_built) {
+        TRY(build_directory());
+    }
 
-            if (!block->next_block) {
-                break;
-            }
-            current_block = block->next_block;
+    auto try_alloc_in_block = [&](BlockIndex block) -> Util::OsErrorOr<std::optional<HeapPtr>> {
+        auto result = TRY(heap_block_at(m_file, block).alloc(m_file, size));
+        update_directory(block);
+        if (!result) {
+            return std::optional<HeapPtr> {};
         }
+        return HeapPtr { block, static_cast<uint32_t>(*result + sizeof(Block)) };
+    };
+
+    // 1. Take the block with the smallest biggest chunk that still fits.
+    auto it = m_blocks_by_largest_free_chunk.lower_bound({ HeapBlock::chunk_size_for(size), 0 });
+    if (it != m_blocks_by_largest_free_chunk.end()) {
+        auto result = TRY(try_alloc_in_block(it->second));
+        if (!result) {
+            return Util::OsError { .error = 0, .function = "Corruption: EDB Heap::alloc: Block doesn't fit despite its free lists" };
+        }
+        return *result;
     }
 
-    // If there is free space in existing blocks, allocate a new block
+    // 2. If there is no free space in existing blocks, allocate a new block
     auto new_block_idx = TRY(m_file.allocate_block(BlockType::Heap));
-    auto block = m_file.access<Block>(HeapPtr { new_block_idx, 0 }, m_file.block_size());
-    auto& heap_block = reinterpret_cast<HeapBlock&>(block->data);
-    auto result = TRY(heap_block.alloc(m_file, size));
+    auto result = TRY(try_alloc_in_block(new_block_idx));
     if (!result) {
         // We should always have space in a newly allocated block!
         ESSA_UNREACHABLE;
     }
-    return HeapPtr { new_block_idx, *result + sizeof(Block) };
+    return *result;
 }
 
 void Heap::dump() const {
@@ -198,9 +391,10 @@ void Heap::leak_check() const {
 }
 
 Util::OsErrorOr<void> Heap::free(HeapPtr ptr) {
-    auto block = m_file.access<HeapBlock>(HeapPtr { ptr.block, sizeof(Block) }, m_file.block_size() - sizeof(Block));
-    TRY(block->free(ptr.offset - sizeof(Block)));
-    block.flush();
+    TRY(heap_block_at(m_file, ptr.block).free(m_file, ptr.offset - sizeof(Block)));
+    if (m_directory_built) {
+        update_directory(ptr.block);
+    }
     return {};
 }
 
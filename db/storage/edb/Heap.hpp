@@ -3,6 +3,9 @@
 #include <EssaUtil/Error.hpp>
 #include <db/storage/edb/AlignedAccess.hpp>
 #include <db/storage/edb/Definitions.hpp>
+#include <map>
+#include <optional>
+#include <set>
 
 namespace Db::Storage::EDB {
 
@@ -36,18 +39,42 @@ enum class Signature : uint32_t {
     ScrubBytes = 0xDEDEDEDE, // There was previously a header, but it was removed (e.g. because of merge)
 };
 
+struct HeapHeader;
+
+// Free chunks are kept in segregated lists, one per power-of-two size
+// class, so that finding a chunk is O(1). Freed chunks are merged with
+// free neighbours immediately.
 class HeapBlock {
 public:
+    static constexpr size_t SizeClassCount = 32;
+
     void init(EDBFile&);
     Util::OsErrorOr<std::optional<uint32_t>> alloc(EDBFile&, size_t size);
-    Util::OsErrorOr<void> free(uint32_t offset);
+    Util::OsErrorOr<void> free(EDBFile&, uint32_t offset);
     void leak_check();
     void dump(EDBFile&, BlockIndex);
 
+    static size_t max_allocation_size(EDBFile&);
+    // Size of the chunk that alloc() needs for `size` bytes.
+    static uint32_t chunk_size_for(size_t size);
+
+    // Size of the biggest available chunk, if any. alloc() succeeds if
+    // and only if the needed chunk is not bigger than this.
+    std::optional<uint32_t> largest_free_chunk_size() const;
+
 private:
     void place_edge_headers(EDBFile&);
-    Util::OsErrorOr<void> merge_and_cleanup(EDBFile&);
-    size_t data_size(EDBFile&) const;
+
+    // Merge chunk at `offset` with free neighbours. Returns offset of the
+    // resulting chunk.
+    Util::OsErrorOr<uint32_t> merge_and_cleanup(EDBFile&, uint32_t offset);
+
+    static size_t data_size(EDBFile&);
+
+    HeapHeader header_at(uint32_t offset) const;
+    void set_header(uint32_t offset, HeapHeader const&);
+    void add_to_free_list(uint32_t offset);
+    void remove_from_free_list(uint32_t offset);
 
     uint8_t m_data[0];
 };
@@ -63,7 +90,17 @@ public:
     Util::OsErrorOr<void> free(HeapPtr);
 
 private:
+    Util::OsErrorOr<void> build_directory();
+    void update_directory(BlockIndex);
+
     EDBFile& m_file;
+
+    // Heap blocks ordered by size of their biggest free chunk, so that
+    // alloc() finds a block that fits with one lookup. This is built from
+    // free lists stored in heap blocks.
+    std::set<std::pair<uint32_t, BlockIndex>> m_blocks_by_largest_free_chunk;
+    std::map<BlockIndex, uint32_t> m_largest_free_chunk_of_block;
+    bool m_directory_built = false;
 };
 
 }
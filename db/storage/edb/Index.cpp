@@ -0,0 +1,319 @@
+#include "Index.hpp"
+
+#include "EDBFile.hpp"
+
+#include <EssaUtil/Config.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+namespace Db::Storage::EDB {
+
+namespace {
+
+struct [[gnu::packed]] Entry {
+    uint8_t key[sizeof(IndexKey)];
+    HeapPtr row;
+    // Internal nodes only: child with entries not less than this one.
+    LittleEndian<BlockIndex> child;
+};
+
+struct [[gnu::packed]] Node {
+    uint8_t is_leaf;
+    LittleEndian<uint16_t> entry_count;
+    // Leaves: next leaf in key order (0 for the last one). Internal nodes:
+    // child with entries less than the first entry.
+    LittleEndian<BlockIndex> link;
+    Entry entries[0];
+};
+
+// Nodes are accessed in place, like heap blocks.
+Node& node_at(EDBFile& file, BlockIndex block) {
+    return *reinterpret_cast<Node*>(file.mapped_span(HeapPtr { block, sizeof(Block) }, file.block_size() - sizeof(Block)).data());
+}
+
+Node const& node_at(EDBFile const& file, BlockIndex block) {
+    return *reinterpret_cast<Node const*>(file.mapped_span(HeapPtr { block, sizeof(Block) }, file.block_size() - sizeof(Block)).data());
+}
+
+size_t node_capacity(EDBFile const& file) {
+    return std::min<size_t>((file.block_size() - sizeof(Block) - sizeof(Node)) / sizeof(Entry), UINT16_MAX);
+}
+
+int compare(IndexKey const& key, HeapPtr row, Entry const& entry) {
+    if (auto result = std::memcmp(key.data(), entry.key, key.size()); result != 0) {
+        return result;
+    }
+    if (row.block != entry.row.block) {
+        return row.block < entry.row.block ? -1 : 1;
+    }
+    if (row.offset != entry.row.offset) {
+        return row.offset < entry.row.offset ? -1 : 1;
+    }
+    return 0;
+}
+
+// Index of the first entry that is not less than (key, row).
+size_t lower_bound(Node const& node, IndexKey const& key, HeapPtr row) {
+    size_t begin = 0;
+    size_t end = node.entry_count;
+    while (begin < end) {
+        auto middle = (begin + end) / 2;
+        if (compare(key, row, node.entries[middle]) > 0) {
+            begin = middle + 1;
+        }
+        else {
+            end = middle;
+        }
+    }
+    return begin;
+}
+
+// Index of the first entry that is greater than (key, row).
+size_t upper_bound(Node const& node, IndexKey const& key, HeapPtr row) {
+    size_t begin = 0;
+    size_t end = node.entry_count;
+    while (begin < end) {
+        auto middle = (begin + end) / 2;
+        if (compare(key, row, node.entries[middle]) >= 0) {
+            begin = middle + 1;
+        }
+        else {
+            end = middle;
+        }
+    }
+    return begin;
+}
+
+void write_big_endian(uint8_t* output, uint64_t value, size_t size) {
+    for (size_t s = 0; s < size; s++) {
+        output[s] = value >> ((size - s - 1) * 8);
+    }
+}
+
+}
+
+std::optional<IndexKey> encode_index_key(Core::Value const& value) {
+    IndexKey key {};
+    switch (value.type()) {
+    case Core::Value::Type::Null:
+        return {};
+    case Core::Value::Type::Int:
+        // Flip the sign bit so that negative numbers go first.
+        write_big_endian(key.data(), std::bit_cast<uint32_t>(value.int_value()) ^ 0x80000000, 4);
+        break;
+    case Core::Value::Type::Float: {
+        // -0 is equal to 0. Negative numbers are ordered by reversed
+        // magnitude, positive numbers just need to go after them.
+        auto bits = std::bit_cast<uint32_t>(value.float_value() == 0 ? 0.f : value.float_value());
+        write_big_endian(key.data(), bits & 0x80000000 ? ~bits : bits | 0x80000000, 4);
+        break;
+    }
+    case Core::Value::Type::Varchar: {
+        auto string = value.varchar_value();
+        std::copy_n(string.begin(), std::min(string.size(), key.size()), key.begin());
+        break;
+    }
+    case Core::Value::Type::Bool:
+        key[0] = value.bool_value();
+        break;
+    case Core::Value::Type::Time: {
+        // Only the date is stored in EDB.
+        auto date = value.time_value();
+        write_big_endian(key.data(), date.year, 2);
+        key[2] = date.month;
+        key[3] = date.day;
+        break;
+    }
+    }
+    return key;
+}
+
+struct Index::Separator {
+    IndexKey key;
+    HeapPtr row;
+    BlockIndex child;
+};
+
+Util::OsErrorOr<BlockIndex> Index::create(EDBFile& file) {
+    auto root = TRY(file.allocate_block(BlockType::Index));
+    auto& node = node_at(file, root);
+    node.is_leaf = 1;
+    node.entry_count = 0;
+    node.link = 0;
+    return root;
+}
+
+BlockIndex Index::find_leaf(IndexKey const& key, HeapPtr row, std::vector<BlockIndex>* path) const {
+    BlockIndex current = m_root;
+    while (true) {
+        auto const& node = node_at(std::as_const(m_file), current);
+        if (node.is_leaf) {
+            return current;
+        }
+        if (path) {
+            path->push_back(current);
+        }
+        auto index = upper_bound(node, key, row);
+        current = index == 0 ? node.link.value() : node.entries[index - 1].child.value();
+    }
+}
+
+Util::OsErrorOr<void> Index::insert(IndexKey const& key, HeapPtr row) {
+    std::vector<BlockIndex> path;
+    BlockIndex current = find_leaf(key, row, &path);
+    std::optional<Separator> separator = Separator { key, row, 0 };
+
+    // Split nodes bottom-up as long as they overflow.
+    while (true) {
+        separator = TRY(insert_into_node(current, *separator));
+        if (!separator) {
+            return {};
+        }
+        assert(!path.empty());
+        current = path.back();
+        path.pop_back();
+    }
+}
+
+Util::OsErrorOr<std::optional<Index::Separator>> Index::insert_into_node(BlockIndex block, Separator const& separator) {
+    auto to_entry = [](Separator const& separator) {
+        Entry entry;
+        std::ranges::copy(separator.key, entry.key);
+        entry.row = separator.row;
+        entry.child = separator.child;
+        return entry;
+    };
+
+    {
+        auto& node = node_at(m_file, block);
+        auto position = lower_bound(node, separator.key, separator.row);
+        if (position < node.entry_count && compare(separator.key, separator.row, node.entries[position]) == 0) {
+            // Already indexed.
+            return std::optional<Separator> {};
+        }
+        if (node.entry_count < node_capacity(m_file)) {
+            std::memmove(&node.entries[position + 1], &node.entries[position], (node.entry_count - position) * sizeof(Entry));
+            node.entries[position] = to_entry(separator);
+            node.entry_count = node.entry_count + 1;
+            return std::optional<Separator> {};
+        }
+    }
+
+    // 1. Node is full, gather all entries and split them in halves.
+    //    Note: Allocating may move the mapping, so nodes are accessed
+    //    again after that.
+    std::vector<Entry> entries;
+    bool is_leaf;
+    BlockIndex link;
+    {
+        auto const& node = node_at(std::as_const(m_file), block);
+        entries.assign(node.entries, node.entries + node.entry_count);
+        is_leaf = node.is_leaf;
+        link = node.link;
+        auto position = lower_bound(node, separator.key, separator.row);
+        entries.insert(entries.begin() + position, to_entry(separator));
+    }
+    auto middle = entries.size() / 2;
+
+    // For leaves, the middle entry is the first one of the right node. For
+    // internal nodes, it's moved to the parent and its child becomes the
+    // leftmost child of the right node.
+    auto right_block = TRY(m_file.allocate_block(BlockType::Index));
+    auto left_block = block == m_root ? TRY(m_file.allocate_block(BlockType::Index)) : block;
+
+    auto fill = [&](BlockIndex target, BlockIndex target_link, std::span<Entry const> target_entries) {
+        auto& node = node_at(m_file, target);
+        node.is_leaf = is_leaf;
+        node.entry_count = target_entries.size();
+        node.link = target_link;
+        std::ranges::copy(target_entries, node.entries);
+    };
+    std::span<Entry const> all_entries = entries;
+    if (is_leaf) {
+        fill(left_block, right_block, all_entries.first(middle));
+        fill(right_block, block == m_root ? 0 : link, all_entries.subspan(middle));
+    }
+    else {
+        fill(left_block, link, all_entries.first(middle));
+        fill(right_block, entries[middle].child, all_entries.subspan(middle + 1));
+    }
+
+    Separator promoted { {}, entries[middle].row, right_block };
+    std::ranges::copy(entries[middle].key, promoted.key.begin());
+
+    // 2. Root stays in place, as an internal node pointing to both halves.
+    if (block == m_root) {
+        auto& root = node_at(m_file, m_root);
+        root.is_leaf = 0;
+        root.entry_count = 1;
+        root.link = left_block;
+        root.entries[0] = to_entry(promoted);
+        return std::optional<Separator> {};
+    }
+    return promoted;
+}
+
+void Index::remove(IndexKey const& key, HeapPtr row) {
+    auto leaf = find_leaf(key, row, nullptr);
+    auto& node = node_at(m_file, leaf);
+    auto position = lower_bound(node, key, row);
+    if (position == node.entry_count || compare(key, row, node.entries[position]) != 0) {
+        return;
+    }
+    std::memmove(&node.entries[position], &node.entries[position + 1], (node.entry_count - position - 1) * sizeof(Entry));
+    node.entry_count = node.entry_count - 1;
+}
+
+std::vector<HeapPtr> Index::find(IndexKey const& key) const {
+    std::vector<HeapPtr> rows;
+    HeapPtr const first_row { 0, 0 };
+    BlockIndex current = find_leaf(key, first_row, nullptr);
+    size_t position = lower_bound(node_at(std::as_const(m_file), current), key, first_row);
+
+    // Equal keys may continue in next leaves.
+    while (current != 0) {
+        auto const& node = node_at(std::as_const(m_file), current);
+        for (; position < node.entry_count; position++) {
+            auto const& entry = node.entries[position];
+            if (!std::equal(key.begin(), key.end(), entry.key)) {
+                return rows;
+            }
+            rows.push_back(entry.row);
+        }
+        current = node.link;
+        position = 0;
+    }
+    return rows;
+}
+
+void Index::dump() const {
+    fmt::print("Index @{}:\n", m_root);
+    dump_node(m_root, 1);
+}
+
+void Index::dump_node(BlockIndex block, size_t depth) const {
+    auto const& node = node_at(std::as_const(m_file), block);
+    fmt::print("{:>{}}{} @{} ({} entries, link={})\n", "", depth * 2, node.is_leaf ? "Leaf" : "Node", block, node.entry_count, node.link);
+    for (size_t s = 0; s < node.entry_count; s++) {
+        auto const& entry = node.entries[s];
+        fmt::print("{:>{}}", "", depth * 2 + 2);
+        for (auto byte : entry.key) {
+            fmt::print("{:02x}", byte);
+        }
+        fmt::print(" -> {}", entry.row);
+        if (!node.is_leaf) {
+            fmt::print(" child={}", entry.child);
+        }
+        fmt::print("\n");
+    }
+    if (!node.is_leaf) {
+        dump_node(node.link, depth + 1);
+        for (size_t s = 0; s < node.entry_count; s++) {
+            dump_node(node_at(std::as_const(m_file), block).entries[s].child, depth + 1);
+        }
+    }
+}
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <EssaUtil/Error.hpp>
+#include <array>
+#include <db/core/Value.hpp>
+#include <db/storage/edb/Definitions.hpp>
+#include <optional>
+#include <vector>
+
+namespace Db::Storage::EDB {
+
+// Values are encoded so that equal values have equal keys and the order
+// of keys follows the order of values. Varchars are truncated, so rows
+// found by a key must be compared with the actual value.
+using IndexKey = std::array<uint8_t, 16>;
+
+// NULLs are not indexed, this returns nothing for them.
+std::optional<IndexKey> encode_index_key(Core::Value const&);
+
+// B+tree of (key, row) pairs stored in `Index` blocks. Entries with the
+// same key are ordered by row pointer, so every entry is unique.
+//
+// Root block never changes: when it's split, its contents are moved to
+// new blocks instead. Nodes are not merged on removal, emptied leaves just
+// stay in the tree until new entries fall into them.
+class Index {
+public:
+    Index(EDBFile& file, BlockIndex root)
+        : m_file(file)
+        , m_root(root) { }
+
+    // Allocate root block of an empty index.
+    static Util::OsErrorOr<BlockIndex> create(EDBFile&);
+
+    BlockIndex root() const { return m_root; }
+
+    Util::OsErrorOr<void> insert(IndexKey const&, HeapPtr row);
+    void remove(IndexKey const&, HeapPtr row);
+
+    // Rows of all entries with `key`, in order.
+    std::vector<HeapPtr> find(IndexKey const&) const;
+
+    void dump() const;
+
+private:
+    struct Separator;
+
+    BlockIndex find_leaf(IndexKey const&, HeapPtr row, std::vector<BlockIndex>* path) const;
+    Util::OsErrorOr<std::optional<Separator>> insert_into_node(BlockIndex, Separator const&);
+    void dump_node(BlockIndex, size_t depth) const;
+
+    EDBFile& m_file;
+    BlockIndex m_root;
+};
+
+}
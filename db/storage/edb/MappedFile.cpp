@@ -1,54 +1,94 @@
 #include "MappedFile.hpp"
 
 #include <EssaUtil/Config.hpp>
+#include <algorithm>
+#include <cstring>
 #include <db/storage/edb/Definitions.hpp>
 #include <sys/mman.h>
 #include <unistd.h>
 
 namespace Db::Storage::EDB {
 
-Util::OsErrorOr<MappedFile> MappedFile::map(int fd, size_t size) {
+// Reserving address space is free (no memory or swap is committed), so
+// reserve enough for tables to never be moved in practice.
+constexpr size_t MinimumReservation = sizeof(void*) >= 8 ? (size_t)16 << 30 : (size_t)64 << 20;
+
+static size_t page_align_up(size_t size) {
+    static size_t const page_size = sysconf(_SC_PAGESIZE);
+    return (size + page_size - 1) / page_size * page_size;
+}
+
+Util::OsErrorOr<MappedFile> MappedFile::map(int fd, size_t size, Mode mode) {
     // fmt::print("MappedFile::map(size={})\n", size);
     MappedFile file;
     file.m_fd = fd;
-    file.m_size = size;
-    if (size == 0) {
-        return file;
+    file.m_mode = mode;
+    TRY(file.reserve(std::max(MinimumReservation, page_align_up(size))));
+    TRY(file.remap(size));
+    // file.dump();
+    return file;
+}
+
+Util::OsErrorOr<void> MappedFile::reserve(size_t size) {
+    auto ptr = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return Util::OsError { .error = errno, .function = "MappedFile::reserve" };
     }
-    // fmt::print("size = {}\n", size);
-    auto ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    m_ptr = ptr;
+    m_reserved_size = size;
+    return {};
+}
+
+Util::OsErrorOr<void> MappedFile::map_range(size_t begin, size_t end) {
+    auto flags = m_mode == Mode::Shared ? MAP_SHARED : MAP_PRIVATE;
+    auto ptr = mmap(static_cast<uint8_t*>(m_ptr) + begin, end - begin, PROT_READ | PROT_WRITE, flags | MAP_FIXED, m_fd, begin);
     if (ptr == MAP_FAILED) {
-        return Util::OsError { .error = errno, .function = "MappedFile::map" };
+        return Util::OsError { .error = errno, .function = "MappedFile::map_range" };
     }
-    file.m_ptr = ptr;
-    // file.dump();
-    return file;
+    return {};
 }
 
 Util::OsErrorOr<void> MappedFile::remap(size_t new_size) {
-    msync(m_ptr, m_size, MS_SYNC);
-    munmap(m_ptr, m_size);
+    auto new_mapped_size = page_align_up(new_size);
+    if (new_mapped_size > m_reserved_size) {
+        // Out of reserved address space, move everything to a twice as big
+        // reservation. This invalidates all pointers into the mapping.
+        auto old_ptr = m_ptr;
+        auto old_reserved_size = m_reserved_size;
+        auto old_size = m_size;
+        TRY(reserve(std::max(new_mapped_size, m_reserved_size * 2)));
+        m_mapped_size = 0;
+        if (m_mode == Mode::Private) {
+            // Changes exist only in the old mapping, carry them over.
+            TRY(map_range(0, new_mapped_size));
+            m_mapped_size = new_mapped_size;
+            std::memcpy(m_ptr, old_ptr, old_size);
+        }
+        munmap(old_ptr, old_reserved_size);
+    }
     // fmt::print("old size = {} new size = {}\n", m_size, new_size);
-    auto ptr = mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
-    if (ptr == MAP_FAILED) {
-        return Util::OsError { .error = errno, .function = "MappedFile::remap" };
+
+    // Pages that are already mapped stay where they are, the ones past the
+    // old end of file are mapped into the reservation right after them.
+    if (new_mapped_size > m_mapped_size) {
+        TRY(map_range(m_mapped_size, new_mapped_size));
+        m_mapped_size = new_mapped_size;
     }
-    // fmt::print("remap {}+{} -> {}+{}\n", fmt::ptr(m_ptr), m_size, fmt::ptr(ptr), new_size);
-    // fmt::print("address range: {:p}..{:p}\n", fmt::ptr(ptr), fmt::ptr((uint8_t*)ptr + new_size));
-    m_ptr = ptr;
     m_size = new_size;
     // dump();
     return {};
 }
 
 void MappedFile::dump() const {
-    fmt::print("MappedFile[{} +{}]\n", fmt::ptr(m_ptr), m_size);
+    fmt::print("MappedFile[{} +{}, reserved {}]\n", fmt::ptr(m_ptr), m_size, m_reserved_size);
 }
 
 MappedFile::~MappedFile() {
     if (m_ptr) {
-        msync(m_ptr, m_size, MS_SYNC);
-        munmap(m_ptr, m_size);
+        if (m_mode == Mode::Shared) {
+            msync(m_ptr, m_mapped_size, MS_SYNC);
+        }
+        munmap(m_ptr, m_reserved_size);
     }
 }
 
@@ -6,8 +6,20 @@
 
 namespace Db::Storage::EDB {
 
+// Shared mapping of a file that can grow. A large address range is reserved
+// upfront and the file is mapped at its beginning, so that growing the file
+// maps only the new pages and pointers into the mapping stay valid. Only
+// when the reservation is exhausted the mapping is moved.
 class MappedFile {
 public:
+    enum class Mode {
+        // Changes are written back to the file by the kernel.
+        Shared,
+        // Changes are never written back, the owner is responsible for
+        // writing them (see WriteAheadLog).
+        Private,
+    };
+
     MappedFile(MappedFile const&) = delete;
     MappedFile& operator=(MappedFile const&) = delete;
     MappedFile(MappedFile&& other) { *this = std::move(other); }
@@ -18,14 +30,18 @@ public:
         }
         this->~MappedFile();
         m_fd = std::exchange(other.m_fd, 0);
+        m_mode = other.m_mode;
         m_ptr = std::exchange(other.m_ptr, nullptr);
         m_size = std::exchange(other.m_size, 0);
+        m_mapped_size = std::exchange(other.m_mapped_size, 0);
+        m_reserved_size = std::exchange(other.m_reserved_size, 0);
         return *this;
     }
 
     ~MappedFile();
-    static Util::OsErrorOr<MappedFile> map(int fd, size_t size);
+    static Util::OsErrorOr<MappedFile> map(int fd, size_t size, Mode = Mode::Shared);
 
+    // The file must be already resized to `new_size`.
     Util::OsErrorOr<void> remap(size_t new_size);
 
     std::span<uint8_t const> data() const;
@@ -36,9 +52,17 @@ public:
 private:
     MappedFile() = default;
 
+    Util::OsErrorOr<void> reserve(size_t size);
+    Util::OsErrorOr<void> map_range(size_t begin, size_t end);
+
     int m_fd;
+    Mode m_mode = Mode::Shared;
     void* m_ptr = nullptr;
     size_t m_size = 0;
+
+    // Page-aligned part of the reservation that is backed by the file.
+    size_t m_mapped_size = 0;
+    size_t m_reserved_size = 0;
 };
 
 }
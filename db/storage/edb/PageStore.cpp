@@ -0,0 +1,45 @@
+#include "PageStore.hpp"
+
+#include <cassert>
+
+namespace Db::Storage::EDB {
+
+Util::OsErrorOr<std::unique_ptr<MappedPageStore>> MappedPageStore::create(int fd, size_t size, MappedFile::Mode mode) {
+    auto file = TRY(MappedFile::map(fd, size, mode));
+    return std::unique_ptr<MappedPageStore>(new MappedPageStore(std::move(file), mode));
+}
+
+Util::OsErrorOr<void> MappedPageStore::resize(size_t size) {
+    return m_file.remap(size);
+}
+
+uint8_t* MappedPageStore::block(BlockIndex index) {
+    assert(index != 0);
+    assert(block_offset(index) + m_block_size <= m_file.data().size());
+    if (m_track_dirty) {
+        if (index >= m_dirty_blocks.size()) {
+            m_dirty_blocks.resize(index + 1);
+        }
+        m_dirty_blocks[index] = true;
+    }
+    return m_file.data().data() + block_offset(index);
+}
+
+uint8_t const* MappedPageStore::block(BlockIndex index) const {
+    assert(index != 0);
+    assert(block_offset(index) + m_block_size <= m_file.data().size());
+    return m_file.data().data() + block_offset(index);
+}
+
+std::vector<BlockIndex> MappedPageStore::take_dirty_blocks() {
+    std::vector<BlockIndex> blocks;
+    for (BlockIndex s = 1; s < m_dirty_blocks.size(); s++) {
+        if (m_dirty_blocks[s]) {
+            blocks.push_back(s);
+            m_dirty_blocks[s] = false;
+        }
+    }
+    return blocks;
+}
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <EssaUtil/Error.hpp>
+#include <cstdint>
+#include <db/storage/edb/Definitions.hpp>
+#include <db/storage/edb/MappedFile.hpp>
+#include <memory>
+#include <vector>
+
+namespace Db::Storage::EDB {
+
+// How blocks of table files are brought into memory. Chosen per database.
+struct PageAccess {
+    enum class Mode {
+        // Whole files are mapped, the kernel decides what stays in memory.
+        Mapped,
+        // Blocks are read into a BufferPool of fixed size shared by all
+        // tables of the database.
+        BufferPool,
+    };
+
+    Mode mode = Mode::Mapped;
+
+    // Buffer pool only: memory for cached blocks, in bytes.
+    size_t buffer_pool_size = 64 << 20;
+
+    // Buffer pool only: bypass the page cache (O_DIRECT).
+    bool direct_io = false;
+};
+
+// Access to blocks of a single table file.
+//
+// Pointers to blocks stay valid until the outermost PageScope ends, or, if
+// there is no scope, until the next block is accessed. They are also
+// invalidated by resize().
+class PageStore {
+public:
+    virtual ~PageStore() = default;
+
+    // Blocks start right after the header, which isn't accessed through
+    // the store.
+    void set_layout(size_t header_size, size_t block_size) {
+        m_header_size = header_size;
+        m_block_size = block_size;
+    }
+
+    // The file was resized to `size` bytes.
+    virtual Util::OsErrorOr<void> resize(size_t size) = 0;
+
+    // The mutable overload marks the block as modified.
+    virtual uint8_t* block(BlockIndex) = 0;
+    virtual uint8_t const* block(BlockIndex) const = 0;
+
+    // Blocks modified since the last call, in order. They are kept in
+    // memory until finish_checkpoint(), so that they aren't read back from
+    // the file before the checkpoint writes them.
+    virtual std::vector<BlockIndex> take_dirty_blocks() = 0;
+    virtual void finish_checkpoint() { }
+
+    // Write modified blocks to the file. Only used without a WriteAheadLog.
+    virtual Util::OsErrorOr<void> flush() = 0;
+
+protected:
+    friend class PageScope;
+
+    virtual void begin_scope() const { }
+    virtual void end_scope() const { }
+
+    uint64_t block_offset(BlockIndex index) const { return m_header_size + m_block_size * (index - 1); }
+
+    size_t m_header_size = 0;
+    size_t m_block_size = 0;
+};
+
+class PageScope {
+public:
+    explicit PageScope(PageStore const& store)
+        : m_store(store) {
+        m_store.begin_scope();
+    }
+
+    ~PageScope() {
+        m_store.end_scope();
+    }
+
+    PageScope(PageScope const&) = delete;
+    PageScope& operator=(PageScope const&) = delete;
+
+private:
+    PageStore const& m_store;
+};
+
+class MappedPageStore : public PageStore {
+public:
+    // Modifications are tracked only for private mappings, shared ones are
+    // written back by the kernel.
+    static Util::OsErrorOr<std::unique_ptr<MappedPageStore>> create(int fd, size_t size, MappedFile::Mode);
+
+    virtual Util::OsErrorOr<void> resize(size_t size) override;
+    virtual uint8_t* block(BlockIndex) override;
+    virtual uint8_t const* block(BlockIndex) const override;
+    virtual std::vector<BlockIndex> take_dirty_blocks() override;
+    virtual Util::OsErrorOr<void> flush() override { return {}; }
+
+private:
+    MappedPageStore(MappedFile file, MappedFile::Mode mode)
+        : m_file(std::move(file))
+        , m_track_dirty(mode == MappedFile::Mode::Private) { }
+
+    MappedFile m_file;
+    bool m_track_dirty;
+    std::vector<bool> m_dirty_blocks;
+};
+
+}
@@ -25,34 +25,54 @@ Util::OsErrorOr<void> Serializer::write_column(EDBFile& file, Util::Writer& writ
 
 Util::OsErrorOr<void> Serializer::write_row(EDBFile& file, Util::Writer& writer, std::vector<Column> const& columns, Core::Tuple const& tuple) {
     assert(columns.size() == tuple.value_count());
-    for (size_t s = 0; s < columns.size(); s++) {
-        auto value = tuple.value(s);
-        if (!columns[s].not_null) {
-            TRY(writer.write_little_endian<uint8_t>(value.is_null()));
-        }
-        switch (static_cast<Core::Value::Type>(columns[s].type)) {
-        case Core::Value::Type::Null:
-            break;
-        case Core::Value::Type::Int:
-            TRY(writer.write_little_endian<uint32_t>(value.is_null() ? 0 : std::get<int>(value)));
-            break;
-        case Core::Value::Type::Float:
-            TRY(writer.write_little_endian<float>(value.is_null() ? 0 : std::get<float>(value)));
-            break;
-        case Core::Value::Type::Varchar:
-            TRY(writer.write_struct<HeapSpan>(value.is_null() ? HeapSpan {} : TRY(file.copy_to_heap(std::get<std::string>(value)))));
-            break;
-        case Core::Value::Type::Bool:
-            TRY(writer.write_little_endian<uint8_t>(value.is_null() ? false : std::get<bool>(value)));
-            break;
-        case Core::Value::Type::Time: {
-            auto time = value.is_null() ? Core::Date {} : std::get<Core::Date>(value);
-            TRY(writer.write_struct<Date>({ .year = time.year, .month = static_cast<uint8_t>(time.month), .day = static_cast<uint8_t>(time.day) }));
-            break;
+
+    // Heap data of earlier values is freed if a later value can't be
+    // written, so that a failed write doesn't leak it.
+    std::vector<HeapPtr> allocated;
+    auto write_values = [&]() -> Util::OsErrorOr<void> {
+        for (size_t s = 0; s < columns.size(); s++) {
+            auto value = tuple.value(s);
+            if (!columns[s].not_null) {
+                TRY(writer.write_little_endian<uint8_t>(value.is_null()));
+            }
+            switch (static_cast<Core::Value::Type>(columns[s].type)) {
+            case Core::Value::Type::Null:
+                break;
+            case Core::Value::Type::Int:
+                TRY(writer.write_little_endian<uint32_t>(value.is_null() ? 0 : value.int_value()));
+                break;
+            case Core::Value::Type::Float:
+                TRY(writer.write_little_endian<float>(value.is_null() ? 0 : value.float_value()));
+                break;
+            case Core::Value::Type::Varchar: {
+                HeapSpan span {};
+                if (!value.is_null()) {
+                    span = TRY(file.copy_to_heap(value.varchar_value()));
+                    allocated.push_back(span.offset);
+                }
+                TRY(writer.write_struct<HeapSpan>(span));
+                break;
+            }
+            case Core::Value::Type::Bool:
+                TRY(writer.write_little_endian<uint8_t>(value.is_null() ? false : value.bool_value()));
+                break;
+            case Core::Value::Type::Time: {
+                auto time = value.is_null() ? Core::Date {} : value.time_value();
+                TRY(writer.write_struct<Date>({ .year = time.year, .month = static_cast<uint8_t>(time.month), .day = static_cast<uint8_t>(time.day) }));
+                break;
+            }
+            }
         }
+        return {};
+    };
+
+    auto result = write_values();
+    if (result.is_error()) {
+        for (auto ptr : allocated) {
+            (void)file.heap_free(ptr);
         }
     }
-    return {};
+    return result;
 }
 
 }
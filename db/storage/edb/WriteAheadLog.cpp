@@ -0,0 +1,648 @@
+#include "WriteAheadLog.hpp"
+
+#include <EssaUtil/Config.hpp>
+#include <EssaUtil/ScopeGuard.hpp>
+#include <EssaUtil/Stream/File.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <db/storage/edb/Endian.hpp>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Db::Storage::EDB {
+
+constexpr uint8_t CheckpointMagic[] = { 'e', 's', 'd', 'b', 'c', 'k', 'p', 't' };
+
+namespace {
+
+// FNV-1a. It is only meant to detect torn writes, not malicious changes.
+uint32_t checksum(std::span<uint8_t const> data) {
+    uint32_t hash = 2166136261u;
+    for (auto byte : data) {
+        hash = (hash ^ byte) * 16777619u;
+    }
+    return hash;
+}
+
+class RecordWriter {
+public:
+    explicit RecordWriter(std::vector<uint8_t>& output)
+        : m_output(output) { }
+
+    template<std::integral T>
+    void write(T value) {
+        LittleEndian<T> encoded;
+        encoded.set_value(value);
+        write_bytes({ reinterpret_cast<uint8_t const*>(&encoded), sizeof(encoded) });
+    }
+
+    void write_bytes(std::span<uint8_t const> data) {
+        m_output.insert(m_output.end(), data.begin(), data.end());
+    }
+
+    void write_string(std::string_view string) {
+        write<uint32_t>(string.size());
+        write_bytes({ reinterpret_cast<uint8_t const*>(string.data()), string.size() });
+    }
+
+    void write_heap_ptr(HeapPtr ptr) {
+        write<uint32_t>(ptr.block);
+        write<uint32_t>(ptr.offset);
+    }
+
+    void write_tuple(Core::Tuple const& tuple) {
+        write<uint32_t>(tuple.value_count());
+        for (auto const& value : tuple) {
+            write<uint8_t>(static_cast<uint8_t>(value.type()));
+            switch (value.type()) {
+            case Core::Value::Type::Null:
+                break;
+            case Core::Value::Type::Int:
+                write<int32_t>(value.int_value());
+                break;
+            case Core::Value::Type::Float:
+                write<uint32_t>(std::bit_cast<uint32_t>(value.float_value()));
+                break;
+            case Core::Value::Type::Varchar:
+                write_string(value.varchar_value());
+                break;
+            case Core::Value::Type::Bool:
+                write<uint8_t>(value.bool_value());
+                break;
+            case Core::Value::Type::Time: {
+                auto date = value.time_value();
+                for (auto field : { date.year, date.month, date.day, date.hour, date.min, date.sec }) {
+                    write<int32_t>(field);
+                }
+                break;
+            }
+            }
+        }
+    }
+
+private:
+    std::vector<uint8_t>& m_output;
+};
+
+// Reading past the end (i.e a malformed record) sets an error flag
+// instead of asserting, the caller checks it after decoding.
+class RecordReader {
+public:
+    explicit RecordReader(std::span<uint8_t const> data)
+        : m_data(data) { }
+
+    template<std::integral T>
+    T read() {
+        LittleEndian<T> encoded {};
+        auto bytes = read_bytes(sizeof(encoded));
+        if (bytes.size() == sizeof(encoded)) {
+            std::memcpy(&encoded, bytes.data(), sizeof(encoded));
+        }
+        return encoded.value();
+    }
+
+    std::span<uint8_t const> read_bytes(size_t size) {
+        if (m_failed || size > m_data.size() - m_offset) {
+            m_failed = true;
+            return {};
+        }
+        auto bytes = m_data.subspan(m_offset, size);
+        m_offset += size;
+        return bytes;
+    }
+
+    std::string read_string() {
+        auto size = read<uint32_t>();
+        auto bytes = read_bytes(size);
+        return { reinterpret_cast<char const*>(bytes.data()), bytes.size() };
+    }
+
+    HeapPtr read_heap_ptr() {
+        HeapPtr ptr;
+        ptr.block = read<uint32_t>();
+        ptr.offset = read<uint32_t>();
+        return ptr;
+    }
+
+    Core::Tuple read_tuple() {
+        auto count = read<uint32_t>();
+        std::vector<Core::Value> values;
+        for (size_t s = 0; s < count && !m_failed; s++) {
+            switch (static_cast<Core::Value::Type>(read<uint8_t>())) {
+            case Core::Value::Type::Null:
+                values.push_back(Core::Value::null());
+                break;
+            case Core::Value::Type::Int:
+                values.push_back(Core::Value::create_int(read<int32_t>()));
+                break;
+            case Core::Value::Type::Float:
+                values.push_back(Core::Value::create_float(std::bit_cast<float>(read<uint32_t>())));
+                break;
+            case Core::Value::Type::Varchar:
+                values.push_back(Core::Value::create_varchar(read_string()));
+                break;
+            case Core::Value::Type::Bool:
+                values.push_back(Core::Value::create_bool(read<uint8_t>()));
+                break;
+            case Core::Value::Type::Time: {
+                Core::Date date {};
+                for (auto field : { &date.year, &date.month, &date.day, &date.hour, &date.min, &date.sec }) {
+                    *field = read<int32_t>();
+                }
+                values.push_back(Core::Value::create_time(date));
+                break;
+            }
+            default:
+                m_failed = true;
+                break;
+            }
+        }
+        return Core::Tuple { std::move(values) };
+    }
+
+    bool failed() const { return m_failed; }
+    bool at_end() const { return m_offset == m_data.size(); }
+
+private:
+    std::span<uint8_t const> m_data;
+    size_t m_offset = 0;
+    bool m_failed = false;
+};
+
+Util::OsErrorOr<std::vector<uint8_t>> read_file(std::string const& path) {
+    Util::File file { ::open(path.c_str(), O_RDONLY | O_CLOEXEC), true };
+    if (file.fd() < 0) {
+        return Util::OsError { .error = errno, .function = "WriteAheadLog: open" };
+    }
+    struct stat stat;
+    if (::fstat(file.fd(), &stat) < 0) {
+        return Util::OsError { .error = errno, .function = "WriteAheadLog: stat" };
+    }
+    std::vector<uint8_t> data(stat.st_size);
+    size_t offset = 0;
+    while (offset < data.size()) {
+        auto result = ::read(file.fd(), data.data() + offset, data.size() - offset);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return Util::OsError { .error = errno, .function = "WriteAheadLog: read" };
+        }
+        if (result == 0) {
+            data.resize(offset);
+            break;
+        }
+        offset += result;
+    }
+    return data;
+}
+
+Util::OsErrorOr<void> write_all(int fd, std::span<uint8_t const> data, off_t offset = -1) {
+    while (!data.empty()) {
+        auto result = offset < 0 ? ::write(fd, data.data(), data.size()) : ::pwrite(fd, data.data(), data.size(), offset);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return Util::OsError { .error = errno, .function = "WriteAheadLog: write" };
+        }
+        data = data.subspan(result);
+        if (offset >= 0) {
+            offset += result;
+        }
+    }
+    return {};
+}
+
+Util::OsErrorOr<void> fsync_path(std::string const& path, int flags) {
+    Util::File file { ::open(path.c_str(), flags | O_CLOEXEC), true };
+    if (file.fd() < 0) {
+        return Util::OsError { .error = errno, .function = "WriteAheadLog: open for fsync" };
+    }
+    if (::fsync(file.fd()) < 0) {
+        return Util::OsError { .error = errno, .function = "WriteAheadLog: fsync" };
+    }
+    return {};
+}
+
+// Segments are named wal.<sequence>.log.
+std::optional<uint64_t> parse_segment_name(std::string const& name) {
+    if (!name.starts_with("wal.") || !name.ends_with(".log") || name.size() <= 8) {
+        return {};
+    }
+    auto number = name.substr(4, name.size() - 8);
+    if (!std::ranges::all_of(number, [](char c) { return c >= '0' && c <= '9'; })) {
+        return {};
+    }
+    return std::stoull(number);
+}
+
+}
+
+WriteAheadLog::WriteAheadLog(std::string directory)
+    : m_directory(std::move(directory)) {
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    auto result = wait_for_checkpoint();
+    if (result.is_error()) {
+        result.dump("Internal error: Checkpoint failed");
+    }
+    {
+        std::lock_guard lock { m_mutex };
+        m_stopping = true;
+    }
+    m_sync_condition.notify_all();
+    if (m_sync_thread.joinable()) {
+        m_sync_thread.join();
+    }
+    if (m_segment_fd >= 0) {
+        ::close(m_segment_fd);
+    }
+}
+
+Util::OsErrorOr<std::unique_ptr<WriteAheadLog>> WriteAheadLog::open(std::string directory) {
+    auto wal = std::unique_ptr<WriteAheadLog>(new WriteAheadLog(std::move(directory)));
+    TRY(wal->restore_checkpoint());
+
+    for (auto const& entry : std::filesystem::directory_iterator { wal->m_directory }) {
+        auto sequence = parse_segment_name(entry.path().filename().string());
+        if (sequence) {
+            wal->m_segments_to_replay.push_back(*sequence);
+        }
+    }
+    std::ranges::sort(wal->m_segments_to_replay);
+
+    TRY(wal->open_segment(wal->m_segments_to_replay.empty() ? 1 : wal->m_segments_to_replay.back() + 1));
+    wal->m_sync_thread = std::thread { [wal = wal.get()]() { wal->sync_thread(); } };
+    return wal;
+}
+
+std::string WriteAheadLog::segment_path(uint64_t sequence) const {
+    return fmt::format("{}/wal.{}.log", m_directory, sequence);
+}
+
+std::string WriteAheadLog::checkpoint_path() const {
+    return fmt::format("{}/checkpoint.dwb", m_directory);
+}
+
+Util::OsErrorOr<void> WriteAheadLog::open_segment(uint64_t sequence) {
+    int fd = ::open(segment_path(sequence).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return Util::OsError { .error = errno, .function = "WriteAheadLog: open segment" };
+    }
+    // Make the new file itself durable, fsyncs of the segment don't do that.
+    TRY(fsync_path(m_directory, O_RDONLY | O_DIRECTORY));
+
+    std::lock_guard lock { m_mutex };
+    if (m_segment_fd >= 0) {
+        ::close(m_segment_fd);
+    }
+    m_segment_fd = fd;
+    m_segment_sequence = sequence;
+    m_segment_size = 0;
+    return {};
+}
+
+Util::OsErrorOr<void> WriteAheadLog::replay(std::function<Util::OsErrorOr<void>(Record const&)> const& callback) {
+    m_replaying = true;
+    Util::ScopeGuard guard { [&] { m_replaying = false; } };
+
+    for (size_t s = 0; s < m_segments_to_replay.size(); s++) {
+        auto data = TRY(read_file(segment_path(m_segments_to_replay[s])));
+        std::span<uint8_t const> remaining = data;
+
+        // Records are applied only when their statement is committed.
+        std::vector<Record> pending;
+        bool torn = false;
+        while (!remaining.empty()) {
+            RecordReader frame { remaining };
+            auto body_size = frame.read<uint32_t>();
+            auto body_checksum = frame.read<uint32_t>();
+            auto body = frame.read_bytes(body_size);
+            if (frame.failed() || checksum(body) != body_checksum) {
+                torn = true;
+                break;
+            }
+            remaining = remaining.subspan(sizeof(uint32_t) * 2 + body_size);
+
+            RecordReader reader { body };
+            Record record { .type = static_cast<RecordType>(reader.read<uint8_t>()), .table = {}, .row = {}, .prev_row = {}, .tuple = {} };
+            switch (record.type) {
+            case RecordType::Insert:
+                record.table = reader.read_string();
+                record.tuple = reader.read_tuple();
+                break;
+            case RecordType::Remove:
+                record.table = reader.read_string();
+                record.row = reader.read_heap_ptr();
+                record.prev_row = reader.read_heap_ptr();
+                break;
+            case RecordType::Update:
+                record.table = reader.read_string();
+                record.row = reader.read_heap_ptr();
+                record.tuple = reader.read_tuple();
+                break;
+            case RecordType::Commit:
+                for (auto const& pending_record : pending) {
+                    TRY(callback(pending_record));
+                }
+                pending.clear();
+                continue;
+            default:
+                return Util::OsError { .error = 0, .function = "Corruption: WriteAheadLog: Invalid record type" };
+            }
+            if (reader.failed() || !reader.at_end()) {
+                return Util::OsError { .error = 0, .function = "Corruption: WriteAheadLog: Malformed record" };
+            }
+            pending.push_back(std::move(record));
+        }
+
+        // A segment is fully synced before the next one is started, so
+        // only the last one can end with a partially written record.
+        if (torn && s != m_segments_to_replay.size() - 1) {
+            return Util::OsError { .error = 0, .function = "Corruption: WriteAheadLog: Torn record in the middle of log" };
+        }
+    }
+    m_segments_to_replay.clear();
+    return {};
+}
+
+void WriteAheadLog::append_record(RecordType type, std::vector<uint8_t> const& payload) {
+    std::vector<uint8_t> body;
+    body.reserve(payload.size() + 1);
+    body.push_back(static_cast<uint8_t>(type));
+    body.insert(body.end(), payload.begin(), payload.end());
+
+    RecordWriter writer { m_buffer };
+    writer.write<uint32_t>(body.size());
+    writer.write<uint32_t>(checksum(body));
+    writer.write_bytes(body);
+}
+
+void WriteAheadLog::log_insert(std::string const& table, Core::Tuple const& tuple) {
+    if (m_replaying) {
+        return;
+    }
+    std::vector<uint8_t> payload;
+    RecordWriter writer { payload };
+    writer.write_string(table);
+    writer.write_tuple(tuple);
+    append_record(RecordType::Insert, payload);
+}
+
+void WriteAheadLog::log_remove(std::string const& table, HeapPtr row, HeapPtr prev_row) {
+    if (m_replaying) {
+        return;
+    }
+    std::vector<uint8_t> payload;
+    RecordWriter writer { payload };
+    writer.write_string(table);
+    writer.write_heap_ptr(row);
+    writer.write_heap_ptr(prev_row);
+    append_record(RecordType::Remove, payload);
+}
+
+void WriteAheadLog::log_update(std::string const& table, HeapPtr row, Core::Tuple const& tuple) {
+    if (m_replaying) {
+        return;
+    }
+    std::vector<uint8_t> payload;
+    RecordWriter writer { payload };
+    writer.write_string(table);
+    writer.write_heap_ptr(row);
+    writer.write_tuple(tuple);
+    append_record(RecordType::Update, payload);
+}
+
+Util::OsErrorOr<void> WriteAheadLog::commit() {
+    {
+        std::lock_guard lock { m_mutex };
+        if (m_sync_error) {
+            return *m_sync_error;
+        }
+    }
+    if (m_buffer.empty()) {
+        return {};
+    }
+    append_record(RecordType::Commit, {});
+
+    // The segment is only switched by this thread, so it's safe to write
+    // without holding the lock.
+    TRY(write_all(m_segment_fd, m_buffer));
+    m_segment_size += m_buffer.size();
+    {
+        std::lock_guard lock { m_mutex };
+        m_written_bytes += m_buffer.size();
+    }
+    m_buffer.clear();
+    m_sync_condition.notify_all();
+    return {};
+}
+
+Util::OsErrorOr<void> WriteAheadLog::wait_until_durable() {
+    std::unique_lock lock { m_mutex };
+    auto target = m_written_bytes;
+    m_requested_bytes = std::max(m_requested_bytes, target);
+    m_sync_condition.notify_all();
+    m_durable_condition.wait(lock, [&]() { return m_durable_bytes >= target || m_sync_error; });
+    if (m_sync_error) {
+        return *m_sync_error;
+    }
+    return {};
+}
+
+void WriteAheadLog::sync_thread() {
+    std::unique_lock lock { m_mutex };
+    while (true) {
+        m_sync_condition.wait(lock, [&]() { return m_stopping || (!m_sync_error && m_written_bytes > m_durable_bytes); });
+
+        // Give other commits a chance to join this fsync, unless someone
+        // is waiting for it.
+        if (!m_stopping && m_requested_bytes <= m_durable_bytes) {
+            m_sync_condition.wait_for(lock, GroupCommitInterval, [&]() { return m_stopping || m_requested_bytes > m_durable_bytes; });
+        }
+
+        if (!m_sync_error && m_written_bytes > m_durable_bytes) {
+            auto target = m_written_bytes;
+            auto fd = m_segment_fd;
+            lock.unlock();
+            auto result = ::fdatasync(fd);
+            auto error = errno;
+            lock.lock();
+            if (result < 0) {
+                m_sync_error = Util::OsError { .error = error, .function = "WriteAheadLog: fdatasync" };
+            }
+            else {
+                m_durable_bytes = target;
+            }
+        }
+        m_durable_condition.notify_all();
+        if (m_stopping) {
+            break;
+        }
+    }
+}
+
+Util::OsErrorOr<void> WriteAheadLog::wait_for_checkpoint() {
+    if (m_checkpoint_thread.joinable()) {
+        m_checkpoint_thread.join();
+    }
+    if (m_checkpoint_error) {
+        auto error = *m_checkpoint_error;
+        m_checkpoint_error.reset();
+        return error;
+    }
+    return {};
+}
+
+Util::OsErrorOr<void> WriteAheadLog::checkpoint(std::vector<FileImage> images, bool wait) {
+    TRY(wait_for_checkpoint());
+
+    // Records after the images go to a new segment. The old one must be
+    // complete on disk before anything is written to the new one, replay
+    // relies on that.
+    TRY(wait_until_durable());
+    auto first_kept_sequence = m_segment_sequence + 1;
+    TRY(open_segment(first_kept_sequence));
+
+    m_checkpoint_thread = std::thread { [this, images = std::move(images), first_kept_sequence]() {
+        auto result = write_checkpoint(images, first_kept_sequence);
+        if (result.is_error()) {
+            m_checkpoint_error = result.release_error();
+        }
+    } };
+    if (wait) {
+        TRY(wait_for_checkpoint());
+    }
+    return {};
+}
+
+Util::OsErrorOr<void> WriteAheadLog::write_checkpoint(std::vector<FileImage> const& images, uint64_t first_kept_sequence) {
+    // 1. Write the double-write image, and make it durable atomically.
+    std::vector<uint8_t> data;
+    RecordWriter writer { data };
+    writer.write_bytes(CheckpointMagic);
+    writer.write<uint64_t>(first_kept_sequence);
+    writer.write<uint32_t>(images.size());
+    for (auto const& image : images) {
+        writer.write_string(image.file_name);
+        writer.write<uint64_t>(image.file_size);
+        writer.write<uint32_t>(image.extents.size());
+        for (auto const& extent : image.extents) {
+            writer.write<uint64_t>(extent.offset);
+            writer.write<uint64_t>(extent.data.size());
+            writer.write_bytes(extent.data);
+        }
+    }
+    writer.write<uint32_t>(checksum(data));
+
+    auto temporary_path = checkpoint_path() + ".tmp";
+    {
+        Util::File file { ::open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644), true };
+        if (file.fd() < 0) {
+            return Util::OsError { .error = errno, .function = "WriteAheadLog: open checkpoint" };
+        }
+        TRY(write_all(file.fd(), data));
+        if (::fsync(file.fd()) < 0) {
+            return Util::OsError { .error = errno, .function = "WriteAheadLog: fsync checkpoint" };
+        }
+    }
+    if (::rename(temporary_path.c_str(), checkpoint_path().c_str()) < 0) {
+        return Util::OsError { .error = errno, .function = "WriteAheadLog: rename checkpoint" };
+    }
+    TRY(fsync_path(m_directory, O_RDONLY | O_DIRECTORY));
+
+    // 2. Now table files can be safely overwritten.
+    TRY(apply_images(images));
+
+    // 3. The log before the checkpoint and the image are not needed anymore.
+    TRY(remove_segments_before(first_kept_sequence));
+    if (::unlink(checkpoint_path().c_str()) < 0) {
+        return Util::OsError { .error = errno, .function = "WriteAheadLog: unlink checkpoint" };
+    }
+    TRY(fsync_path(m_directory, O_RDONLY | O_DIRECTORY));
+    return {};
+}
+
+Util::OsErrorOr<void> WriteAheadLog::restore_checkpoint() {
+    std::filesystem::remove(checkpoint_path() + ".tmp");
+    if (!std::filesystem::exists(checkpoint_path())) {
+        return {};
+    }
+
+    auto data = TRY(read_file(checkpoint_path()));
+    RecordReader reader { data };
+    auto magic = reader.read_bytes(sizeof(CheckpointMagic));
+    if (reader.failed() || !std::ranges::equal(magic, CheckpointMagic)) {
+        return Util::OsError { .error = 0, .function = "Corruption: WriteAheadLog: Invalid checkpoint magic" };
+    }
+    auto first_kept_sequence = reader.read<uint64_t>();
+    std::vector<FileImage> images(reader.read<uint32_t>());
+    for (auto& image : images) {
+        image.file_name = reader.read_string();
+        image.file_size = reader.read<uint64_t>();
+        image.extents.resize(reader.read<uint32_t>());
+        for (auto& extent : image.extents) {
+            extent.offset = reader.read<uint64_t>();
+            auto bytes = reader.read_bytes(reader.read<uint64_t>());
+            extent.data.assign(bytes.begin(), bytes.end());
+        }
+        if (reader.failed()) {
+            return Util::OsError { .error = 0, .function = "Corruption: WriteAheadLog: Malformed checkpoint" };
+        }
+    }
+    auto consumed = data.size() - sizeof(uint32_t);
+    auto stored_checksum = reader.read<uint32_t>();
+    if (reader.failed() || !reader.at_end() || checksum(std::span { data }.first(consumed)) != stored_checksum) {
+        return Util::OsError { .error = 0, .function = "Corruption: WriteAheadLog: Checkpoint checksum mismatch" };
+    }
+
+    // Checkpoint was renamed into place only after it was complete, so
+    // it's always whole here. Writing it again is idempotent.
+    TRY(apply_images(images));
+    TRY(remove_segments_before(first_kept_sequence));
+    std::filesystem::remove(checkpoint_path());
+    TRY(fsync_path(m_directory, O_RDONLY | O_DIRECTORY));
+    return {};
+}
+
+Util::OsErrorOr<void> WriteAheadLog::apply_images(std::vector<FileImage> const& images) {
+    for (auto const& image : images) {
+        auto path = fmt::format("{}/{}", m_directory, image.file_name);
+        Util::File file { ::open(path.c_str(), O_RDWR | O_CLOEXEC), true };
+        if (file.fd() < 0) {
+            return Util::OsError { .error = errno, .function = "WriteAheadLog: open table file" };
+        }
+        struct stat stat;
+        if (::fstat(file.fd(), &stat) < 0) {
+            return Util::OsError { .error = errno, .function = "WriteAheadLog: stat table file" };
+        }
+        // Files are never shrunk, the owner may have already grown it.
+        if (static_cast<uint64_t>(stat.st_size) < image.file_size && ::ftruncate(file.fd(), image.file_size) < 0) {
+            return Util::OsError { .error = errno, .function = "WriteAheadLog: ftruncate table file" };
+        }
+        for (auto const& extent : image.extents) {
+            TRY(write_all(file.fd(), extent.data, extent.offset));
+        }
+        if (::fsync(file.fd()) < 0) {
+            return Util::OsError { .error = errno, .function = "WriteAheadLog: fsync table file" };
+        }
+    }
+    return {};
+}
+
+Util::OsErrorOr<void> WriteAheadLog::remove_segments_before(uint64_t sequence) {
+    for (auto const& entry : std::filesystem::directory_iterator { m_directory }) {
+        auto segment = parse_segment_name(entry.path().filename().string());
+        if (segment && *segment < sequence && ::unlink(entry.path().c_str()) < 0) {
+            return Util::OsError { .error = errno, .function = "WriteAheadLog: unlink segment" };
+        }
+    }
+    return {};
+}
+
+}
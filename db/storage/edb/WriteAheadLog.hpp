@@ -0,0 +1,138 @@
+#pragma once
+
+#include <EssaUtil/Error.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <db/core/Tuple.hpp>
+#include <db/storage/edb/Definitions.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Db::Storage::EDB {
+
+// Redo log shared by all EDB files of a database. While it is attached,
+// files are mapped privately, so table files are modified only by
+// checkpoints and the log is the only thing written per statement.
+// See docs/EDBFileFormat.md for the on-disk format.
+class WriteAheadLog {
+public:
+    enum class RecordType : uint8_t {
+        Insert = 1,
+        Remove = 2,
+        Update = 3,
+        Commit = 4,
+    };
+
+    struct Record {
+        RecordType type;
+        std::string table;
+        HeapPtr row;
+        HeapPtr prev_row;
+        Core::Tuple tuple;
+    };
+
+    // Contents of a table file that differ from what is on disk.
+    struct FileImage {
+        struct Extent {
+            uint64_t offset;
+            std::vector<uint8_t> data;
+        };
+
+        // Relative to the database directory.
+        std::string file_name;
+        uint64_t file_size;
+        std::vector<Extent> extents;
+    };
+
+    // Committed records are fsynced by a background thread. It waits this
+    // long for more commits to share the fsync, unless someone waits for
+    // them in wait_until_durable().
+    static constexpr auto GroupCommitInterval = std::chrono::milliseconds(10);
+
+    // Log size after which a checkpoint is requested.
+    static constexpr size_t CheckpointThreshold = 16 << 20;
+
+    WriteAheadLog(WriteAheadLog const&) = delete;
+    ~WriteAheadLog();
+
+    // Finishes interrupted checkpoint (if any) and starts a new log
+    // segment. Records of existing segments can be applied with replay().
+    static Util::OsErrorOr<std::unique_ptr<WriteAheadLog>> open(std::string directory);
+
+    // Call `callback` for every committed record of segments that existed
+    // when the log was opened. Nothing is logged meanwhile.
+    Util::OsErrorOr<void> replay(std::function<Util::OsErrorOr<void>(Record const&)> const& callback);
+
+    void log_insert(std::string const& table, Core::Tuple const&);
+    void log_remove(std::string const& table, HeapPtr row, HeapPtr prev_row);
+    void log_update(std::string const& table, HeapPtr row, Core::Tuple const&);
+
+    // Mark a statement boundary. Records are written to the log, but this
+    // doesn't wait for them to be fsynced.
+    Util::OsErrorOr<void> commit();
+
+    // Wait until everything committed so far is durable. Concurrent
+    // waiters share one fsync.
+    Util::OsErrorOr<void> wait_until_durable();
+
+    bool should_checkpoint() const { return m_segment_size >= CheckpointThreshold; }
+
+    // Write `images` (the state at the last commit) into table files and
+    // drop the log that led to them. Unless `wait` is set, this is done in
+    // background, after the images are handed over.
+    Util::OsErrorOr<void> checkpoint(std::vector<FileImage> images, bool wait);
+
+    // Wait until the checkpoint running in background (if any) is written.
+    Util::OsErrorOr<void> wait_for_checkpoint();
+
+private:
+    explicit WriteAheadLog(std::string directory);
+
+    void append_record(RecordType, std::vector<uint8_t> const& payload);
+    Util::OsErrorOr<void> open_segment(uint64_t sequence);
+    void sync_thread();
+
+    std::string segment_path(uint64_t sequence) const;
+    std::string checkpoint_path() const;
+
+    // Write a double-write image of `images` first, so that a crash while
+    // writing table files can't leave them half-updated.
+    Util::OsErrorOr<void> write_checkpoint(std::vector<FileImage> const& images, uint64_t first_kept_sequence);
+    Util::OsErrorOr<void> restore_checkpoint();
+    Util::OsErrorOr<void> apply_images(std::vector<FileImage> const& images);
+    Util::OsErrorOr<void> remove_segments_before(uint64_t sequence);
+
+    std::string m_directory;
+    bool m_replaying = false;
+
+    // Records of the current statement.
+    std::vector<uint8_t> m_buffer;
+
+    std::vector<uint64_t> m_segments_to_replay;
+    uint64_t m_segment_sequence = 0;
+    size_t m_segment_size = 0;
+
+    // Shared with the sync thread.
+    std::mutex m_mutex;
+    std::condition_variable m_sync_condition;
+    std::condition_variable m_durable_condition;
+    int m_segment_fd = -1;
+    uint64_t m_written_bytes = 0;
+    uint64_t m_durable_bytes = 0;
+    // Most bytes someone waits for in wait_until_durable().
+    uint64_t m_requested_bytes = 0;
+    bool m_stopping = false;
+    std::optional<Util::OsError> m_sync_error;
+    std::thread m_sync_thread;
+
+    std::thread m_checkpoint_thread;
+    std::optional<Util::OsError> m_checkpoint_error;
+};
+
+}
@@ -8,6 +8,7 @@
 #include <db/sql/Parser.hpp>
 #include <db/sql/SQL.hpp>
 
+#include <charconv>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -28,6 +29,10 @@ void run_query(Db::Core::Database& db, std::string const& query) {
         return;
     }
     auto result = statement.release_value()->execute(db);
+    auto commit_result = Db::Sql::commit(db);
+    if (commit_result.is_error()) {
+        fmt::print("{}\n", commit_result.release_error().message());
+    }
     if (result.is_error()) {
         auto error = result.release_error();
         Db::Sql::display_error(error, tokens[error.token()].start, tokens[error.token()].end, query);
@@ -92,6 +97,9 @@ int main(int argc, char* argv[]) {
     parser.option("-e", engine_str);
     std::optional<std::string> db_path_str;
     parser.option("-d", db_path_str);
+    // Size of the buffer pool in MiB. Table files are mapped if not given.
+    std::optional<std::string> buffer_pool_str;
+    parser.option("-b", buffer_pool_str);
     std::optional<std::string> input;
     parser.parameter("input_file", input);
 
@@ -106,7 +114,18 @@ int main(int argc, char* argv[]) {
         fmt::print("Error: edb engine requires -d <db_path> argument\n");
         return 1;
     }
-    auto maybe_db = is_edb ? Db::Core::Database::create_or_open_file_backed(*db_path_str) : Db::Core::Database::create_memory_backed();
+    Db::Storage::EDB::PageAccess page_access;
+    if (buffer_pool_str) {
+        size_t size_mib = 0;
+        auto [ptr, ec] = std::from_chars(buffer_pool_str->data(), buffer_pool_str->data() + buffer_pool_str->size(), size_mib);
+        if (ec != std::errc {} || ptr != buffer_pool_str->data() + buffer_pool_str->size() || size_mib == 0) {
+            fmt::print("Error: invalid buffer pool size: {}\n", *buffer_pool_str);
+            return 1;
+        }
+        page_access.mode = Db::Storage::EDB::PageAccess::Mode::BufferPool;
+        page_access.buffer_pool_size = size_mib << 20;
+    }
+    auto maybe_db = is_edb ? Db::Core::Database::create_or_open_file_backed(*db_path_str, page_access) : Db::Core::Database::create_memory_backed();
     if (maybe_db.is_error()) {
         fmt::print("Error: failed to open db: {}\n", maybe_db.release_error());
         return 1;
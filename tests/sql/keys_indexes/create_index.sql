@@ -0,0 +1,93 @@
+CREATE TABLE test (id INT, name VARCHAR, score INT) ENGINE MEMORY;
+INSERT INTO test VALUES(1, 'e', 50);
+INSERT INTO test VALUES(2, 'c', 20);
+INSERT INTO test VALUES(3, 'a', 40);
+INSERT INTO test VALUES(4, 'd', 20);
+INSERT INTO test VALUES(5, 'b', 30);
+INSERT INTO test (id, name) VALUES(6, 'f');
+
+CREATE INDEX by_score ON test (score);
+CREATE INDEX by_name ON test (name);
+
+-- error: Index 'by_score' already exists
+CREATE INDEX by_score ON test (id);
+
+-- error: Column 'nonexistent' does not exist in table 'test'
+CREATE INDEX by_nonexistent ON test (nonexistent);
+
+-- output:
+-- | id | name | score |
+-- |  2 |    c |    20 |
+-- |  4 |    d |    20 |
+SELECT * FROM test WHERE score = 20;
+
+-- output:
+-- | id | name | score |
+-- |  1 |    e |    50 |
+-- |  3 |    a |    40 |
+SELECT * FROM test WHERE 30 < score;
+
+-- Rows are found in table order.
+-- output:
+-- | id | name | score |
+-- |  2 |    c |    20 |
+-- |  4 |    d |    20 |
+-- |  5 |    b |    30 |
+SELECT * FROM test WHERE score BETWEEN 20 AND 30;
+
+-- Other conditions are still checked.
+-- output:
+-- | id | name | score |
+-- |  3 |    a |    40 |
+SELECT * FROM test WHERE id > 2 AND name IN ('a', 'f', 'x') AND score IS NOT NULL;
+
+-- NULL is less than anything.
+-- output:
+-- | id | name | score |
+-- |  2 |    c |    20 |
+-- |  4 |    d |    20 |
+-- |  6 |    f |  null |
+SELECT * FROM test WHERE score < 30;
+
+-- Rows are read in index order instead of sorting them.
+-- output:
+-- | id | name | score |
+-- |  3 |    a |    40 |
+-- |  5 |    b |    30 |
+-- |  2 |    c |    20 |
+-- |  4 |    d |    20 |
+SELECT * FROM test WHERE name < 'e' ORDER BY name;
+
+-- Indexes are updated together with rows.
+UPDATE test SET score = score + 5;
+DELETE FROM test WHERE name = 'd';
+
+-- output:
+-- | id | name | score |
+-- |  2 |    c |    25 |
+-- |  5 |    b |    35 |
+SELECT * FROM test WHERE score BETWEEN 20 AND 35;
+
+-- output:
+-- | id | score |
+-- |  2 |    25 |
+-- |  5 |    35 |
+-- |  3 |    45 |
+-- |  1 |    55 |
+SELECT id, score FROM test WHERE score > 0 ORDER BY score;
+
+DROP INDEX by_score ON test;
+
+-- error: Index 'by_score' does not exist
+DROP INDEX by_score ON test;
+
+-- output:
+-- | id | name | score |
+-- |  2 |    c |    25 |
+-- |  5 |    b |    35 |
+SELECT * FROM test WHERE score BETWEEN 20 AND 35;
+
+CREATE TABLE columnar (id INT) ENGINE COLUMNAR;
+
+-- error: (FIXME) Indexes are supported only on MemoryBackedTables
+CREATE INDEX by_id ON columnar (id);
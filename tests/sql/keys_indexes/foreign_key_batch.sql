@@ -0,0 +1,40 @@
+-- Referenced columns without an index are collected once per inserted batch.
+CREATE TABLE customers (customer_id INT, name VARCHAR) ENGINE COLUMNAR;
+INSERT INTO customers VALUES(1, 'first');
+INSERT INTO customers VALUES(2, 'second');
+
+CREATE TABLE new_orders (order_id INT, customer_id INT);
+INSERT INTO new_orders VALUES(10, 1);
+INSERT INTO new_orders VALUES(11, 2);
+INSERT INTO new_orders VALUES(12, 1);
+
+CREATE TABLE orders (order_id INT PRIMARY KEY, customer_id INT FOREIGN KEY REFERENCES customers(customer_id));
+INSERT INTO orders (order_id, customer_id) SELECT order_id, customer_id FROM new_orders;
+
+INSERT INTO new_orders VALUES(13, 3);
+-- error: Foreign key 'customer_id' requires matching value in referenced column 'customers.customer_id'
+INSERT INTO orders (order_id, customer_id) SELECT order_id + 10, customer_id FROM new_orders;
+
+-- Rows inserted earlier in the same batch can be referenced.
+CREATE TABLE tree (id INT, parent INT FOREIGN KEY REFERENCES tree(id)) ENGINE COLUMNAR;
+INSERT INTO tree (id) VALUES(10);
+INSERT INTO tree (id, parent) SELECT order_id + 1, order_id FROM new_orders;
+
+-- output:
+-- | id | parent |
+-- | 10 |   null |
+-- | 11 |     10 |
+-- | 12 |     11 |
+-- | 13 |     12 |
+-- | 14 |     13 |
+SELECT * FROM tree;
+
+-- output:
+-- | order_id | customer_id |
+-- |       10 |           1 |
+-- |       11 |           2 |
+-- |       12 |           1 |
+-- |       20 |           1 |
+-- |       21 |           2 |
+-- |       22 |           1 |
+SELECT * FROM orders;
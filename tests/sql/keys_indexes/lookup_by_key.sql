@@ -0,0 +1,52 @@
+CREATE TABLE test (id INT PRIMARY KEY, name VARCHAR UNIQUE, score INT);
+INSERT INTO test VALUES(1, 'first', 10);
+INSERT INTO test VALUES(2, 'a name long enough to be stored outside', 20);
+INSERT INTO test VALUES(3, 'third', 30);
+INSERT INTO test VALUES(4, 'fourth', 40);
+
+-- output:
+-- | id |  name | score |
+-- |  3 | third |    30 |
+SELECT * FROM test WHERE id = 3;
+
+-- output:
+-- | id |                                    name |
+-- |  2 | a name long enough to be stored outside |
+SELECT id, name FROM test WHERE 'a name long enough to be stored outside' = name;
+
+-- Other conditions are still checked on the row found.
+-- output:
+-- Empty result set
+SELECT * FROM test WHERE id = 4 AND score = 10;
+
+-- output:
+-- | id |   name | score |
+-- |  4 | fourth |    40 |
+SELECT * FROM test WHERE score > 20 AND id = 4;
+
+-- output:
+-- Empty result set
+SELECT * FROM test WHERE id = 5;
+
+-- Values of other types are compared as usual.
+-- output:
+-- | id |  name |
+-- |  1 | first |
+SELECT id, name FROM test WHERE id = 1.0;
+
+-- Keys follow removed and updated rows.
+DELETE FROM test WHERE id = 3;
+UPDATE test SET id = id + 10;
+
+-- output:
+-- Empty result set
+SELECT * FROM test WHERE id = 3;
+
+-- output:
+-- Empty result set
+SELECT * FROM test WHERE id = 2;
+
+-- output:
+-- | id |                                    name | score |
+-- | 12 | a name long enough to be stored outside |    20 |
+SELECT * FROM test WHERE id = 12;
@@ -0,0 +1,29 @@
+CREATE TABLE test (id INT PRIMARY KEY, name VARCHAR UNIQUE);
+INSERT INTO test VALUES(1, 'first');
+INSERT INTO test VALUES(2, 'a name long enough to be stored outside');
+INSERT INTO test VALUES(3, 'third');
+
+-- error: Primary key must be unique
+INSERT INTO test VALUES(2, 'second');
+
+-- error: Column 'name' must contain unique values
+INSERT INTO test VALUES(4, 'a name long enough to be stored outside');
+
+-- Removed keys can be inserted again.
+DELETE FROM test WHERE id = 2;
+INSERT INTO test VALUES(2, 'a name long enough to be stored outside');
+
+-- Updated keys are checked by their new values.
+UPDATE test SET id = id + 10;
+INSERT INTO test VALUES(1, 'one');
+
+-- error: Primary key must be unique
+INSERT INTO test VALUES(11, 'eleven');
+
+-- output:
+-- | id |                                    name |
+-- | 11 |                                   first |
+-- | 13 |                                   third |
+-- | 12 | a name long enough to be stored outside |
+-- |  1 |                                     one |
+SELECT * FROM test;
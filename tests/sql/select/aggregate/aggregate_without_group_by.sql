@@ -0,0 +1,12 @@
+IMPORT CSV 'aggregate.csv' INTO test;
+
+-- Without GROUP BY, all rows form a single group.
+-- output:
+-- | COUNT(id) |   SUM(id) |
+-- |         4 | 20.000000 |
+SELECT COUNT(id), SUM(id) FROM test WHERE id > 2;
+
+-- output:
+-- |  MAX(id) |
+-- | 7.000000 |
+SELECT MAX(id) FROM test WHERE [group] = 'B';
@@ -0,0 +1,38 @@
+CREATE TABLE test (id INT, grp VARCHAR);
+INSERT INTO test VALUES(1, 'a');
+INSERT INTO test (grp) VALUES('a');
+INSERT INTO test VALUES(3, 'b');
+INSERT INTO test (id) VALUES(4);
+
+-- COUNT(*) counts rows with NULLs too.
+-- output:
+-- | COUNT(*) | COUNT(id) |
+-- |        4 |         3 |
+SELECT COUNT(*), COUNT(id) FROM test;
+
+-- output:
+-- | rows |
+-- |    4 |
+SELECT COUNT(*) AS rows FROM test;
+
+-- output:
+-- | COUNT(*) |
+-- |        2 |
+SELECT COUNT(*) FROM test WHERE id > 1;
+
+-- output:
+-- |  grp | COUNT(*) |
+-- | null |        1 |
+-- |    a |        2 |
+-- |    b |        1 |
+SELECT grp, COUNT(*) FROM test GROUP BY grp;
+
+DELETE FROM test;
+
+-- output:
+-- | COUNT(*) |
+-- |        0 |
+SELECT COUNT(*) FROM test;
+
+-- error: Expected expression, got '*'
+SELECT SUM(*) FROM test;
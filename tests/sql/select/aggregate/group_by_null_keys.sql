@@ -0,0 +1,31 @@
+CREATE TABLE test (id INT, grp VARCHAR, score INT);
+INSERT INTO test VALUES(1, 'a', 10);
+INSERT INTO test (id, score) VALUES(2, 5);
+INSERT INTO test VALUES(3, 'b', 7);
+INSERT INTO test VALUES(4, 'a', 20);
+INSERT INTO test (id, score) VALUES(5, 1);
+INSERT INTO test VALUES(6, 'b', 3);
+
+-- NULL keys are grouped together, and groups come in order of keys.
+-- output:
+-- |  grp | n |     total |
+-- | null | 2 |  6.000000 |
+-- |    a | 2 | 30.000000 |
+-- |    b | 2 | 10.000000 |
+SELECT grp, COUNT(id) AS n, SUM(score) AS total FROM test GROUP BY grp;
+
+-- Aggregates used only in HAVING are computed too.
+-- output:
+-- | grp | n |
+-- |   a | 2 |
+SELECT grp, COUNT(id) AS n FROM test GROUP BY grp HAVING MAX(score) > 8;
+
+-- output:
+-- | id |  grp |      best |
+-- |  2 | null |  5.000000 |
+-- |  5 | null |  5.000000 |
+-- |  1 |    a | 20.000000 |
+-- |  4 |    a | 20.000000 |
+-- |  3 |    b |  7.000000 |
+-- |  6 |    b |  7.000000 |
+SELECT id, grp, MAX(score) AS best FROM test PARTITION BY grp;
@@ -0,0 +1,33 @@
+CREATE TABLE test (n INT, x FLOAT, name VARCHAR);
+INSERT INTO test VALUES(-5, 2.5, 'b');
+INSERT INTO test VALUES(-3, 0.5, 'c');
+INSERT INTO test VALUES(-8, 1.5, 'a');
+
+-- output:
+-- |    MIN(n) |    MAX(n) |   MIN(x) |   MAX(x) |
+-- | -8.000000 | -3.000000 | 0.500000 | 2.500000 |
+SELECT MIN(n), MAX(n), MIN(x), MAX(x) FROM test;
+
+-- Other values keep their type.
+-- output:
+-- | MIN(name) | MAX(name) |
+-- |         a |         c |
+SELECT MIN(name), MAX(name) FROM test;
+
+-- There is nothing to compare without rows.
+CREATE TABLE empty (n INT);
+
+-- output:
+-- | MIN(n) | MAX(n) |
+-- |   null |   null |
+SELECT MIN(n), MAX(n) FROM empty;
+
+-- NULLs are skipped.
+CREATE TABLE with_null (n INT);
+INSERT INTO with_null (n) VALUES(NULL);
+INSERT INTO with_null (n) VALUES(5);
+
+-- output:
+-- |   MIN(n) |   MAX(n) |
+-- | 5.000000 | 5.000000 |
+SELECT MIN(n), MAX(n) FROM with_null;
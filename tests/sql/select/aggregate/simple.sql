@@ -14,9 +14,10 @@ SELECT COUNT(id) FROM test;
 -- | 25.000000 |
 SELECT SUM(id) FROM test;
 
+-- NULLs are skipped.
 -- output:
 -- |  MIN(id) |
--- | 0.000000 |
+-- | 1.000000 |
 SELECT MIN(id) FROM test;
 
 -- output:
@@ -9,3 +9,27 @@ IMPORT CSV 'distinct.csv' INTO test;
 -- |      5 |    tej |
 -- |      1 |   2137 |
 SELECT DISTINCT * FROM test;
+
+-- Only selected columns are compared.
+-- output:
+-- | number |
+-- |      1 |
+-- |      2 |
+-- |      3 |
+-- |      4 |
+-- |      5 |
+SELECT DISTINCT number FROM test;
+
+-- output:
+-- | number |
+-- |      5 |
+-- |      4 |
+-- |      3 |
+SELECT DISTINCT TOP 3 number FROM test ORDER BY number DESC;
+
+-- output:
+-- | COUNT(string) |
+-- |             6 |
+-- |             1 |
+-- |             2 |
+SELECT DISTINCT COUNT(string) FROM test GROUP BY number;
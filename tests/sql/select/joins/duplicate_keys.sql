@@ -0,0 +1,51 @@
+CREATE TABLE customers (id INT, name VARCHAR);
+INSERT INTO customers VALUES(1, 'ann');
+INSERT INTO customers VALUES(2, 'bob');
+INSERT INTO customers VALUES(3, 'cid');
+INSERT INTO customers VALUES(1, 'amy');
+
+CREATE TABLE orders (id INT, customer INT);
+INSERT INTO orders VALUES(10, 1);
+INSERT INTO orders VALUES(11, 1);
+INSERT INTO orders VALUES(12, 2);
+INSERT INTO orders (id) VALUES(13);
+INSERT INTO orders VALUES(14, 4);
+
+-- Every pair of rows with equal keys is joined. NULL keys don't match.
+-- output:
+-- | id | customer | id | name |
+-- | 10 |        1 |  1 |  ann |
+-- | 10 |        1 |  1 |  amy |
+-- | 11 |        1 |  1 |  ann |
+-- | 11 |        1 |  1 |  amy |
+-- | 12 |        2 |  2 |  bob |
+SELECT * FROM orders INNER JOIN customers ON orders.customer = customers.id;
+
+-- Rows of the smaller relation are hashed, so joined rows are in order of
+-- the other one, followed by unmatched rows of the smaller one.
+-- output:
+-- | id | name |   id | customer |
+-- |  1 |  ann |   10 |        1 |
+-- |  1 |  amy |   10 |        1 |
+-- |  1 |  ann |   11 |        1 |
+-- |  1 |  amy |   11 |        1 |
+-- |  2 |  bob |   12 |        2 |
+-- |  3 |  cid | null |     null |
+SELECT * FROM customers LEFT JOIN orders ON customers.id = orders.customer;
+
+-- output:
+-- |   id | customer |   id | name |
+-- |   10 |        1 |    1 |  ann |
+-- |   10 |        1 |    1 |  amy |
+-- |   11 |        1 |    1 |  ann |
+-- |   11 |        1 |    1 |  amy |
+-- |   12 |        2 |    2 |  bob |
+-- |   13 |     null | null | null |
+-- |   14 |        4 | null | null |
+-- | null |     null |    3 |  cid |
+SELECT * FROM orders FULL OUTER JOIN customers ON orders.customer = customers.id;
+
+-- output:
+-- | COUNT(id) |
+-- |         0 |
+SELECT COUNT(id) FROM orders INNER JOIN customers ON orders.id = customers.id;
@@ -103,3 +103,48 @@ SELECT number AS number_alias FROM test ORDER BY number DESC;
 -- |  5 |
 -- |  2 |
 SELECT id FROM test ORDER BY number DESC;
+
+CREATE TABLE sort_keys (id INT, n INT, s VARCHAR);
+INSERT INTO sort_keys VALUES(0, 15, 'ab');
+INSERT INTO sort_keys VALUES(1, -2, 'abc');
+INSERT INTO sort_keys VALUES(2, 0, 'a');
+INSERT INTO sort_keys (id, s) VALUES(3, 'b');
+INSERT INTO sort_keys VALUES(4, -10, '');
+
+-- Negative numbers and NULLs
+-- output:
+-- | id |    n |
+-- |  3 | null |
+-- |  4 |  -10 |
+-- |  1 |   -2 |
+-- |  2 |    0 |
+-- |  0 |   15 |
+SELECT id, n FROM sort_keys ORDER BY n;
+
+-- Shorter strings come first
+-- output:
+-- | id |   s |
+-- |  4 |     |
+-- |  2 |   a |
+-- |  0 |  ab |
+-- |  1 | abc |
+-- |  3 |   b |
+SELECT id, s FROM sort_keys ORDER BY s;
+
+-- output:
+-- | id |   s |
+-- |  3 |   b |
+-- |  1 | abc |
+-- |  0 |  ab |
+-- |  2 |   a |
+-- |  4 |     |
+SELECT id, s FROM sort_keys ORDER BY s DESC;
+
+-- output:
+-- | id |
+-- |  1 |
+-- |  0 |
+-- |  3 |
+-- |  2 |
+-- |  4 |
+SELECT id FROM sort_keys ORDER BY LEN(s) DESC, id DESC;
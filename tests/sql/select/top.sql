@@ -0,0 +1,68 @@
+CREATE TABLE test (id INT, str VARCHAR);
+INSERT INTO test VALUES(1, '10');
+INSERT INTO test VALUES(2, '20');
+INSERT INTO test VALUES(3, 'abc');
+INSERT INTO test VALUES(4, '40');
+
+-- TOP without ORDER BY stops reading rows once it has enough of them.
+-- output:
+-- | id |
+-- |  1 |
+-- |  2 |
+SELECT TOP 2 id FROM test WHERE 0 < str;
+
+-- error: 'abc' is not a valid int
+SELECT TOP 2 id FROM test WHERE 0 < str ORDER BY id;
+
+-- output:
+-- | id | str |
+-- |  1 |  10 |
+-- |  2 |  20 |
+-- |  3 | abc |
+SELECT TOP 3 * FROM test;
+
+-- output:
+-- | id |
+-- |  4 |
+-- |  3 |
+SELECT TOP 2 id FROM test ORDER BY id DESC;
+
+INSERT INTO test VALUES(5, '20');
+INSERT INTO test VALUES(6, '10');
+
+-- Rows with equal keys stay in table order.
+-- output:
+-- | id | str |
+-- |  1 |  10 |
+-- |  6 |  10 |
+-- |  2 |  20 |
+SELECT TOP 3 * FROM test ORDER BY str;
+
+-- output:
+-- | id | str |
+-- |  3 | abc |
+-- |  4 |  40 |
+-- |  2 |  20 |
+-- |  5 |  20 |
+SELECT TOP 4 * FROM test ORDER BY str DESC, id;
+
+-- output:
+-- Empty result set
+SELECT TOP 0 id FROM test ORDER BY id;
+
+-- output:
+-- | id |
+-- |  1 |
+-- |  2 |
+-- |  3 |
+-- |  4 |
+-- |  5 |
+-- |  6 |
+SELECT TOP 10 id FROM test ORDER BY id;
+
+-- TOP after grouping
+-- output:
+-- | str | COUNT(id) |
+-- | abc |         1 |
+-- |  40 |         1 |
+SELECT TOP 2 str, COUNT(id) FROM test GROUP BY str ORDER BY str DESC;
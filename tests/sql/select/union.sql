@@ -15,7 +15,6 @@ INSERT INTO test (id, number, integer, date) VALUES (3, 420, 100, #1990-02-12#);
 -- |  4 |   69 | test1 |
 -- |  5 |   69 | test2 |
 -- |  3 |  420 |  null |
--- |  3 |  420 |  null |
 -- |  1 | 2137 |  null |
 SELECT id AS ID, number AS NUM, string AS STR FROM test ORDER BY number ASC UNION SELECT id AS ID, number AS NUM, string AS STR FROM test ORDER BY number DESC
 
@@ -0,0 +1,34 @@
+-- Enough rows for a few batches of rows.
+CREATE TABLE test (n INT);
+INSERT INTO test VALUES(1);
+INSERT INTO test (n) SELECT n + 1 FROM test;
+INSERT INTO test (n) SELECT n + 2 FROM test;
+INSERT INTO test (n) SELECT n + 4 FROM test;
+INSERT INTO test (n) SELECT n + 8 FROM test;
+INSERT INTO test (n) SELECT n + 16 FROM test;
+INSERT INTO test (n) SELECT n + 32 FROM test;
+INSERT INTO test (n) SELECT n + 64 FROM test;
+INSERT INTO test (n) SELECT n + 128 FROM test;
+INSERT INTO test (n) SELECT n + 256 FROM test;
+INSERT INTO test (n) SELECT n + 512 FROM test;
+INSERT INTO test (n) SELECT n + 1024 FROM test;
+INSERT INTO test (n) SELECT n + 2048 FROM test;
+
+-- Consecutive rows removed across a batch boundary, and the first and last rows.
+DELETE FROM test WHERE n > 1020 AND n < 1030;
+DELETE FROM test WHERE n = 1 OR n = 4096;
+UPDATE test SET n = n * 2;
+
+-- output:
+-- | COUNT(n) |   MIN(n) |      MAX(n) |
+-- |     4085 | 4.000000 | 8190.000000 |
+SELECT COUNT(n), MIN(n), MAX(n) FROM test;
+
+-- output:
+-- |    n |
+-- | 2036 |
+-- | 2038 |
+-- | 2040 |
+-- | 2060 |
+-- | 2062 |
+SELECT * FROM test WHERE n > 2034 AND n < 2064;
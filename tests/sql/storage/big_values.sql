@@ -0,0 +1,25 @@
+CREATE TABLE test (id INT, str VARCHAR);
+
+INSERT INTO test VALUES(0, REPLICATE('abcd', 5000));
+INSERT INTO test VALUES(1, 'small');
+INSERT INTO test VALUES(2, CONCAT(REPLICATE('x', 30000), 'end'));
+
+-- output:
+-- | id | LEN(str) | RIGHT(str, 4) |
+-- |  0 |    20000 |          abcd |
+-- |  1 |        5 |          mall |
+-- |  2 |    30003 |          xend |
+SELECT id, LEN(str), RIGHT(str, 4) FROM test;
+
+-- Freed extents are reused by blocks of any kind.
+DELETE FROM test WHERE id = 0;
+INSERT INTO test VALUES(3, REPLICATE('y', 10000));
+INSERT INTO test VALUES(4, 'another small');
+
+-- output:
+-- | id | LEN(str) | RIGHT(str, 4) |
+-- |  1 |        5 |          mall |
+-- |  2 |    30003 |          xend |
+-- |  3 |    10000 |          yyyy |
+-- |  4 |       13 |          mall |
+SELECT id, LEN(str), RIGHT(str, 4) FROM test;
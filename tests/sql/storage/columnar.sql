@@ -0,0 +1,93 @@
+CREATE TABLE test (id INT PRIMARY KEY, name VARCHAR UNIQUE, score FLOAT, active BOOL) ENGINE COLUMNAR;
+
+INSERT INTO test VALUES(1, 'first', 1.5, true);
+INSERT INTO test VALUES(2, 'second', NULL, false);
+INSERT INTO test (id, active) VALUES(3, true);
+
+-- error: Primary key must be unique
+INSERT INTO test VALUES(2, 'other', 0.5, true);
+-- error: Column 'name' must contain unique values
+INSERT INTO test VALUES(4, 'first', 0.5, true);
+
+-- output:
+-- | id |   name |    score | active |
+-- |  1 |  first | 1.500000 |   true |
+-- |  2 | second |     null |  false |
+-- |  3 |   null |     null |   true |
+SELECT * FROM test;
+
+UPDATE test SET name = CONCAT(name, ' updated');
+DELETE FROM test WHERE id = 2;
+INSERT INTO test VALUES(4, 'fourth', 4.0, false);
+
+-- output:
+-- | id |          name |    score | active |
+-- |  1 | first updated | 1.500000 |   true |
+-- |  3 |  null updated |     null |   true |
+-- |  4 |        fourth | 4.000000 |  false |
+SELECT * FROM test;
+
+-- error: Checks are not supported by the COLUMNAR engine
+CREATE TABLE checked (n INT CHECK n > 0) ENGINE COLUMNAR;
+
+-- error: Checks are not supported by the COLUMNAR engine
+CREATE TABLE checked (n INT CONSTRAINT positive CHECK n > 0) ENGINE COLUMNAR;
+
+-- Values that don't fit the column are rejected instead of stored as null.
+CREATE TABLE typed (n INT NOT NULL, name VARCHAR) ENGINE COLUMNAR;
+INSERT INTO typed VALUES(1, 'one');
+INSERT INTO typed VALUES(2, 'two');
+
+-- error: 'abc' is not a valid int
+UPDATE typed SET n = 'abc';
+
+-- output:
+-- | n | name |
+-- | 1 |  one |
+-- | 2 |  two |
+SELECT * FROM typed;
+
+-- Enough rows to fill a few row groups.
+CREATE TABLE big (n INT) ENGINE COLUMNAR;
+INSERT INTO big VALUES(1);
+INSERT INTO big (n) SELECT n + 1 FROM big;
+INSERT INTO big (n) SELECT n + 2 FROM big;
+INSERT INTO big (n) SELECT n + 4 FROM big;
+INSERT INTO big (n) SELECT n + 8 FROM big;
+INSERT INTO big (n) SELECT n + 16 FROM big;
+INSERT INTO big (n) SELECT n + 32 FROM big;
+INSERT INTO big (n) SELECT n + 64 FROM big;
+INSERT INTO big (n) SELECT n + 128 FROM big;
+INSERT INTO big (n) SELECT n + 256 FROM big;
+INSERT INTO big (n) SELECT n + 512 FROM big;
+INSERT INTO big (n) SELECT n + 1024 FROM big;
+
+-- output:
+-- | COUNT(n) |   MIN(n) |      MAX(n) |
+-- |     2048 | 1.000000 | 2048.000000 |
+SELECT COUNT(n), MIN(n), MAX(n) FROM big;
+
+-- Removed rows are compacted across row group boundaries.
+DELETE FROM big WHERE n < 1000;
+INSERT INTO big VALUES(0);
+
+-- output:
+-- | COUNT(n) |   MIN(n) |      MAX(n) |
+-- |     1050 | 0.000000 | 2048.000000 |
+SELECT COUNT(n), MIN(n), MAX(n) FROM big;
+
+-- A few removed rows stay in their row groups until more are removed.
+DELETE FROM big WHERE n = 1500;
+UPDATE big SET n = n + 1;
+INSERT INTO big VALUES(5000);
+
+-- output:
+-- | COUNT(n) |   MIN(n) |      MAX(n) |
+-- |     1050 | 1.000000 | 5000.000000 |
+SELECT COUNT(n), MIN(n), MAX(n) FROM big;
+
+-- output:
+-- |    n |
+-- | 1500 |
+-- | 1502 |
+SELECT n FROM big WHERE n > 1499 AND n < 1503;
@@ -0,0 +1,632 @@
+-- Enough keys to split index nodes a few times. Names share a long
+-- prefix, so that they can be told apart only by the whole value.
+CREATE TABLE test (id INT PRIMARY KEY, name VARCHAR UNIQUE);
+
+INSERT INTO test VALUES(0, 'some long common prefix 0');
+INSERT INTO test VALUES(367, 'some long common prefix 367');
+INSERT INTO test VALUES(134, 'some long common prefix 134');
+INSERT INTO test VALUES(501, 'some long common prefix 501');
+INSERT INTO test VALUES(268, 'some long common prefix 268');
+INSERT INTO test VALUES(35, 'some long common prefix 35');
+INSERT INTO test VALUES(402, 'some long common prefix 402');
+INSERT INTO test VALUES(169, 'some long common prefix 169');
+INSERT INTO test VALUES(536, 'some long common prefix 536');
+INSERT INTO test VALUES(303, 'some long common prefix 303');
+INSERT INTO test VALUES(70, 'some long common prefix 70');
+INSERT INTO test VALUES(437, 'some long common prefix 437');
+INSERT INTO test VALUES(204, 'some long common prefix 204');
+INSERT INTO test VALUES(571, 'some long common prefix 571');
+INSERT INTO test VALUES(338, 'some long common prefix 338');
+INSERT INTO test VALUES(105, 'some long common prefix 105');
+INSERT INTO test VALUES(472, 'some long common prefix 472');
+INSERT INTO test VALUES(239, 'some long common prefix 239');
+INSERT INTO test VALUES(6, 'some long common prefix 6');
+INSERT INTO test VALUES(373, 'some long common prefix 373');
+INSERT INTO test VALUES(140, 'some long common prefix 140');
+INSERT INTO test VALUES(507, 'some long common prefix 507');
+INSERT INTO test VALUES(274, 'some long common prefix 274');
+INSERT INTO test VALUES(41, 'some long common prefix 41');
+INSERT INTO test VALUES(408, 'some long common prefix 408');
+INSERT INTO test VALUES(175, 'some long common prefix 175');
+INSERT INTO test VALUES(542, 'some long common prefix 542');
+INSERT INTO test VALUES(309, 'some long common prefix 309');
+INSERT INTO test VALUES(76, 'some long common prefix 76');
+INSERT INTO test VALUES(443, 'some long common prefix 443');
+INSERT INTO test VALUES(210, 'some long common prefix 210');
+INSERT INTO test VALUES(577, 'some long common prefix 577');
+INSERT INTO test VALUES(344, 'some long common prefix 344');
+INSERT INTO test VALUES(111, 'some long common prefix 111');
+INSERT INTO test VALUES(478, 'some long common prefix 478');
+INSERT INTO test VALUES(245, 'some long common prefix 245');
+INSERT INTO test VALUES(12, 'some long common prefix 12');
+INSERT INTO test VALUES(379, 'some long common prefix 379');
+INSERT INTO test VALUES(146, 'some long common prefix 146');
+INSERT INTO test VALUES(513, 'some long common prefix 513');
+INSERT INTO test VALUES(280, 'some long common prefix 280');
+INSERT INTO test VALUES(47, 'some long common prefix 47');
+INSERT INTO test VALUES(414, 'some long common prefix 414');
+INSERT INTO test VALUES(181, 'some long common prefix 181');
+INSERT INTO test VALUES(548, 'some long common prefix 548');
+INSERT INTO test VALUES(315, 'some long common prefix 315');
+INSERT INTO test VALUES(82, 'some long common prefix 82');
+INSERT INTO test VALUES(449, 'some long common prefix 449');
+INSERT INTO test VALUES(216, 'some long common prefix 216');
+INSERT INTO test VALUES(583, 'some long common prefix 583');
+INSERT INTO test VALUES(350, 'some long common prefix 350');
+INSERT INTO test VALUES(117, 'some long common prefix 117');
+INSERT INTO test VALUES(484, 'some long common prefix 484');
+INSERT INTO test VALUES(251, 'some long common prefix 251');
+INSERT INTO test VALUES(18, 'some long common prefix 18');
+INSERT INTO test VALUES(385, 'some long common prefix 385');
+INSERT INTO test VALUES(152, 'some long common prefix 152');
+INSERT INTO test VALUES(519, 'some long common prefix 519');
+INSERT INTO test VALUES(286, 'some long common prefix 286');
+INSERT INTO test VALUES(53, 'some long common prefix 53');
+INSERT INTO test VALUES(420, 'some long common prefix 420');
+INSERT INTO test VALUES(187, 'some long common prefix 187');
+INSERT INTO test VALUES(554, 'some long common prefix 554');
+INSERT INTO test VALUES(321, 'some long common prefix 321');
+INSERT INTO test VALUES(88, 'some long common prefix 88');
+INSERT INTO test VALUES(455, 'some long common prefix 455');
+INSERT INTO test VALUES(222, 'some long common prefix 222');
+INSERT INTO test VALUES(589, 'some long common prefix 589');
+INSERT INTO test VALUES(356, 'some long common prefix 356');
+INSERT INTO test VALUES(123, 'some long common prefix 123');
+INSERT INTO test VALUES(490, 'some long common prefix 490');
+INSERT INTO test VALUES(257, 'some long common prefix 257');
+INSERT INTO test VALUES(24, 'some long common prefix 24');
+INSERT INTO test VALUES(391, 'some long common prefix 391');
+INSERT INTO test VALUES(158, 'some long common prefix 158');
+INSERT INTO test VALUES(525, 'some long common prefix 525');
+INSERT INTO test VALUES(292, 'some long common prefix 292');
+INSERT INTO test VALUES(59, 'some long common prefix 59');
+INSERT INTO test VALUES(426, 'some long common prefix 426');
+INSERT INTO test VALUES(193, 'some long common prefix 193');
+INSERT INTO test VALUES(560, 'some long common prefix 560');
+INSERT INTO test VALUES(327, 'some long common prefix 327');
+INSERT INTO test VALUES(94, 'some long common prefix 94');
+INSERT INTO test VALUES(461, 'some long common prefix 461');
+INSERT INTO test VALUES(228, 'some long common prefix 228');
+INSERT INTO test VALUES(595, 'some long common prefix 595');
+INSERT INTO test VALUES(362, 'some long common prefix 362');
+INSERT INTO test VALUES(129, 'some long common prefix 129');
+INSERT INTO test VALUES(496, 'some long common prefix 496');
+INSERT INTO test VALUES(263, 'some long common prefix 263');
+INSERT INTO test VALUES(30, 'some long common prefix 30');
+INSERT INTO test VALUES(397, 'some long common prefix 397');
+INSERT INTO test VALUES(164, 'some long common prefix 164');
+INSERT INTO test VALUES(531, 'some long common prefix 531');
+INSERT INTO test VALUES(298, 'some long common prefix 298');
+INSERT INTO test VALUES(65, 'some long common prefix 65');
+INSERT INTO test VALUES(432, 'some long common prefix 432');
+INSERT INTO test VALUES(199, 'some long common prefix 199');
+INSERT INTO test VALUES(566, 'some long common prefix 566');
+INSERT INTO test VALUES(333, 'some long common prefix 333');
+INSERT INTO test VALUES(100, 'some long common prefix 100');
+INSERT INTO test VALUES(467, 'some long common prefix 467');
+INSERT INTO test VALUES(234, 'some long common prefix 234');
+INSERT INTO test VALUES(1, 'some long common prefix 1');
+INSERT INTO test VALUES(368, 'some long common prefix 368');
+INSERT INTO test VALUES(135, 'some long common prefix 135');
+INSERT INTO test VALUES(502, 'some long common prefix 502');
+INSERT INTO test VALUES(269, 'some long common prefix 269');
+INSERT INTO test VALUES(36, 'some long common prefix 36');
+INSERT INTO test VALUES(403, 'some long common prefix 403');
+INSERT INTO test VALUES(170, 'some long common prefix 170');
+INSERT INTO test VALUES(537, 'some long common prefix 537');
+INSERT INTO test VALUES(304, 'some long common prefix 304');
+INSERT INTO test VALUES(71, 'some long common prefix 71');
+INSERT INTO test VALUES(438, 'some long common prefix 438');
+INSERT INTO test VALUES(205, 'some long common prefix 205');
+INSERT INTO test VALUES(572, 'some long common prefix 572');
+INSERT INTO test VALUES(339, 'some long common prefix 339');
+INSERT INTO test VALUES(106, 'some long common prefix 106');
+INSERT INTO test VALUES(473, 'some long common prefix 473');
+INSERT INTO test VALUES(240, 'some long common prefix 240');
+INSERT INTO test VALUES(7, 'some long common prefix 7');
+INSERT INTO test VALUES(374, 'some long common prefix 374');
+INSERT INTO test VALUES(141, 'some long common prefix 141');
+INSERT INTO test VALUES(508, 'some long common prefix 508');
+INSERT INTO test VALUES(275, 'some long common prefix 275');
+INSERT INTO test VALUES(42, 'some long common prefix 42');
+INSERT INTO test VALUES(409, 'some long common prefix 409');
+INSERT INTO test VALUES(176, 'some long common prefix 176');
+INSERT INTO test VALUES(543, 'some long common prefix 543');
+INSERT INTO test VALUES(310, 'some long common prefix 310');
+INSERT INTO test VALUES(77, 'some long common prefix 77');
+INSERT INTO test VALUES(444, 'some long common prefix 444');
+INSERT INTO test VALUES(211, 'some long common prefix 211');
+INSERT INTO test VALUES(578, 'some long common prefix 578');
+INSERT INTO test VALUES(345, 'some long common prefix 345');
+INSERT INTO test VALUES(112, 'some long common prefix 112');
+INSERT INTO test VALUES(479, 'some long common prefix 479');
+INSERT INTO test VALUES(246, 'some long common prefix 246');
+INSERT INTO test VALUES(13, 'some long common prefix 13');
+INSERT INTO test VALUES(380, 'some long common prefix 380');
+INSERT INTO test VALUES(147, 'some long common prefix 147');
+INSERT INTO test VALUES(514, 'some long common prefix 514');
+INSERT INTO test VALUES(281, 'some long common prefix 281');
+INSERT INTO test VALUES(48, 'some long common prefix 48');
+INSERT INTO test VALUES(415, 'some long common prefix 415');
+INSERT INTO test VALUES(182, 'some long common prefix 182');
+INSERT INTO test VALUES(549, 'some long common prefix 549');
+INSERT INTO test VALUES(316, 'some long common prefix 316');
+INSERT INTO test VALUES(83, 'some long common prefix 83');
+INSERT INTO test VALUES(450, 'some long common prefix 450');
+INSERT INTO test VALUES(217, 'some long common prefix 217');
+INSERT INTO test VALUES(584, 'some long common prefix 584');
+INSERT INTO test VALUES(351, 'some long common prefix 351');
+INSERT INTO test VALUES(118, 'some long common prefix 118');
+INSERT INTO test VALUES(485, 'some long common prefix 485');
+INSERT INTO test VALUES(252, 'some long common prefix 252');
+INSERT INTO test VALUES(19, 'some long common prefix 19');
+INSERT INTO test VALUES(386, 'some long common prefix 386');
+INSERT INTO test VALUES(153, 'some long common prefix 153');
+INSERT INTO test VALUES(520, 'some long common prefix 520');
+INSERT INTO test VALUES(287, 'some long common prefix 287');
+INSERT INTO test VALUES(54, 'some long common prefix 54');
+INSERT INTO test VALUES(421, 'some long common prefix 421');
+INSERT INTO test VALUES(188, 'some long common prefix 188');
+INSERT INTO test VALUES(555, 'some long common prefix 555');
+INSERT INTO test VALUES(322, 'some long common prefix 322');
+INSERT INTO test VALUES(89, 'some long common prefix 89');
+INSERT INTO test VALUES(456, 'some long common prefix 456');
+INSERT INTO test VALUES(223, 'some long common prefix 223');
+INSERT INTO test VALUES(590, 'some long common prefix 590');
+INSERT INTO test VALUES(357, 'some long common prefix 357');
+INSERT INTO test VALUES(124, 'some long common prefix 124');
+INSERT INTO test VALUES(491, 'some long common prefix 491');
+INSERT INTO test VALUES(258, 'some long common prefix 258');
+INSERT INTO test VALUES(25, 'some long common prefix 25');
+INSERT INTO test VALUES(392, 'some long common prefix 392');
+INSERT INTO test VALUES(159, 'some long common prefix 159');
+INSERT INTO test VALUES(526, 'some long common prefix 526');
+INSERT INTO test VALUES(293, 'some long common prefix 293');
+INSERT INTO test VALUES(60, 'some long common prefix 60');
+INSERT INTO test VALUES(427, 'some long common prefix 427');
+INSERT INTO test VALUES(194, 'some long common prefix 194');
+INSERT INTO test VALUES(561, 'some long common prefix 561');
+INSERT INTO test VALUES(328, 'some long common prefix 328');
+INSERT INTO test VALUES(95, 'some long common prefix 95');
+INSERT INTO test VALUES(462, 'some long common prefix 462');
+INSERT INTO test VALUES(229, 'some long common prefix 229');
+INSERT INTO test VALUES(596, 'some long common prefix 596');
+INSERT INTO test VALUES(363, 'some long common prefix 363');
+INSERT INTO test VALUES(130, 'some long common prefix 130');
+INSERT INTO test VALUES(497, 'some long common prefix 497');
+INSERT INTO test VALUES(264, 'some long common prefix 264');
+INSERT INTO test VALUES(31, 'some long common prefix 31');
+INSERT INTO test VALUES(398, 'some long common prefix 398');
+INSERT INTO test VALUES(165, 'some long common prefix 165');
+INSERT INTO test VALUES(532, 'some long common prefix 532');
+INSERT INTO test VALUES(299, 'some long common prefix 299');
+INSERT INTO test VALUES(66, 'some long common prefix 66');
+INSERT INTO test VALUES(433, 'some long common prefix 433');
+INSERT INTO test VALUES(200, 'some long common prefix 200');
+INSERT INTO test VALUES(567, 'some long common prefix 567');
+INSERT INTO test VALUES(334, 'some long common prefix 334');
+INSERT INTO test VALUES(101, 'some long common prefix 101');
+INSERT INTO test VALUES(468, 'some long common prefix 468');
+INSERT INTO test VALUES(235, 'some long common prefix 235');
+INSERT INTO test VALUES(2, 'some long common prefix 2');
+INSERT INTO test VALUES(369, 'some long common prefix 369');
+INSERT INTO test VALUES(136, 'some long common prefix 136');
+INSERT INTO test VALUES(503, 'some long common prefix 503');
+INSERT INTO test VALUES(270, 'some long common prefix 270');
+INSERT INTO test VALUES(37, 'some long common prefix 37');
+INSERT INTO test VALUES(404, 'some long common prefix 404');
+INSERT INTO test VALUES(171, 'some long common prefix 171');
+INSERT INTO test VALUES(538, 'some long common prefix 538');
+INSERT INTO test VALUES(305, 'some long common prefix 305');
+INSERT INTO test VALUES(72, 'some long common prefix 72');
+INSERT INTO test VALUES(439, 'some long common prefix 439');
+INSERT INTO test VALUES(206, 'some long common prefix 206');
+INSERT INTO test VALUES(573, 'some long common prefix 573');
+INSERT INTO test VALUES(340, 'some long common prefix 340');
+INSERT INTO test VALUES(107, 'some long common prefix 107');
+INSERT INTO test VALUES(474, 'some long common prefix 474');
+INSERT INTO test VALUES(241, 'some long common prefix 241');
+INSERT INTO test VALUES(8, 'some long common prefix 8');
+INSERT INTO test VALUES(375, 'some long common prefix 375');
+INSERT INTO test VALUES(142, 'some long common prefix 142');
+INSERT INTO test VALUES(509, 'some long common prefix 509');
+INSERT INTO test VALUES(276, 'some long common prefix 276');
+INSERT INTO test VALUES(43, 'some long common prefix 43');
+INSERT INTO test VALUES(410, 'some long common prefix 410');
+INSERT INTO test VALUES(177, 'some long common prefix 177');
+INSERT INTO test VALUES(544, 'some long common prefix 544');
+INSERT INTO test VALUES(311, 'some long common prefix 311');
+INSERT INTO test VALUES(78, 'some long common prefix 78');
+INSERT INTO test VALUES(445, 'some long common prefix 445');
+INSERT INTO test VALUES(212, 'some long common prefix 212');
+INSERT INTO test VALUES(579, 'some long common prefix 579');
+INSERT INTO test VALUES(346, 'some long common prefix 346');
+INSERT INTO test VALUES(113, 'some long common prefix 113');
+INSERT INTO test VALUES(480, 'some long common prefix 480');
+INSERT INTO test VALUES(247, 'some long common prefix 247');
+INSERT INTO test VALUES(14, 'some long common prefix 14');
+INSERT INTO test VALUES(381, 'some long common prefix 381');
+INSERT INTO test VALUES(148, 'some long common prefix 148');
+INSERT INTO test VALUES(515, 'some long common prefix 515');
+INSERT INTO test VALUES(282, 'some long common prefix 282');
+INSERT INTO test VALUES(49, 'some long common prefix 49');
+INSERT INTO test VALUES(416, 'some long common prefix 416');
+INSERT INTO test VALUES(183, 'some long common prefix 183');
+INSERT INTO test VALUES(550, 'some long common prefix 550');
+INSERT INTO test VALUES(317, 'some long common prefix 317');
+INSERT INTO test VALUES(84, 'some long common prefix 84');
+INSERT INTO test VALUES(451, 'some long common prefix 451');
+INSERT INTO test VALUES(218, 'some long common prefix 218');
+INSERT INTO test VALUES(585, 'some long common prefix 585');
+INSERT INTO test VALUES(352, 'some long common prefix 352');
+INSERT INTO test VALUES(119, 'some long common prefix 119');
+INSERT INTO test VALUES(486, 'some long common prefix 486');
+INSERT INTO test VALUES(253, 'some long common prefix 253');
+INSERT INTO test VALUES(20, 'some long common prefix 20');
+INSERT INTO test VALUES(387, 'some long common prefix 387');
+INSERT INTO test VALUES(154, 'some long common prefix 154');
+INSERT INTO test VALUES(521, 'some long common prefix 521');
+INSERT INTO test VALUES(288, 'some long common prefix 288');
+INSERT INTO test VALUES(55, 'some long common prefix 55');
+INSERT INTO test VALUES(422, 'some long common prefix 422');
+INSERT INTO test VALUES(189, 'some long common prefix 189');
+INSERT INTO test VALUES(556, 'some long common prefix 556');
+INSERT INTO test VALUES(323, 'some long common prefix 323');
+INSERT INTO test VALUES(90, 'some long common prefix 90');
+INSERT INTO test VALUES(457, 'some long common prefix 457');
+INSERT INTO test VALUES(224, 'some long common prefix 224');
+INSERT INTO test VALUES(591, 'some long common prefix 591');
+INSERT INTO test VALUES(358, 'some long common prefix 358');
+INSERT INTO test VALUES(125, 'some long common prefix 125');
+INSERT INTO test VALUES(492, 'some long common prefix 492');
+INSERT INTO test VALUES(259, 'some long common prefix 259');
+INSERT INTO test VALUES(26, 'some long common prefix 26');
+INSERT INTO test VALUES(393, 'some long common prefix 393');
+INSERT INTO test VALUES(160, 'some long common prefix 160');
+INSERT INTO test VALUES(527, 'some long common prefix 527');
+INSERT INTO test VALUES(294, 'some long common prefix 294');
+INSERT INTO test VALUES(61, 'some long common prefix 61');
+INSERT INTO test VALUES(428, 'some long common prefix 428');
+INSERT INTO test VALUES(195, 'some long common prefix 195');
+INSERT INTO test VALUES(562, 'some long common prefix 562');
+INSERT INTO test VALUES(329, 'some long common prefix 329');
+INSERT INTO test VALUES(96, 'some long common prefix 96');
+INSERT INTO test VALUES(463, 'some long common prefix 463');
+INSERT INTO test VALUES(230, 'some long common prefix 230');
+INSERT INTO test VALUES(597, 'some long common prefix 597');
+INSERT INTO test VALUES(364, 'some long common prefix 364');
+INSERT INTO test VALUES(131, 'some long common prefix 131');
+INSERT INTO test VALUES(498, 'some long common prefix 498');
+INSERT INTO test VALUES(265, 'some long common prefix 265');
+INSERT INTO test VALUES(32, 'some long common prefix 32');
+INSERT INTO test VALUES(399, 'some long common prefix 399');
+INSERT INTO test VALUES(166, 'some long common prefix 166');
+INSERT INTO test VALUES(533, 'some long common prefix 533');
+INSERT INTO test VALUES(300, 'some long common prefix 300');
+INSERT INTO test VALUES(67, 'some long common prefix 67');
+INSERT INTO test VALUES(434, 'some long common prefix 434');
+INSERT INTO test VALUES(201, 'some long common prefix 201');
+INSERT INTO test VALUES(568, 'some long common prefix 568');
+INSERT INTO test VALUES(335, 'some long common prefix 335');
+INSERT INTO test VALUES(102, 'some long common prefix 102');
+INSERT INTO test VALUES(469, 'some long common prefix 469');
+INSERT INTO test VALUES(236, 'some long common prefix 236');
+INSERT INTO test VALUES(3, 'some long common prefix 3');
+INSERT INTO test VALUES(370, 'some long common prefix 370');
+INSERT INTO test VALUES(137, 'some long common prefix 137');
+INSERT INTO test VALUES(504, 'some long common prefix 504');
+INSERT INTO test VALUES(271, 'some long common prefix 271');
+INSERT INTO test VALUES(38, 'some long common prefix 38');
+INSERT INTO test VALUES(405, 'some long common prefix 405');
+INSERT INTO test VALUES(172, 'some long common prefix 172');
+INSERT INTO test VALUES(539, 'some long common prefix 539');
+INSERT INTO test VALUES(306, 'some long common prefix 306');
+INSERT INTO test VALUES(73, 'some long common prefix 73');
+INSERT INTO test VALUES(440, 'some long common prefix 440');
+INSERT INTO test VALUES(207, 'some long common prefix 207');
+INSERT INTO test VALUES(574, 'some long common prefix 574');
+INSERT INTO test VALUES(341, 'some long common prefix 341');
+INSERT INTO test VALUES(108, 'some long common prefix 108');
+INSERT INTO test VALUES(475, 'some long common prefix 475');
+INSERT INTO test VALUES(242, 'some long common prefix 242');
+INSERT INTO test VALUES(9, 'some long common prefix 9');
+INSERT INTO test VALUES(376, 'some long common prefix 376');
+INSERT INTO test VALUES(143, 'some long common prefix 143');
+INSERT INTO test VALUES(510, 'some long common prefix 510');
+INSERT INTO test VALUES(277, 'some long common prefix 277');
+INSERT INTO test VALUES(44, 'some long common prefix 44');
+INSERT INTO test VALUES(411, 'some long common prefix 411');
+INSERT INTO test VALUES(178, 'some long common prefix 178');
+INSERT INTO test VALUES(545, 'some long common prefix 545');
+INSERT INTO test VALUES(312, 'some long common prefix 312');
+INSERT INTO test VALUES(79, 'some long common prefix 79');
+INSERT INTO test VALUES(446, 'some long common prefix 446');
+INSERT INTO test VALUES(213, 'some long common prefix 213');
+INSERT INTO test VALUES(580, 'some long common prefix 580');
+INSERT INTO test VALUES(347, 'some long common prefix 347');
+INSERT INTO test VALUES(114, 'some long common prefix 114');
+INSERT INTO test VALUES(481, 'some long common prefix 481');
+INSERT INTO test VALUES(248, 'some long common prefix 248');
+INSERT INTO test VALUES(15, 'some long common prefix 15');
+INSERT INTO test VALUES(382, 'some long common prefix 382');
+INSERT INTO test VALUES(149, 'some long common prefix 149');
+INSERT INTO test VALUES(516, 'some long common prefix 516');
+INSERT INTO test VALUES(283, 'some long common prefix 283');
+INSERT INTO test VALUES(50, 'some long common prefix 50');
+INSERT INTO test VALUES(417, 'some long common prefix 417');
+INSERT INTO test VALUES(184, 'some long common prefix 184');
+INSERT INTO test VALUES(551, 'some long common prefix 551');
+INSERT INTO test VALUES(318, 'some long common prefix 318');
+INSERT INTO test VALUES(85, 'some long common prefix 85');
+INSERT INTO test VALUES(452, 'some long common prefix 452');
+INSERT INTO test VALUES(219, 'some long common prefix 219');
+INSERT INTO test VALUES(586, 'some long common prefix 586');
+INSERT INTO test VALUES(353, 'some long common prefix 353');
+INSERT INTO test VALUES(120, 'some long common prefix 120');
+INSERT INTO test VALUES(487, 'some long common prefix 487');
+INSERT INTO test VALUES(254, 'some long common prefix 254');
+INSERT INTO test VALUES(21, 'some long common prefix 21');
+INSERT INTO test VALUES(388, 'some long common prefix 388');
+INSERT INTO test VALUES(155, 'some long common prefix 155');
+INSERT INTO test VALUES(522, 'some long common prefix 522');
+INSERT INTO test VALUES(289, 'some long common prefix 289');
+INSERT INTO test VALUES(56, 'some long common prefix 56');
+INSERT INTO test VALUES(423, 'some long common prefix 423');
+INSERT INTO test VALUES(190, 'some long common prefix 190');
+INSERT INTO test VALUES(557, 'some long common prefix 557');
+INSERT INTO test VALUES(324, 'some long common prefix 324');
+INSERT INTO test VALUES(91, 'some long common prefix 91');
+INSERT INTO test VALUES(458, 'some long common prefix 458');
+INSERT INTO test VALUES(225, 'some long common prefix 225');
+INSERT INTO test VALUES(592, 'some long common prefix 592');
+INSERT INTO test VALUES(359, 'some long common prefix 359');
+INSERT INTO test VALUES(126, 'some long common prefix 126');
+INSERT INTO test VALUES(493, 'some long common prefix 493');
+INSERT INTO test VALUES(260, 'some long common prefix 260');
+INSERT INTO test VALUES(27, 'some long common prefix 27');
+INSERT INTO test VALUES(394, 'some long common prefix 394');
+INSERT INTO test VALUES(161, 'some long common prefix 161');
+INSERT INTO test VALUES(528, 'some long common prefix 528');
+INSERT INTO test VALUES(295, 'some long common prefix 295');
+INSERT INTO test VALUES(62, 'some long common prefix 62');
+INSERT INTO test VALUES(429, 'some long common prefix 429');
+INSERT INTO test VALUES(196, 'some long common prefix 196');
+INSERT INTO test VALUES(563, 'some long common prefix 563');
+INSERT INTO test VALUES(330, 'some long common prefix 330');
+INSERT INTO test VALUES(97, 'some long common prefix 97');
+INSERT INTO test VALUES(464, 'some long common prefix 464');
+INSERT INTO test VALUES(231, 'some long common prefix 231');
+INSERT INTO test VALUES(598, 'some long common prefix 598');
+INSERT INTO test VALUES(365, 'some long common prefix 365');
+INSERT INTO test VALUES(132, 'some long common prefix 132');
+INSERT INTO test VALUES(499, 'some long common prefix 499');
+INSERT INTO test VALUES(266, 'some long common prefix 266');
+INSERT INTO test VALUES(33, 'some long common prefix 33');
+INSERT INTO test VALUES(400, 'some long common prefix 400');
+INSERT INTO test VALUES(167, 'some long common prefix 167');
+INSERT INTO test VALUES(534, 'some long common prefix 534');
+INSERT INTO test VALUES(301, 'some long common prefix 301');
+INSERT INTO test VALUES(68, 'some long common prefix 68');
+INSERT INTO test VALUES(435, 'some long common prefix 435');
+INSERT INTO test VALUES(202, 'some long common prefix 202');
+INSERT INTO test VALUES(569, 'some long common prefix 569');
+INSERT INTO test VALUES(336, 'some long common prefix 336');
+INSERT INTO test VALUES(103, 'some long common prefix 103');
+INSERT INTO test VALUES(470, 'some long common prefix 470');
+INSERT INTO test VALUES(237, 'some long common prefix 237');
+INSERT INTO test VALUES(4, 'some long common prefix 4');
+INSERT INTO test VALUES(371, 'some long common prefix 371');
+INSERT INTO test VALUES(138, 'some long common prefix 138');
+INSERT INTO test VALUES(505, 'some long common prefix 505');
+INSERT INTO test VALUES(272, 'some long common prefix 272');
+INSERT INTO test VALUES(39, 'some long common prefix 39');
+INSERT INTO test VALUES(406, 'some long common prefix 406');
+INSERT INTO test VALUES(173, 'some long common prefix 173');
+INSERT INTO test VALUES(540, 'some long common prefix 540');
+INSERT INTO test VALUES(307, 'some long common prefix 307');
+INSERT INTO test VALUES(74, 'some long common prefix 74');
+INSERT INTO test VALUES(441, 'some long common prefix 441');
+INSERT INTO test VALUES(208, 'some long common prefix 208');
+INSERT INTO test VALUES(575, 'some long common prefix 575');
+INSERT INTO test VALUES(342, 'some long common prefix 342');
+INSERT INTO test VALUES(109, 'some long common prefix 109');
+INSERT INTO test VALUES(476, 'some long common prefix 476');
+INSERT INTO test VALUES(243, 'some long common prefix 243');
+INSERT INTO test VALUES(10, 'some long common prefix 10');
+INSERT INTO test VALUES(377, 'some long common prefix 377');
+INSERT INTO test VALUES(144, 'some long common prefix 144');
+INSERT INTO test VALUES(511, 'some long common prefix 511');
+INSERT INTO test VALUES(278, 'some long common prefix 278');
+INSERT INTO test VALUES(45, 'some long common prefix 45');
+INSERT INTO test VALUES(412, 'some long common prefix 412');
+INSERT INTO test VALUES(179, 'some long common prefix 179');
+INSERT INTO test VALUES(546, 'some long common prefix 546');
+INSERT INTO test VALUES(313, 'some long common prefix 313');
+INSERT INTO test VALUES(80, 'some long common prefix 80');
+INSERT INTO test VALUES(447, 'some long common prefix 447');
+INSERT INTO test VALUES(214, 'some long common prefix 214');
+INSERT INTO test VALUES(581, 'some long common prefix 581');
+INSERT INTO test VALUES(348, 'some long common prefix 348');
+INSERT INTO test VALUES(115, 'some long common prefix 115');
+INSERT INTO test VALUES(482, 'some long common prefix 482');
+INSERT INTO test VALUES(249, 'some long common prefix 249');
+INSERT INTO test VALUES(16, 'some long common prefix 16');
+INSERT INTO test VALUES(383, 'some long common prefix 383');
+INSERT INTO test VALUES(150, 'some long common prefix 150');
+INSERT INTO test VALUES(517, 'some long common prefix 517');
+INSERT INTO test VALUES(284, 'some long common prefix 284');
+INSERT INTO test VALUES(51, 'some long common prefix 51');
+INSERT INTO test VALUES(418, 'some long common prefix 418');
+INSERT INTO test VALUES(185, 'some long common prefix 185');
+INSERT INTO test VALUES(552, 'some long common prefix 552');
+INSERT INTO test VALUES(319, 'some long common prefix 319');
+INSERT INTO test VALUES(86, 'some long common prefix 86');
+INSERT INTO test VALUES(453, 'some long common prefix 453');
+INSERT INTO test VALUES(220, 'some long common prefix 220');
+INSERT INTO test VALUES(587, 'some long common prefix 587');
+INSERT INTO test VALUES(354, 'some long common prefix 354');
+INSERT INTO test VALUES(121, 'some long common prefix 121');
+INSERT INTO test VALUES(488, 'some long common prefix 488');
+INSERT INTO test VALUES(255, 'some long common prefix 255');
+INSERT INTO test VALUES(22, 'some long common prefix 22');
+INSERT INTO test VALUES(389, 'some long common prefix 389');
+INSERT INTO test VALUES(156, 'some long common prefix 156');
+INSERT INTO test VALUES(523, 'some long common prefix 523');
+INSERT INTO test VALUES(290, 'some long common prefix 290');
+INSERT INTO test VALUES(57, 'some long common prefix 57');
+INSERT INTO test VALUES(424, 'some long common prefix 424');
+INSERT INTO test VALUES(191, 'some long common prefix 191');
+INSERT INTO test VALUES(558, 'some long common prefix 558');
+INSERT INTO test VALUES(325, 'some long common prefix 325');
+INSERT INTO test VALUES(92, 'some long common prefix 92');
+INSERT INTO test VALUES(459, 'some long common prefix 459');
+INSERT INTO test VALUES(226, 'some long common prefix 226');
+INSERT INTO test VALUES(593, 'some long common prefix 593');
+INSERT INTO test VALUES(360, 'some long common prefix 360');
+INSERT INTO test VALUES(127, 'some long common prefix 127');
+INSERT INTO test VALUES(494, 'some long common prefix 494');
+INSERT INTO test VALUES(261, 'some long common prefix 261');
+INSERT INTO test VALUES(28, 'some long common prefix 28');
+INSERT INTO test VALUES(395, 'some long common prefix 395');
+INSERT INTO test VALUES(162, 'some long common prefix 162');
+INSERT INTO test VALUES(529, 'some long common prefix 529');
+INSERT INTO test VALUES(296, 'some long common prefix 296');
+INSERT INTO test VALUES(63, 'some long common prefix 63');
+INSERT INTO test VALUES(430, 'some long common prefix 430');
+INSERT INTO test VALUES(197, 'some long common prefix 197');
+INSERT INTO test VALUES(564, 'some long common prefix 564');
+INSERT INTO test VALUES(331, 'some long common prefix 331');
+INSERT INTO test VALUES(98, 'some long common prefix 98');
+INSERT INTO test VALUES(465, 'some long common prefix 465');
+INSERT INTO test VALUES(232, 'some long common prefix 232');
+INSERT INTO test VALUES(599, 'some long common prefix 599');
+INSERT INTO test VALUES(366, 'some long common prefix 366');
+INSERT INTO test VALUES(133, 'some long common prefix 133');
+INSERT INTO test VALUES(500, 'some long common prefix 500');
+INSERT INTO test VALUES(267, 'some long common prefix 267');
+INSERT INTO test VALUES(34, 'some long common prefix 34');
+INSERT INTO test VALUES(401, 'some long common prefix 401');
+INSERT INTO test VALUES(168, 'some long common prefix 168');
+INSERT INTO test VALUES(535, 'some long common prefix 535');
+INSERT INTO test VALUES(302, 'some long common prefix 302');
+INSERT INTO test VALUES(69, 'some long common prefix 69');
+INSERT INTO test VALUES(436, 'some long common prefix 436');
+INSERT INTO test VALUES(203, 'some long common prefix 203');
+INSERT INTO test VALUES(570, 'some long common prefix 570');
+INSERT INTO test VALUES(337, 'some long common prefix 337');
+INSERT INTO test VALUES(104, 'some long common prefix 104');
+INSERT INTO test VALUES(471, 'some long common prefix 471');
+INSERT INTO test VALUES(238, 'some long common prefix 238');
+INSERT INTO test VALUES(5, 'some long common prefix 5');
+INSERT INTO test VALUES(372, 'some long common prefix 372');
+INSERT INTO test VALUES(139, 'some long common prefix 139');
+INSERT INTO test VALUES(506, 'some long common prefix 506');
+INSERT INTO test VALUES(273, 'some long common prefix 273');
+INSERT INTO test VALUES(40, 'some long common prefix 40');
+INSERT INTO test VALUES(407, 'some long common prefix 407');
+INSERT INTO test VALUES(174, 'some long common prefix 174');
+INSERT INTO test VALUES(541, 'some long common prefix 541');
+INSERT INTO test VALUES(308, 'some long common prefix 308');
+INSERT INTO test VALUES(75, 'some long common prefix 75');
+INSERT INTO test VALUES(442, 'some long common prefix 442');
+INSERT INTO test VALUES(209, 'some long common prefix 209');
+INSERT INTO test VALUES(576, 'some long common prefix 576');
+INSERT INTO test VALUES(343, 'some long common prefix 343');
+INSERT INTO test VALUES(110, 'some long common prefix 110');
+INSERT INTO test VALUES(477, 'some long common prefix 477');
+INSERT INTO test VALUES(244, 'some long common prefix 244');
+INSERT INTO test VALUES(11, 'some long common prefix 11');
+INSERT INTO test VALUES(378, 'some long common prefix 378');
+INSERT INTO test VALUES(145, 'some long common prefix 145');
+INSERT INTO test VALUES(512, 'some long common prefix 512');
+INSERT INTO test VALUES(279, 'some long common prefix 279');
+INSERT INTO test VALUES(46, 'some long common prefix 46');
+INSERT INTO test VALUES(413, 'some long common prefix 413');
+INSERT INTO test VALUES(180, 'some long common prefix 180');
+INSERT INTO test VALUES(547, 'some long common prefix 547');
+INSERT INTO test VALUES(314, 'some long common prefix 314');
+INSERT INTO test VALUES(81, 'some long common prefix 81');
+INSERT INTO test VALUES(448, 'some long common prefix 448');
+INSERT INTO test VALUES(215, 'some long common prefix 215');
+INSERT INTO test VALUES(582, 'some long common prefix 582');
+INSERT INTO test VALUES(349, 'some long common prefix 349');
+INSERT INTO test VALUES(116, 'some long common prefix 116');
+INSERT INTO test VALUES(483, 'some long common prefix 483');
+INSERT INTO test VALUES(250, 'some long common prefix 250');
+INSERT INTO test VALUES(17, 'some long common prefix 17');
+INSERT INTO test VALUES(384, 'some long common prefix 384');
+INSERT INTO test VALUES(151, 'some long common prefix 151');
+INSERT INTO test VALUES(518, 'some long common prefix 518');
+INSERT INTO test VALUES(285, 'some long common prefix 285');
+INSERT INTO test VALUES(52, 'some long common prefix 52');
+INSERT INTO test VALUES(419, 'some long common prefix 419');
+INSERT INTO test VALUES(186, 'some long common prefix 186');
+INSERT INTO test VALUES(553, 'some long common prefix 553');
+INSERT INTO test VALUES(320, 'some long common prefix 320');
+INSERT INTO test VALUES(87, 'some long common prefix 87');
+INSERT INTO test VALUES(454, 'some long common prefix 454');
+INSERT INTO test VALUES(221, 'some long common prefix 221');
+INSERT INTO test VALUES(588, 'some long common prefix 588');
+INSERT INTO test VALUES(355, 'some long common prefix 355');
+INSERT INTO test VALUES(122, 'some long common prefix 122');
+INSERT INTO test VALUES(489, 'some long common prefix 489');
+INSERT INTO test VALUES(256, 'some long common prefix 256');
+INSERT INTO test VALUES(23, 'some long common prefix 23');
+INSERT INTO test VALUES(390, 'some long common prefix 390');
+INSERT INTO test VALUES(157, 'some long common prefix 157');
+INSERT INTO test VALUES(524, 'some long common prefix 524');
+INSERT INTO test VALUES(291, 'some long common prefix 291');
+INSERT INTO test VALUES(58, 'some long common prefix 58');
+INSERT INTO test VALUES(425, 'some long common prefix 425');
+INSERT INTO test VALUES(192, 'some long common prefix 192');
+INSERT INTO test VALUES(559, 'some long common prefix 559');
+INSERT INTO test VALUES(326, 'some long common prefix 326');
+INSERT INTO test VALUES(93, 'some long common prefix 93');
+INSERT INTO test VALUES(460, 'some long common prefix 460');
+INSERT INTO test VALUES(227, 'some long common prefix 227');
+INSERT INTO test VALUES(594, 'some long common prefix 594');
+INSERT INTO test VALUES(361, 'some long common prefix 361');
+INSERT INTO test VALUES(128, 'some long common prefix 128');
+INSERT INTO test VALUES(495, 'some long common prefix 495');
+INSERT INTO test VALUES(262, 'some long common prefix 262');
+INSERT INTO test VALUES(29, 'some long common prefix 29');
+INSERT INTO test VALUES(396, 'some long common prefix 396');
+INSERT INTO test VALUES(163, 'some long common prefix 163');
+INSERT INTO test VALUES(530, 'some long common prefix 530');
+INSERT INTO test VALUES(297, 'some long common prefix 297');
+INSERT INTO test VALUES(64, 'some long common prefix 64');
+INSERT INTO test VALUES(431, 'some long common prefix 431');
+INSERT INTO test VALUES(198, 'some long common prefix 198');
+INSERT INTO test VALUES(565, 'some long common prefix 565');
+INSERT INTO test VALUES(332, 'some long common prefix 332');
+INSERT INTO test VALUES(99, 'some long common prefix 99');
+INSERT INTO test VALUES(466, 'some long common prefix 466');
+INSERT INTO test VALUES(233, 'some long common prefix 233');
+
+-- error: Primary key must be unique
+INSERT INTO test VALUES(0, 'new');
+-- error: Primary key must be unique
+INSERT INTO test VALUES(377, 'new');
+-- error: Primary key must be unique
+INSERT INTO test VALUES(599, 'new');
+-- error: Column 'name' must contain unique values
+INSERT INTO test VALUES(600, 'some long common prefix 431');
+INSERT INTO test VALUES(600, 'some long common prefix 600');
+
+DELETE FROM test WHERE id < 300;
+INSERT INTO test VALUES(17, 'some long common prefix 17');
+-- error: Primary key must be unique
+INSERT INTO test VALUES(17, 'new');
+-- error: Primary key must be unique
+INSERT INTO test VALUES(400, 'new');
+
+-- Keys are moved in the index when rows are updated.
+UPDATE test SET id = id + 1000;
+INSERT INTO test VALUES(400, 'new');
+-- error: Primary key must be unique
+INSERT INTO test VALUES(1400, 'new 2');
+
+-- output:
+-- | COUNT(id) |    MIN(id) |     MAX(id) |
+-- |       303 | 400.000000 | 1600.000000 |
+SELECT COUNT(id), MIN(id), MAX(id) FROM test;
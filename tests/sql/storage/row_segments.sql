@@ -0,0 +1,43 @@
+-- Enough rows to fill a few segments of a memory-backed table.
+CREATE TABLE test (n INT);
+INSERT INTO test VALUES(1);
+INSERT INTO test (n) SELECT n + 1 FROM test;
+INSERT INTO test (n) SELECT n + 2 FROM test;
+INSERT INTO test (n) SELECT n + 4 FROM test;
+INSERT INTO test (n) SELECT n + 8 FROM test;
+INSERT INTO test (n) SELECT n + 16 FROM test;
+INSERT INTO test (n) SELECT n + 32 FROM test;
+INSERT INTO test (n) SELECT n + 64 FROM test;
+INSERT INTO test (n) SELECT n + 128 FROM test;
+INSERT INTO test (n) SELECT n + 256 FROM test;
+
+-- A few removed rows are only marked as such.
+DELETE FROM test WHERE n = 300;
+UPDATE test SET n = n * 2;
+
+-- output:
+-- | COUNT(n) |   MIN(n) |      MAX(n) |
+-- |      511 | 2.000000 | 1024.000000 |
+SELECT COUNT(n), MIN(n), MAX(n) FROM test;
+
+-- Most rows removed, so the table is compacted.
+DELETE FROM test WHERE n < 1000;
+INSERT INTO test VALUES(0);
+
+-- output:
+-- |    n |
+-- | 1000 |
+-- | 1002 |
+-- | 1004 |
+-- | 1006 |
+-- | 1008 |
+-- | 1010 |
+-- | 1012 |
+-- | 1014 |
+-- | 1016 |
+-- | 1018 |
+-- | 1020 |
+-- | 1022 |
+-- | 1024 |
+-- |    0 |
+SELECT * FROM test;
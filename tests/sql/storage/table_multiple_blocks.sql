@@ -0,0 +1,1021 @@
+CREATE TABLE test (id INT);
+
+INSERT INTO test VALUES(0);
+INSERT INTO test VALUES(1);
+INSERT INTO test VALUES(2);
+INSERT INTO test VALUES(3);
+INSERT INTO test VALUES(4);
+INSERT INTO test VALUES(5);
+INSERT INTO test VALUES(6);
+INSERT INTO test VALUES(7);
+INSERT INTO test VALUES(8);
+INSERT INTO test VALUES(9);
+INSERT INTO test VALUES(10);
+INSERT INTO test VALUES(11);
+INSERT INTO test VALUES(12);
+INSERT INTO test VALUES(13);
+INSERT INTO test VALUES(14);
+INSERT INTO test VALUES(15);
+INSERT INTO test VALUES(16);
+INSERT INTO test VALUES(17);
+INSERT INTO test VALUES(18);
+INSERT INTO test VALUES(19);
+INSERT INTO test VALUES(20);
+INSERT INTO test VALUES(21);
+INSERT INTO test VALUES(22);
+INSERT INTO test VALUES(23);
+INSERT INTO test VALUES(24);
+INSERT INTO test VALUES(25);
+INSERT INTO test VALUES(26);
+INSERT INTO test VALUES(27);
+INSERT INTO test VALUES(28);
+INSERT INTO test VALUES(29);
+INSERT INTO test VALUES(30);
+INSERT INTO test VALUES(31);
+INSERT INTO test VALUES(32);
+INSERT INTO test VALUES(33);
+INSERT INTO test VALUES(34);
+INSERT INTO test VALUES(35);
+INSERT INTO test VALUES(36);
+INSERT INTO test VALUES(37);
+INSERT INTO test VALUES(38);
+INSERT INTO test VALUES(39);
+INSERT INTO test VALUES(40);
+INSERT INTO test VALUES(41);
+INSERT INTO test VALUES(42);
+INSERT INTO test VALUES(43);
+INSERT INTO test VALUES(44);
+INSERT INTO test VALUES(45);
+INSERT INTO test VALUES(46);
+INSERT INTO test VALUES(47);
+INSERT INTO test VALUES(48);
+INSERT INTO test VALUES(49);
+INSERT INTO test VALUES(50);
+INSERT INTO test VALUES(51);
+INSERT INTO test VALUES(52);
+INSERT INTO test VALUES(53);
+INSERT INTO test VALUES(54);
+INSERT INTO test VALUES(55);
+INSERT INTO test VALUES(56);
+INSERT INTO test VALUES(57);
+INSERT INTO test VALUES(58);
+INSERT INTO test VALUES(59);
+INSERT INTO test VALUES(60);
+INSERT INTO test VALUES(61);
+INSERT INTO test VALUES(62);
+INSERT INTO test VALUES(63);
+INSERT INTO test VALUES(64);
+INSERT INTO test VALUES(65);
+INSERT INTO test VALUES(66);
+INSERT INTO test VALUES(67);
+INSERT INTO test VALUES(68);
+INSERT INTO test VALUES(69);
+INSERT INTO test VALUES(70);
+INSERT INTO test VALUES(71);
+INSERT INTO test VALUES(72);
+INSERT INTO test VALUES(73);
+INSERT INTO test VALUES(74);
+INSERT INTO test VALUES(75);
+INSERT INTO test VALUES(76);
+INSERT INTO test VALUES(77);
+INSERT INTO test VALUES(78);
+INSERT INTO test VALUES(79);
+INSERT INTO test VALUES(80);
+INSERT INTO test VALUES(81);
+INSERT INTO test VALUES(82);
+INSERT INTO test VALUES(83);
+INSERT INTO test VALUES(84);
+INSERT INTO test VALUES(85);
+INSERT INTO test VALUES(86);
+INSERT INTO test VALUES(87);
+INSERT INTO test VALUES(88);
+INSERT INTO test VALUES(89);
+INSERT INTO test VALUES(90);
+INSERT INTO test VALUES(91);
+INSERT INTO test VALUES(92);
+INSERT INTO test VALUES(93);
+INSERT INTO test VALUES(94);
+INSERT INTO test VALUES(95);
+INSERT INTO test VALUES(96);
+INSERT INTO test VALUES(97);
+INSERT INTO test VALUES(98);
+INSERT INTO test VALUES(99);
+INSERT INTO test VALUES(100);
+INSERT INTO test VALUES(101);
+INSERT INTO test VALUES(102);
+INSERT INTO test VALUES(103);
+INSERT INTO test VALUES(104);
+INSERT INTO test VALUES(105);
+INSERT INTO test VALUES(106);
+INSERT INTO test VALUES(107);
+INSERT INTO test VALUES(108);
+INSERT INTO test VALUES(109);
+INSERT INTO test VALUES(110);
+INSERT INTO test VALUES(111);
+INSERT INTO test VALUES(112);
+INSERT INTO test VALUES(113);
+INSERT INTO test VALUES(114);
+INSERT INTO test VALUES(115);
+INSERT INTO test VALUES(116);
+INSERT INTO test VALUES(117);
+INSERT INTO test VALUES(118);
+INSERT INTO test VALUES(119);
+INSERT INTO test VALUES(120);
+INSERT INTO test VALUES(121);
+INSERT INTO test VALUES(122);
+INSERT INTO test VALUES(123);
+INSERT INTO test VALUES(124);
+INSERT INTO test VALUES(125);
+INSERT INTO test VALUES(126);
+INSERT INTO test VALUES(127);
+INSERT INTO test VALUES(128);
+INSERT INTO test VALUES(129);
+INSERT INTO test VALUES(130);
+INSERT INTO test VALUES(131);
+INSERT INTO test VALUES(132);
+INSERT INTO test VALUES(133);
+INSERT INTO test VALUES(134);
+INSERT INTO test VALUES(135);
+INSERT INTO test VALUES(136);
+INSERT INTO test VALUES(137);
+INSERT INTO test VALUES(138);
+INSERT INTO test VALUES(139);
+INSERT INTO test VALUES(140);
+INSERT INTO test VALUES(141);
+INSERT INTO test VALUES(142);
+INSERT INTO test VALUES(143);
+INSERT INTO test VALUES(144);
+INSERT INTO test VALUES(145);
+INSERT INTO test VALUES(146);
+INSERT INTO test VALUES(147);
+INSERT INTO test VALUES(148);
+INSERT INTO test VALUES(149);
+INSERT INTO test VALUES(150);
+INSERT INTO test VALUES(151);
+INSERT INTO test VALUES(152);
+INSERT INTO test VALUES(153);
+INSERT INTO test VALUES(154);
+INSERT INTO test VALUES(155);
+INSERT INTO test VALUES(156);
+INSERT INTO test VALUES(157);
+INSERT INTO test VALUES(158);
+INSERT INTO test VALUES(159);
+INSERT INTO test VALUES(160);
+INSERT INTO test VALUES(161);
+INSERT INTO test VALUES(162);
+INSERT INTO test VALUES(163);
+INSERT INTO test VALUES(164);
+INSERT INTO test VALUES(165);
+INSERT INTO test VALUES(166);
+INSERT INTO test VALUES(167);
+INSERT INTO test VALUES(168);
+INSERT INTO test VALUES(169);
+INSERT INTO test VALUES(170);
+INSERT INTO test VALUES(171);
+INSERT INTO test VALUES(172);
+INSERT INTO test VALUES(173);
+INSERT INTO test VALUES(174);
+INSERT INTO test VALUES(175);
+INSERT INTO test VALUES(176);
+INSERT INTO test VALUES(177);
+INSERT INTO test VALUES(178);
+INSERT INTO test VALUES(179);
+INSERT INTO test VALUES(180);
+INSERT INTO test VALUES(181);
+INSERT INTO test VALUES(182);
+INSERT INTO test VALUES(183);
+INSERT INTO test VALUES(184);
+INSERT INTO test VALUES(185);
+INSERT INTO test VALUES(186);
+INSERT INTO test VALUES(187);
+INSERT INTO test VALUES(188);
+INSERT INTO test VALUES(189);
+INSERT INTO test VALUES(190);
+INSERT INTO test VALUES(191);
+INSERT INTO test VALUES(192);
+INSERT INTO test VALUES(193);
+INSERT INTO test VALUES(194);
+INSERT INTO test VALUES(195);
+INSERT INTO test VALUES(196);
+INSERT INTO test VALUES(197);
+INSERT INTO test VALUES(198);
+INSERT INTO test VALUES(199);
+INSERT INTO test VALUES(200);
+INSERT INTO test VALUES(201);
+INSERT INTO test VALUES(202);
+INSERT INTO test VALUES(203);
+INSERT INTO test VALUES(204);
+INSERT INTO test VALUES(205);
+INSERT INTO test VALUES(206);
+INSERT INTO test VALUES(207);
+INSERT INTO test VALUES(208);
+INSERT INTO test VALUES(209);
+INSERT INTO test VALUES(210);
+INSERT INTO test VALUES(211);
+INSERT INTO test VALUES(212);
+INSERT INTO test VALUES(213);
+INSERT INTO test VALUES(214);
+INSERT INTO test VALUES(215);
+INSERT INTO test VALUES(216);
+INSERT INTO test VALUES(217);
+INSERT INTO test VALUES(218);
+INSERT INTO test VALUES(219);
+INSERT INTO test VALUES(220);
+INSERT INTO test VALUES(221);
+INSERT INTO test VALUES(222);
+INSERT INTO test VALUES(223);
+INSERT INTO test VALUES(224);
+INSERT INTO test VALUES(225);
+INSERT INTO test VALUES(226);
+INSERT INTO test VALUES(227);
+INSERT INTO test VALUES(228);
+INSERT INTO test VALUES(229);
+INSERT INTO test VALUES(230);
+INSERT INTO test VALUES(231);
+INSERT INTO test VALUES(232);
+INSERT INTO test VALUES(233);
+INSERT INTO test VALUES(234);
+INSERT INTO test VALUES(235);
+INSERT INTO test VALUES(236);
+INSERT INTO test VALUES(237);
+INSERT INTO test VALUES(238);
+INSERT INTO test VALUES(239);
+INSERT INTO test VALUES(240);
+INSERT INTO test VALUES(241);
+INSERT INTO test VALUES(242);
+INSERT INTO test VALUES(243);
+INSERT INTO test VALUES(244);
+INSERT INTO test VALUES(245);
+INSERT INTO test VALUES(246);
+INSERT INTO test VALUES(247);
+INSERT INTO test VALUES(248);
+INSERT INTO test VALUES(249);
+INSERT INTO test VALUES(250);
+INSERT INTO test VALUES(251);
+INSERT INTO test VALUES(252);
+INSERT INTO test VALUES(253);
+INSERT INTO test VALUES(254);
+INSERT INTO test VALUES(255);
+INSERT INTO test VALUES(256);
+INSERT INTO test VALUES(257);
+INSERT INTO test VALUES(258);
+INSERT INTO test VALUES(259);
+INSERT INTO test VALUES(260);
+INSERT INTO test VALUES(261);
+INSERT INTO test VALUES(262);
+INSERT INTO test VALUES(263);
+INSERT INTO test VALUES(264);
+INSERT INTO test VALUES(265);
+INSERT INTO test VALUES(266);
+INSERT INTO test VALUES(267);
+INSERT INTO test VALUES(268);
+INSERT INTO test VALUES(269);
+INSERT INTO test VALUES(270);
+INSERT INTO test VALUES(271);
+INSERT INTO test VALUES(272);
+INSERT INTO test VALUES(273);
+INSERT INTO test VALUES(274);
+INSERT INTO test VALUES(275);
+INSERT INTO test VALUES(276);
+INSERT INTO test VALUES(277);
+INSERT INTO test VALUES(278);
+INSERT INTO test VALUES(279);
+INSERT INTO test VALUES(280);
+INSERT INTO test VALUES(281);
+INSERT INTO test VALUES(282);
+INSERT INTO test VALUES(283);
+INSERT INTO test VALUES(284);
+INSERT INTO test VALUES(285);
+INSERT INTO test VALUES(286);
+INSERT INTO test VALUES(287);
+INSERT INTO test VALUES(288);
+INSERT INTO test VALUES(289);
+INSERT INTO test VALUES(290);
+INSERT INTO test VALUES(291);
+INSERT INTO test VALUES(292);
+INSERT INTO test VALUES(293);
+INSERT INTO test VALUES(294);
+INSERT INTO test VALUES(295);
+INSERT INTO test VALUES(296);
+INSERT INTO test VALUES(297);
+INSERT INTO test VALUES(298);
+INSERT INTO test VALUES(299);
+INSERT INTO test VALUES(300);
+INSERT INTO test VALUES(301);
+INSERT INTO test VALUES(302);
+INSERT INTO test VALUES(303);
+INSERT INTO test VALUES(304);
+INSERT INTO test VALUES(305);
+INSERT INTO test VALUES(306);
+INSERT INTO test VALUES(307);
+INSERT INTO test VALUES(308);
+INSERT INTO test VALUES(309);
+INSERT INTO test VALUES(310);
+INSERT INTO test VALUES(311);
+INSERT INTO test VALUES(312);
+INSERT INTO test VALUES(313);
+INSERT INTO test VALUES(314);
+INSERT INTO test VALUES(315);
+INSERT INTO test VALUES(316);
+INSERT INTO test VALUES(317);
+INSERT INTO test VALUES(318);
+INSERT INTO test VALUES(319);
+INSERT INTO test VALUES(320);
+INSERT INTO test VALUES(321);
+INSERT INTO test VALUES(322);
+INSERT INTO test VALUES(323);
+INSERT INTO test VALUES(324);
+INSERT INTO test VALUES(325);
+INSERT INTO test VALUES(326);
+INSERT INTO test VALUES(327);
+INSERT INTO test VALUES(328);
+INSERT INTO test VALUES(329);
+INSERT INTO test VALUES(330);
+INSERT INTO test VALUES(331);
+INSERT INTO test VALUES(332);
+INSERT INTO test VALUES(333);
+INSERT INTO test VALUES(334);
+INSERT INTO test VALUES(335);
+INSERT INTO test VALUES(336);
+INSERT INTO test VALUES(337);
+INSERT INTO test VALUES(338);
+INSERT INTO test VALUES(339);
+INSERT INTO test VALUES(340);
+INSERT INTO test VALUES(341);
+INSERT INTO test VALUES(342);
+INSERT INTO test VALUES(343);
+INSERT INTO test VALUES(344);
+INSERT INTO test VALUES(345);
+INSERT INTO test VALUES(346);
+INSERT INTO test VALUES(347);
+INSERT INTO test VALUES(348);
+INSERT INTO test VALUES(349);
+INSERT INTO test VALUES(350);
+INSERT INTO test VALUES(351);
+INSERT INTO test VALUES(352);
+INSERT INTO test VALUES(353);
+INSERT INTO test VALUES(354);
+INSERT INTO test VALUES(355);
+INSERT INTO test VALUES(356);
+INSERT INTO test VALUES(357);
+INSERT INTO test VALUES(358);
+INSERT INTO test VALUES(359);
+INSERT INTO test VALUES(360);
+INSERT INTO test VALUES(361);
+INSERT INTO test VALUES(362);
+INSERT INTO test VALUES(363);
+INSERT INTO test VALUES(364);
+INSERT INTO test VALUES(365);
+INSERT INTO test VALUES(366);
+INSERT INTO test VALUES(367);
+INSERT INTO test VALUES(368);
+INSERT INTO test VALUES(369);
+INSERT INTO test VALUES(370);
+INSERT INTO test VALUES(371);
+INSERT INTO test VALUES(372);
+INSERT INTO test VALUES(373);
+INSERT INTO test VALUES(374);
+INSERT INTO test VALUES(375);
+INSERT INTO test VALUES(376);
+INSERT INTO test VALUES(377);
+INSERT INTO test VALUES(378);
+INSERT INTO test VALUES(379);
+INSERT INTO test VALUES(380);
+INSERT INTO test VALUES(381);
+INSERT INTO test VALUES(382);
+INSERT INTO test VALUES(383);
+INSERT INTO test VALUES(384);
+INSERT INTO test VALUES(385);
+INSERT INTO test VALUES(386);
+INSERT INTO test VALUES(387);
+INSERT INTO test VALUES(388);
+INSERT INTO test VALUES(389);
+INSERT INTO test VALUES(390);
+INSERT INTO test VALUES(391);
+INSERT INTO test VALUES(392);
+INSERT INTO test VALUES(393);
+INSERT INTO test VALUES(394);
+INSERT INTO test VALUES(395);
+INSERT INTO test VALUES(396);
+INSERT INTO test VALUES(397);
+INSERT INTO test VALUES(398);
+INSERT INTO test VALUES(399);
+INSERT INTO test VALUES(400);
+INSERT INTO test VALUES(401);
+INSERT INTO test VALUES(402);
+INSERT INTO test VALUES(403);
+INSERT INTO test VALUES(404);
+INSERT INTO test VALUES(405);
+INSERT INTO test VALUES(406);
+INSERT INTO test VALUES(407);
+INSERT INTO test VALUES(408);
+INSERT INTO test VALUES(409);
+INSERT INTO test VALUES(410);
+INSERT INTO test VALUES(411);
+INSERT INTO test VALUES(412);
+INSERT INTO test VALUES(413);
+INSERT INTO test VALUES(414);
+INSERT INTO test VALUES(415);
+INSERT INTO test VALUES(416);
+INSERT INTO test VALUES(417);
+INSERT INTO test VALUES(418);
+INSERT INTO test VALUES(419);
+INSERT INTO test VALUES(420);
+INSERT INTO test VALUES(421);
+INSERT INTO test VALUES(422);
+INSERT INTO test VALUES(423);
+INSERT INTO test VALUES(424);
+INSERT INTO test VALUES(425);
+INSERT INTO test VALUES(426);
+INSERT INTO test VALUES(427);
+INSERT INTO test VALUES(428);
+INSERT INTO test VALUES(429);
+INSERT INTO test VALUES(430);
+INSERT INTO test VALUES(431);
+INSERT INTO test VALUES(432);
+INSERT INTO test VALUES(433);
+INSERT INTO test VALUES(434);
+INSERT INTO test VALUES(435);
+INSERT INTO test VALUES(436);
+INSERT INTO test VALUES(437);
+INSERT INTO test VALUES(438);
+INSERT INTO test VALUES(439);
+INSERT INTO test VALUES(440);
+INSERT INTO test VALUES(441);
+INSERT INTO test VALUES(442);
+INSERT INTO test VALUES(443);
+INSERT INTO test VALUES(444);
+INSERT INTO test VALUES(445);
+INSERT INTO test VALUES(446);
+INSERT INTO test VALUES(447);
+INSERT INTO test VALUES(448);
+INSERT INTO test VALUES(449);
+INSERT INTO test VALUES(450);
+INSERT INTO test VALUES(451);
+INSERT INTO test VALUES(452);
+INSERT INTO test VALUES(453);
+INSERT INTO test VALUES(454);
+INSERT INTO test VALUES(455);
+INSERT INTO test VALUES(456);
+INSERT INTO test VALUES(457);
+INSERT INTO test VALUES(458);
+INSERT INTO test VALUES(459);
+INSERT INTO test VALUES(460);
+INSERT INTO test VALUES(461);
+INSERT INTO test VALUES(462);
+INSERT INTO test VALUES(463);
+INSERT INTO test VALUES(464);
+INSERT INTO test VALUES(465);
+INSERT INTO test VALUES(466);
+INSERT INTO test VALUES(467);
+INSERT INTO test VALUES(468);
+INSERT INTO test VALUES(469);
+INSERT INTO test VALUES(470);
+INSERT INTO test VALUES(471);
+INSERT INTO test VALUES(472);
+INSERT INTO test VALUES(473);
+INSERT INTO test VALUES(474);
+INSERT INTO test VALUES(475);
+INSERT INTO test VALUES(476);
+INSERT INTO test VALUES(477);
+INSERT INTO test VALUES(478);
+INSERT INTO test VALUES(479);
+INSERT INTO test VALUES(480);
+INSERT INTO test VALUES(481);
+INSERT INTO test VALUES(482);
+INSERT INTO test VALUES(483);
+INSERT INTO test VALUES(484);
+INSERT INTO test VALUES(485);
+INSERT INTO test VALUES(486);
+INSERT INTO test VALUES(487);
+INSERT INTO test VALUES(488);
+INSERT INTO test VALUES(489);
+INSERT INTO test VALUES(490);
+INSERT INTO test VALUES(491);
+INSERT INTO test VALUES(492);
+INSERT INTO test VALUES(493);
+INSERT INTO test VALUES(494);
+INSERT INTO test VALUES(495);
+INSERT INTO test VALUES(496);
+INSERT INTO test VALUES(497);
+INSERT INTO test VALUES(498);
+INSERT INTO test VALUES(499);
+INSERT INTO test VALUES(500);
+INSERT INTO test VALUES(501);
+INSERT INTO test VALUES(502);
+INSERT INTO test VALUES(503);
+INSERT INTO test VALUES(504);
+INSERT INTO test VALUES(505);
+INSERT INTO test VALUES(506);
+INSERT INTO test VALUES(507);
+INSERT INTO test VALUES(508);
+INSERT INTO test VALUES(509);
+INSERT INTO test VALUES(510);
+INSERT INTO test VALUES(511);
+INSERT INTO test VALUES(512);
+INSERT INTO test VALUES(513);
+INSERT INTO test VALUES(514);
+INSERT INTO test VALUES(515);
+INSERT INTO test VALUES(516);
+INSERT INTO test VALUES(517);
+INSERT INTO test VALUES(518);
+INSERT INTO test VALUES(519);
+INSERT INTO test VALUES(520);
+INSERT INTO test VALUES(521);
+INSERT INTO test VALUES(522);
+INSERT INTO test VALUES(523);
+INSERT INTO test VALUES(524);
+INSERT INTO test VALUES(525);
+INSERT INTO test VALUES(526);
+INSERT INTO test VALUES(527);
+INSERT INTO test VALUES(528);
+INSERT INTO test VALUES(529);
+INSERT INTO test VALUES(530);
+INSERT INTO test VALUES(531);
+INSERT INTO test VALUES(532);
+INSERT INTO test VALUES(533);
+INSERT INTO test VALUES(534);
+INSERT INTO test VALUES(535);
+INSERT INTO test VALUES(536);
+INSERT INTO test VALUES(537);
+INSERT INTO test VALUES(538);
+INSERT INTO test VALUES(539);
+INSERT INTO test VALUES(540);
+INSERT INTO test VALUES(541);
+INSERT INTO test VALUES(542);
+INSERT INTO test VALUES(543);
+INSERT INTO test VALUES(544);
+INSERT INTO test VALUES(545);
+INSERT INTO test VALUES(546);
+INSERT INTO test VALUES(547);
+INSERT INTO test VALUES(548);
+INSERT INTO test VALUES(549);
+INSERT INTO test VALUES(550);
+INSERT INTO test VALUES(551);
+INSERT INTO test VALUES(552);
+INSERT INTO test VALUES(553);
+INSERT INTO test VALUES(554);
+INSERT INTO test VALUES(555);
+INSERT INTO test VALUES(556);
+INSERT INTO test VALUES(557);
+INSERT INTO test VALUES(558);
+INSERT INTO test VALUES(559);
+INSERT INTO test VALUES(560);
+INSERT INTO test VALUES(561);
+INSERT INTO test VALUES(562);
+INSERT INTO test VALUES(563);
+INSERT INTO test VALUES(564);
+INSERT INTO test VALUES(565);
+INSERT INTO test VALUES(566);
+INSERT INTO test VALUES(567);
+INSERT INTO test VALUES(568);
+INSERT INTO test VALUES(569);
+INSERT INTO test VALUES(570);
+INSERT INTO test VALUES(571);
+INSERT INTO test VALUES(572);
+INSERT INTO test VALUES(573);
+INSERT INTO test VALUES(574);
+INSERT INTO test VALUES(575);
+INSERT INTO test VALUES(576);
+INSERT INTO test VALUES(577);
+INSERT INTO test VALUES(578);
+INSERT INTO test VALUES(579);
+INSERT INTO test VALUES(580);
+INSERT INTO test VALUES(581);
+INSERT INTO test VALUES(582);
+INSERT INTO test VALUES(583);
+INSERT INTO test VALUES(584);
+INSERT INTO test VALUES(585);
+INSERT INTO test VALUES(586);
+INSERT INTO test VALUES(587);
+INSERT INTO test VALUES(588);
+INSERT INTO test VALUES(589);
+INSERT INTO test VALUES(590);
+INSERT INTO test VALUES(591);
+INSERT INTO test VALUES(592);
+INSERT INTO test VALUES(593);
+INSERT INTO test VALUES(594);
+INSERT INTO test VALUES(595);
+INSERT INTO test VALUES(596);
+INSERT INTO test VALUES(597);
+INSERT INTO test VALUES(598);
+INSERT INTO test VALUES(599);
+
+-- output:
+-- | COUNT(id) |
+-- |       600 |
+SELECT COUNT(id) FROM test;
+
+-- Free slots in first and second block, then fill them again
+DELETE FROM test WHERE id < 400;
+
+INSERT INTO test VALUES(600);
+INSERT INTO test VALUES(601);
+INSERT INTO test VALUES(602);
+INSERT INTO test VALUES(603);
+INSERT INTO test VALUES(604);
+INSERT INTO test VALUES(605);
+INSERT INTO test VALUES(606);
+INSERT INTO test VALUES(607);
+INSERT INTO test VALUES(608);
+INSERT INTO test VALUES(609);
+INSERT INTO test VALUES(610);
+INSERT INTO test VALUES(611);
+INSERT INTO test VALUES(612);
+INSERT INTO test VALUES(613);
+INSERT INTO test VALUES(614);
+INSERT INTO test VALUES(615);
+INSERT INTO test VALUES(616);
+INSERT INTO test VALUES(617);
+INSERT INTO test VALUES(618);
+INSERT INTO test VALUES(619);
+INSERT INTO test VALUES(620);
+INSERT INTO test VALUES(621);
+INSERT INTO test VALUES(622);
+INSERT INTO test VALUES(623);
+INSERT INTO test VALUES(624);
+INSERT INTO test VALUES(625);
+INSERT INTO test VALUES(626);
+INSERT INTO test VALUES(627);
+INSERT INTO test VALUES(628);
+INSERT INTO test VALUES(629);
+INSERT INTO test VALUES(630);
+INSERT INTO test VALUES(631);
+INSERT INTO test VALUES(632);
+INSERT INTO test VALUES(633);
+INSERT INTO test VALUES(634);
+INSERT INTO test VALUES(635);
+INSERT INTO test VALUES(636);
+INSERT INTO test VALUES(637);
+INSERT INTO test VALUES(638);
+INSERT INTO test VALUES(639);
+INSERT INTO test VALUES(640);
+INSERT INTO test VALUES(641);
+INSERT INTO test VALUES(642);
+INSERT INTO test VALUES(643);
+INSERT INTO test VALUES(644);
+INSERT INTO test VALUES(645);
+INSERT INTO test VALUES(646);
+INSERT INTO test VALUES(647);
+INSERT INTO test VALUES(648);
+INSERT INTO test VALUES(649);
+INSERT INTO test VALUES(650);
+INSERT INTO test VALUES(651);
+INSERT INTO test VALUES(652);
+INSERT INTO test VALUES(653);
+INSERT INTO test VALUES(654);
+INSERT INTO test VALUES(655);
+INSERT INTO test VALUES(656);
+INSERT INTO test VALUES(657);
+INSERT INTO test VALUES(658);
+INSERT INTO test VALUES(659);
+INSERT INTO test VALUES(660);
+INSERT INTO test VALUES(661);
+INSERT INTO test VALUES(662);
+INSERT INTO test VALUES(663);
+INSERT INTO test VALUES(664);
+INSERT INTO test VALUES(665);
+INSERT INTO test VALUES(666);
+INSERT INTO test VALUES(667);
+INSERT INTO test VALUES(668);
+INSERT INTO test VALUES(669);
+INSERT INTO test VALUES(670);
+INSERT INTO test VALUES(671);
+INSERT INTO test VALUES(672);
+INSERT INTO test VALUES(673);
+INSERT INTO test VALUES(674);
+INSERT INTO test VALUES(675);
+INSERT INTO test VALUES(676);
+INSERT INTO test VALUES(677);
+INSERT INTO test VALUES(678);
+INSERT INTO test VALUES(679);
+INSERT INTO test VALUES(680);
+INSERT INTO test VALUES(681);
+INSERT INTO test VALUES(682);
+INSERT INTO test VALUES(683);
+INSERT INTO test VALUES(684);
+INSERT INTO test VALUES(685);
+INSERT INTO test VALUES(686);
+INSERT INTO test VALUES(687);
+INSERT INTO test VALUES(688);
+INSERT INTO test VALUES(689);
+INSERT INTO test VALUES(690);
+INSERT INTO test VALUES(691);
+INSERT INTO test VALUES(692);
+INSERT INTO test VALUES(693);
+INSERT INTO test VALUES(694);
+INSERT INTO test VALUES(695);
+INSERT INTO test VALUES(696);
+INSERT INTO test VALUES(697);
+INSERT INTO test VALUES(698);
+INSERT INTO test VALUES(699);
+INSERT INTO test VALUES(700);
+INSERT INTO test VALUES(701);
+INSERT INTO test VALUES(702);
+INSERT INTO test VALUES(703);
+INSERT INTO test VALUES(704);
+INSERT INTO test VALUES(705);
+INSERT INTO test VALUES(706);
+INSERT INTO test VALUES(707);
+INSERT INTO test VALUES(708);
+INSERT INTO test VALUES(709);
+INSERT INTO test VALUES(710);
+INSERT INTO test VALUES(711);
+INSERT INTO test VALUES(712);
+INSERT INTO test VALUES(713);
+INSERT INTO test VALUES(714);
+INSERT INTO test VALUES(715);
+INSERT INTO test VALUES(716);
+INSERT INTO test VALUES(717);
+INSERT INTO test VALUES(718);
+INSERT INTO test VALUES(719);
+INSERT INTO test VALUES(720);
+INSERT INTO test VALUES(721);
+INSERT INTO test VALUES(722);
+INSERT INTO test VALUES(723);
+INSERT INTO test VALUES(724);
+INSERT INTO test VALUES(725);
+INSERT INTO test VALUES(726);
+INSERT INTO test VALUES(727);
+INSERT INTO test VALUES(728);
+INSERT INTO test VALUES(729);
+INSERT INTO test VALUES(730);
+INSERT INTO test VALUES(731);
+INSERT INTO test VALUES(732);
+INSERT INTO test VALUES(733);
+INSERT INTO test VALUES(734);
+INSERT INTO test VALUES(735);
+INSERT INTO test VALUES(736);
+INSERT INTO test VALUES(737);
+INSERT INTO test VALUES(738);
+INSERT INTO test VALUES(739);
+INSERT INTO test VALUES(740);
+INSERT INTO test VALUES(741);
+INSERT INTO test VALUES(742);
+INSERT INTO test VALUES(743);
+INSERT INTO test VALUES(744);
+INSERT INTO test VALUES(745);
+INSERT INTO test VALUES(746);
+INSERT INTO test VALUES(747);
+INSERT INTO test VALUES(748);
+INSERT INTO test VALUES(749);
+INSERT INTO test VALUES(750);
+INSERT INTO test VALUES(751);
+INSERT INTO test VALUES(752);
+INSERT INTO test VALUES(753);
+INSERT INTO test VALUES(754);
+INSERT INTO test VALUES(755);
+INSERT INTO test VALUES(756);
+INSERT INTO test VALUES(757);
+INSERT INTO test VALUES(758);
+INSERT INTO test VALUES(759);
+INSERT INTO test VALUES(760);
+INSERT INTO test VALUES(761);
+INSERT INTO test VALUES(762);
+INSERT INTO test VALUES(763);
+INSERT INTO test VALUES(764);
+INSERT INTO test VALUES(765);
+INSERT INTO test VALUES(766);
+INSERT INTO test VALUES(767);
+INSERT INTO test VALUES(768);
+INSERT INTO test VALUES(769);
+INSERT INTO test VALUES(770);
+INSERT INTO test VALUES(771);
+INSERT INTO test VALUES(772);
+INSERT INTO test VALUES(773);
+INSERT INTO test VALUES(774);
+INSERT INTO test VALUES(775);
+INSERT INTO test VALUES(776);
+INSERT INTO test VALUES(777);
+INSERT INTO test VALUES(778);
+INSERT INTO test VALUES(779);
+INSERT INTO test VALUES(780);
+INSERT INTO test VALUES(781);
+INSERT INTO test VALUES(782);
+INSERT INTO test VALUES(783);
+INSERT INTO test VALUES(784);
+INSERT INTO test VALUES(785);
+INSERT INTO test VALUES(786);
+INSERT INTO test VALUES(787);
+INSERT INTO test VALUES(788);
+INSERT INTO test VALUES(789);
+INSERT INTO test VALUES(790);
+INSERT INTO test VALUES(791);
+INSERT INTO test VALUES(792);
+INSERT INTO test VALUES(793);
+INSERT INTO test VALUES(794);
+INSERT INTO test VALUES(795);
+INSERT INTO test VALUES(796);
+INSERT INTO test VALUES(797);
+INSERT INTO test VALUES(798);
+INSERT INTO test VALUES(799);
+INSERT INTO test VALUES(800);
+INSERT INTO test VALUES(801);
+INSERT INTO test VALUES(802);
+INSERT INTO test VALUES(803);
+INSERT INTO test VALUES(804);
+INSERT INTO test VALUES(805);
+INSERT INTO test VALUES(806);
+INSERT INTO test VALUES(807);
+INSERT INTO test VALUES(808);
+INSERT INTO test VALUES(809);
+INSERT INTO test VALUES(810);
+INSERT INTO test VALUES(811);
+INSERT INTO test VALUES(812);
+INSERT INTO test VALUES(813);
+INSERT INTO test VALUES(814);
+INSERT INTO test VALUES(815);
+INSERT INTO test VALUES(816);
+INSERT INTO test VALUES(817);
+INSERT INTO test VALUES(818);
+INSERT INTO test VALUES(819);
+INSERT INTO test VALUES(820);
+INSERT INTO test VALUES(821);
+INSERT INTO test VALUES(822);
+INSERT INTO test VALUES(823);
+INSERT INTO test VALUES(824);
+INSERT INTO test VALUES(825);
+INSERT INTO test VALUES(826);
+INSERT INTO test VALUES(827);
+INSERT INTO test VALUES(828);
+INSERT INTO test VALUES(829);
+INSERT INTO test VALUES(830);
+INSERT INTO test VALUES(831);
+INSERT INTO test VALUES(832);
+INSERT INTO test VALUES(833);
+INSERT INTO test VALUES(834);
+INSERT INTO test VALUES(835);
+INSERT INTO test VALUES(836);
+INSERT INTO test VALUES(837);
+INSERT INTO test VALUES(838);
+INSERT INTO test VALUES(839);
+INSERT INTO test VALUES(840);
+INSERT INTO test VALUES(841);
+INSERT INTO test VALUES(842);
+INSERT INTO test VALUES(843);
+INSERT INTO test VALUES(844);
+INSERT INTO test VALUES(845);
+INSERT INTO test VALUES(846);
+INSERT INTO test VALUES(847);
+INSERT INTO test VALUES(848);
+INSERT INTO test VALUES(849);
+INSERT INTO test VALUES(850);
+INSERT INTO test VALUES(851);
+INSERT INTO test VALUES(852);
+INSERT INTO test VALUES(853);
+INSERT INTO test VALUES(854);
+INSERT INTO test VALUES(855);
+INSERT INTO test VALUES(856);
+INSERT INTO test VALUES(857);
+INSERT INTO test VALUES(858);
+INSERT INTO test VALUES(859);
+INSERT INTO test VALUES(860);
+INSERT INTO test VALUES(861);
+INSERT INTO test VALUES(862);
+INSERT INTO test VALUES(863);
+INSERT INTO test VALUES(864);
+INSERT INTO test VALUES(865);
+INSERT INTO test VALUES(866);
+INSERT INTO test VALUES(867);
+INSERT INTO test VALUES(868);
+INSERT INTO test VALUES(869);
+INSERT INTO test VALUES(870);
+INSERT INTO test VALUES(871);
+INSERT INTO test VALUES(872);
+INSERT INTO test VALUES(873);
+INSERT INTO test VALUES(874);
+INSERT INTO test VALUES(875);
+INSERT INTO test VALUES(876);
+INSERT INTO test VALUES(877);
+INSERT INTO test VALUES(878);
+INSERT INTO test VALUES(879);
+INSERT INTO test VALUES(880);
+INSERT INTO test VALUES(881);
+INSERT INTO test VALUES(882);
+INSERT INTO test VALUES(883);
+INSERT INTO test VALUES(884);
+INSERT INTO test VALUES(885);
+INSERT INTO test VALUES(886);
+INSERT INTO test VALUES(887);
+INSERT INTO test VALUES(888);
+INSERT INTO test VALUES(889);
+INSERT INTO test VALUES(890);
+INSERT INTO test VALUES(891);
+INSERT INTO test VALUES(892);
+INSERT INTO test VALUES(893);
+INSERT INTO test VALUES(894);
+INSERT INTO test VALUES(895);
+INSERT INTO test VALUES(896);
+INSERT INTO test VALUES(897);
+INSERT INTO test VALUES(898);
+INSERT INTO test VALUES(899);
+INSERT INTO test VALUES(900);
+INSERT INTO test VALUES(901);
+INSERT INTO test VALUES(902);
+INSERT INTO test VALUES(903);
+INSERT INTO test VALUES(904);
+INSERT INTO test VALUES(905);
+INSERT INTO test VALUES(906);
+INSERT INTO test VALUES(907);
+INSERT INTO test VALUES(908);
+INSERT INTO test VALUES(909);
+INSERT INTO test VALUES(910);
+INSERT INTO test VALUES(911);
+INSERT INTO test VALUES(912);
+INSERT INTO test VALUES(913);
+INSERT INTO test VALUES(914);
+INSERT INTO test VALUES(915);
+INSERT INTO test VALUES(916);
+INSERT INTO test VALUES(917);
+INSERT INTO test VALUES(918);
+INSERT INTO test VALUES(919);
+INSERT INTO test VALUES(920);
+INSERT INTO test VALUES(921);
+INSERT INTO test VALUES(922);
+INSERT INTO test VALUES(923);
+INSERT INTO test VALUES(924);
+INSERT INTO test VALUES(925);
+INSERT INTO test VALUES(926);
+INSERT INTO test VALUES(927);
+INSERT INTO test VALUES(928);
+INSERT INTO test VALUES(929);
+INSERT INTO test VALUES(930);
+INSERT INTO test VALUES(931);
+INSERT INTO test VALUES(932);
+INSERT INTO test VALUES(933);
+INSERT INTO test VALUES(934);
+INSERT INTO test VALUES(935);
+INSERT INTO test VALUES(936);
+INSERT INTO test VALUES(937);
+INSERT INTO test VALUES(938);
+INSERT INTO test VALUES(939);
+INSERT INTO test VALUES(940);
+INSERT INTO test VALUES(941);
+INSERT INTO test VALUES(942);
+INSERT INTO test VALUES(943);
+INSERT INTO test VALUES(944);
+INSERT INTO test VALUES(945);
+INSERT INTO test VALUES(946);
+INSERT INTO test VALUES(947);
+INSERT INTO test VALUES(948);
+INSERT INTO test VALUES(949);
+INSERT INTO test VALUES(950);
+INSERT INTO test VALUES(951);
+INSERT INTO test VALUES(952);
+INSERT INTO test VALUES(953);
+INSERT INTO test VALUES(954);
+INSERT INTO test VALUES(955);
+INSERT INTO test VALUES(956);
+INSERT INTO test VALUES(957);
+INSERT INTO test VALUES(958);
+INSERT INTO test VALUES(959);
+INSERT INTO test VALUES(960);
+INSERT INTO test VALUES(961);
+INSERT INTO test VALUES(962);
+INSERT INTO test VALUES(963);
+INSERT INTO test VALUES(964);
+INSERT INTO test VALUES(965);
+INSERT INTO test VALUES(966);
+INSERT INTO test VALUES(967);
+INSERT INTO test VALUES(968);
+INSERT INTO test VALUES(969);
+INSERT INTO test VALUES(970);
+INSERT INTO test VALUES(971);
+INSERT INTO test VALUES(972);
+INSERT INTO test VALUES(973);
+INSERT INTO test VALUES(974);
+INSERT INTO test VALUES(975);
+INSERT INTO test VALUES(976);
+INSERT INTO test VALUES(977);
+INSERT INTO test VALUES(978);
+INSERT INTO test VALUES(979);
+INSERT INTO test VALUES(980);
+INSERT INTO test VALUES(981);
+INSERT INTO test VALUES(982);
+INSERT INTO test VALUES(983);
+INSERT INTO test VALUES(984);
+INSERT INTO test VALUES(985);
+INSERT INTO test VALUES(986);
+INSERT INTO test VALUES(987);
+INSERT INTO test VALUES(988);
+INSERT INTO test VALUES(989);
+INSERT INTO test VALUES(990);
+INSERT INTO test VALUES(991);
+INSERT INTO test VALUES(992);
+INSERT INTO test VALUES(993);
+INSERT INTO test VALUES(994);
+INSERT INTO test VALUES(995);
+INSERT INTO test VALUES(996);
+INSERT INTO test VALUES(997);
+INSERT INTO test VALUES(998);
+INSERT INTO test VALUES(999);
+
+-- output:
+-- | COUNT(id) |
+-- |       600 |
+SELECT COUNT(id) FROM test;
+
+-- output:
+-- | COUNT(id) |
+-- |       400 |
+SELECT COUNT(id) FROM test WHERE id > 599;
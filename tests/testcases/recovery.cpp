@@ -0,0 +1,263 @@
+#include <tests/setup.hpp>
+
+#include <db/core/Database.hpp>
+#include <db/core/ResultSet.hpp>
+#include <db/core/Value.hpp>
+#include <csignal>
+#include <db/sql/SQL.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sys/resource.h>
+
+using namespace Db::Core;
+
+// A crash is simulated by copying the database directory while it is
+// still open: table files are then as of the last checkpoint, and
+// everything after it is only in the log.
+
+auto sql_to_db_error(Db::Sql::SQLError&& e) { return DbError { e.message() }; }
+auto os_to_db_error(Util::OsError const& e) { return DbError { fmt::format("Opening database failed: {}", e) }; }
+
+std::filesystem::path const DatabasePath = std::filesystem::current_path() / "recovery-test";
+std::filesystem::path const CrashedPath = std::filesystem::current_path() / "recovery-test-crashed";
+
+DbErrorOr<void> query(Database& db, std::string const& sql) {
+    TRY(Db::Sql::run_query(db, sql).map_error(sql_to_db_error));
+    return {};
+}
+
+DbErrorOr<std::string> row_ids(Database& db) {
+    auto result = TRY(Db::Sql::run_query(db, "SELECT id, name FROM test ORDER BY id;").map_error(sql_to_db_error)).as_result_set();
+    std::string ids;
+    for (auto const& row : result.rows()) {
+        ids += std::to_string(row.value(0).int_value()) + ":" + std::string { row.value(1).is_null() ? "null" : row.value(1).varchar_value() } + " ";
+    }
+    return ids;
+}
+
+void crash() {
+    std::filesystem::remove_all(CrashedPath);
+    std::filesystem::copy(DatabasePath, CrashedPath);
+}
+
+// Makes growing files past `size` fail, like a full disk would.
+class FileSizeLimit {
+public:
+    explicit FileSizeLimit(rlim_t size) {
+        ::signal(SIGXFSZ, SIG_IGN);
+        ::getrlimit(RLIMIT_FSIZE, &m_previous);
+        rlimit limit { .rlim_cur = size, .rlim_max = m_previous.rlim_max };
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+    }
+
+    ~FileSizeLimit() {
+        ::setrlimit(RLIMIT_FSIZE, &m_previous);
+    }
+
+private:
+    rlimit m_previous {};
+};
+
+std::filesystem::path last_segment(std::filesystem::path const& directory) {
+    std::filesystem::path last;
+    uint64_t last_sequence = 0;
+    for (auto const& entry : std::filesystem::directory_iterator { directory }) {
+        auto name = entry.path().filename().string();
+        if (name.starts_with("wal.") && name.ends_with(".log")) {
+            auto sequence = std::stoull(name.substr(4, name.size() - 8));
+            if (last.empty() || sequence > last_sequence) {
+                last = entry.path();
+                last_sequence = sequence;
+            }
+        }
+    }
+    return last;
+}
+
+DbErrorOr<Database> create_database() {
+    std::filesystem::remove_all(DatabasePath);
+    auto db = TRY(Database::create_or_open_file_backed(DatabasePath.string()).map_error(os_to_db_error));
+    TRY(query(db, "CREATE TABLE test (id INT PRIMARY KEY, name VARCHAR);"));
+    return db;
+}
+
+DbErrorOr<void> replay_committed_statements() {
+    {
+        auto db = TRY(create_database());
+        TRY(query(db, "INSERT INTO test (id, name) VALUES (1, 'one');"));
+        TRY(query(db, "INSERT INTO test (id, name) VALUES (2, 'two');"));
+        TRY(query(db, "INSERT INTO test (id, name) VALUES (3, 'three');"));
+        TRY(query(db, "DELETE FROM test WHERE id = 2;"));
+        TRY(query(db, "UPDATE test SET name = 'updated';"));
+        TRY(query(db, "INSERT INTO test (id, name) VALUES (4, 'four');"));
+
+        // Failed statements are committed too, they must not leave anything
+        // to replay.
+        TRY(expect(Db::Sql::run_query(db, "INSERT INTO test (id, name) VALUES (4, 'duplicate');").is_error(), "duplicate insert fails"));
+
+        // Once the table file can't grow, an insert fails inside the file,
+        // after the row was checked.
+        {
+            FileSizeLimit limit { std::filesystem::file_size(DatabasePath / "test.edb") };
+            bool failed = false;
+            for (int id = 100; id < 100000 && !failed; id++) {
+                failed = Db::Sql::run_query(db, "INSERT INTO test (id) VALUES (" + std::to_string(id) + ");").is_error();
+            }
+            TRY(expect(failed, "insert over file size limit fails"));
+        }
+        TRY(query(db, "DELETE FROM test WHERE id > 99;"));
+
+        // An update that can't allocate its data must keep the old data,
+        // so that it isn't reused by the next insert.
+        {
+            auto size = std::filesystem::file_size(DatabasePath / "test.edb");
+            FileSizeLimit limit { size };
+            auto name = std::string(size, 'x');
+            TRY(expect(Db::Sql::run_query(db, "UPDATE test SET name = '" + name + "';").is_error(), "update over file size limit fails"));
+        }
+        TRY(query(db, "INSERT INTO test (id, name) VALUES (5, 'five');"));
+
+        TRY(expect_equal(TRY(row_ids(db)), std::string { "1:updated 3:updated 4:four 5:five " }, "rows before crash"));
+        crash();
+    }
+
+    auto db = TRY(Database::create_or_open_file_backed(CrashedPath.string()).map_error(os_to_db_error));
+    TRY(expect_equal(TRY(row_ids(db)), std::string { "1:updated 3:updated 4:four 5:five " }, "rows after replay"));
+    TRY(expect_equal(TRY(db.table("test"))->size(), size_t { 4 }, "row count after replay"));
+
+    // Free list and index must be usable after replay.
+    TRY(query(db, "INSERT INTO test (id, name) VALUES (2, 'two');"));
+    TRY(expect(Db::Sql::run_query(db, "INSERT INTO test (id, name) VALUES (3, 'again');").is_error(), "index rejects duplicate after replay"));
+    TRY(expect_equal(TRY(row_ids(db)), std::string { "1:updated 2:two 3:updated 4:four 5:five " }, "rows after insert"));
+    return {};
+}
+
+DbErrorOr<void> torn_log_tail() {
+    {
+        auto db = TRY(create_database());
+        TRY(query(db, "INSERT INTO test (id, name) VALUES (1, 'one');"));
+        TRY(query(db, "INSERT INTO test (id, name) VALUES (2, 'two');"));
+        TRY(query(db, "INSERT INTO test (id, name) VALUES (3, 'three');"));
+        crash();
+    }
+
+    // Cut the commit record of the last statement in half.
+    auto segment = last_segment(CrashedPath);
+    TRY(expect(!segment.empty(), "log segment exists"));
+    std::filesystem::resize_file(segment, std::filesystem::file_size(segment) - 4);
+
+    {
+        auto db = TRY(Database::create_or_open_file_backed(CrashedPath.string()).map_error(os_to_db_error));
+        TRY(expect_equal(TRY(row_ids(db)), std::string { "1:one 2:two " }, "torn statement is dropped"));
+        TRY(query(db, "INSERT INTO test (id, name) VALUES (3, 'again');"));
+    }
+
+    // The torn tail was checkpointed away, it must not break later opens.
+    auto db = TRY(Database::create_or_open_file_backed(CrashedPath.string()).map_error(os_to_db_error));
+    TRY(expect_equal(TRY(row_ids(db)), std::string { "1:one 2:two 3:again " }, "rows after reopen"));
+    return {};
+}
+
+// See docs/EDBFileFormat.md, "Checkpoint".
+class CheckpointWriter {
+public:
+    template<std::integral T>
+    void write(T value) {
+        for (size_t s = 0; s < sizeof(T); s++) {
+            m_data.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (s * 8)));
+        }
+    }
+
+    void write_bytes(std::vector<uint8_t> const& data) { m_data.insert(m_data.end(), data.begin(), data.end()); }
+
+    void write_string(std::string const& string) {
+        write<uint32_t>(string.size());
+        m_data.insert(m_data.end(), string.begin(), string.end());
+    }
+
+    std::vector<uint8_t> finish() {
+        uint32_t hash = 2166136261u;
+        for (auto byte : m_data) {
+            hash = (hash ^ byte) * 16777619u;
+        }
+        write<uint32_t>(hash);
+        return std::move(m_data);
+    }
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+std::vector<uint8_t> read_file(std::filesystem::path const& path) {
+    std::ifstream file { path, std::ios::binary };
+    return { std::istreambuf_iterator<char> { file }, {} };
+}
+
+void write_file(std::filesystem::path const& path, std::vector<uint8_t> const& data) {
+    std::ofstream file { path, std::ios::binary | std::ios::trunc };
+    file.write(reinterpret_cast<char const*>(data.data()), data.size());
+}
+
+DbErrorOr<void> interrupted_checkpoint() {
+    {
+        auto db = TRY(create_database());
+        TRY(query(db, "INSERT INTO test (id, name) VALUES (1, 'one');"));
+        TRY(query(db, "INSERT INTO test (id, name) VALUES (2, 'two');"));
+        crash();
+    }
+    auto stale_table = read_file(CrashedPath / "test.edb");
+
+    // Let recovery write the up-to-date table file.
+    {
+        auto db = TRY(Database::create_or_open_file_backed(CrashedPath.string()).map_error(os_to_db_error));
+    }
+    auto checkpointed_table = read_file(CrashedPath / "test.edb");
+    TRY(expect(stale_table != checkpointed_table, "checkpoint changed the table file"));
+
+    // Crash after checkpoint.dwb was made durable and the log was dropped,
+    // but before the table file was written. The rows can only come from
+    // the image now.
+    write_file(CrashedPath / "test.edb", stale_table);
+    for (auto const& entry : std::filesystem::directory_iterator { CrashedPath }) {
+        if (entry.path().extension() == ".log") {
+            std::filesystem::remove(entry.path());
+        }
+    }
+    CheckpointWriter writer;
+    writer.write_bytes({ 'e', 's', 'd', 'b', 'c', 'k', 'p', 't' });
+    writer.write<uint64_t>(1000);
+    writer.write<uint32_t>(1);
+    writer.write_string("test.edb");
+    writer.write<uint64_t>(checkpointed_table.size());
+    writer.write<uint32_t>(1);
+    writer.write<uint64_t>(0);
+    writer.write<uint64_t>(checkpointed_table.size());
+    writer.write_bytes(checkpointed_table);
+    auto image = writer.finish();
+    write_file(CrashedPath / "checkpoint.dwb", image);
+
+    // Crash while the next image was still being written.
+    write_file(CrashedPath / "checkpoint.dwb.tmp", { 'e', 's', 'd' });
+
+    {
+        auto db = TRY(Database::create_or_open_file_backed(CrashedPath.string()).map_error(os_to_db_error));
+        TRY(expect_equal(TRY(row_ids(db)), std::string { "1:one 2:two " }, "rows restored from checkpoint image"));
+    }
+    TRY(expect(!std::filesystem::exists(CrashedPath / "checkpoint.dwb"), "checkpoint image is removed"));
+    TRY(expect(!std::filesystem::exists(CrashedPath / "checkpoint.dwb.tmp"), "partial checkpoint image is removed"));
+
+    // A torn image must be refused rather than applied.
+    write_file(CrashedPath / "checkpoint.dwb", { image.begin(), image.begin() + image.size() / 2 });
+    auto result = Database::create_or_open_file_backed(CrashedPath.string());
+    TRY(expect(result.is_error(), "torn checkpoint image is refused"));
+    return {};
+}
+
+std::map<std::string, TestFunc> get_tests() {
+    return {
+        { "replay_committed_statements", replay_committed_statements },
+        { "torn_log_tail", torn_log_tail },
+        { "interrupted_checkpoint", interrupted_checkpoint },
+    };
+}
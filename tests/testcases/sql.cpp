@@ -45,6 +45,7 @@ Db::Sql::SQLErrorOr<Db::Core::ValueOrResultSet> run_query(Db::Core::Database& db
         return error;
     }
     auto result = statement.release_value()->execute(db);
+    TRY(Db::Sql::commit(db));
     if (result.is_error()) {
         auto error = result.release_error();
         if (sql_statement.display)
@@ -95,7 +96,15 @@ bool display_error_if_error(Db::Sql::SQLErrorOr<Db::Core::ValueOrResultSet>&& qu
 }
 
 int main(int argc, char* argv[]) {
-    bool use_edb = argc == 2 && std::string_view { argv[1] } == "edb";
+    std::string_view mode = argc == 2 ? argv[1] : "memory";
+    bool use_edb = mode == "edb" || mode == "edb-buffer-pool";
+
+    // A small pool, so that tests exercise eviction too.
+    Db::Storage::EDB::PageAccess page_access;
+    if (mode == "edb-buffer-pool") {
+        page_access.mode = Db::Storage::EDB::PageAccess::Mode::BufferPool;
+        page_access.buffer_pool_size = 256 << 10;
+    }
     constexpr auto TestPath = "../tests/sql";
     const auto tests_dir = std::filesystem::absolute(TestPath).lexically_normal();
 
@@ -111,7 +120,7 @@ int main(int argc, char* argv[]) {
 
         auto test_name = file_it.path().lexically_relative(tests_dir);
 
-        auto run_test = [file_it, tests_dir, test_name, database_path, &use_edb]() -> Db::Core::DbErrorOr<void> {
+        auto run_test = [file_it, tests_dir, test_name, database_path, &use_edb, &page_access]() -> Db::Core::DbErrorOr<void> {
             const auto cwd = tests_dir / file_it.path().parent_path();
             // std::cout << "chdir " << cwd << std::endl;
             std::filesystem::current_path(cwd);
@@ -209,7 +218,7 @@ int main(int argc, char* argv[]) {
                 std::filesystem::remove_all(database_path);
             }
             Db::Core::Database db = use_edb
-                ? TRY(Db::Core::Database::create_or_open_file_backed(database_path.string()).map_error([](Util::OsError const& error) {
+                ? TRY(Db::Core::Database::create_or_open_file_backed(database_path.string(), page_access).map_error([](Util::OsError const& error) {
                       return Db::Core::DbError { fmt::format("Opening database failed: {}", error) };
                   }))
                 : Db::Core::Database::create_memory_backed();